@@ -19,7 +19,7 @@
  * Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA 02111-1307, USA
  */
 
-#include <netinet/in.h> /* needed for htonl */
+#define _GNU_SOURCE
 #include <sys/mman.h> 
 #include <unistd.h>
 #include <fcntl.h>
@@ -30,195 +30,232 @@
 #include "backend.h"
 #include "back_linux.h"
 #include "info.h"
-
-#define PCI_GET_BUS(devbusfn) ((devbusfn >> 8) & 0xff)
-#define PCI_GET_DEVICE(devbusfn) ((devbusfn & 0xff) >> 3)
-#define PCI_GET_FUNCTION(devbusfn) (devbusfn & 0x7)
+#include "pci.h"
 
 /* Check if we are using the closed source Nvidia drivers */
-int check_driver()
+int check_driver(const char *sysfs_root)
 {
-  FILE *proc;
-  char buffer[80];
-
-  proc = fopen("/proc/modules", "r");
-
-  /* Don't crash when there's no /proc/modules */
-  if(proc == NULL)
-    return 0;
-
-  while(fgets(buffer, 80, proc) != NULL)
+  static const char *modules[] = { "NVdriver", "nvidia" };
+  char path[512];
+  FILE *fp;
+  int i, used;
+
+  /* Check to see if NVdriver/nvidia is loaded and if it is used.
+  /  For various versions the driver isn't initialized when X hasn't
+  /  been started and it can crash then.
+  */
+  for(i = 0; i < 2; i++)
   {
-    char name[80];
-    int size;
-    int used;
+    snprintf(path, sizeof(path), "%s/module/%s/refcnt", sysfs_root, modules[i]);
 
-    /* Check to see if NVdriver/nvidia is loaded and if it is used.
-    /  For various versions the driver isn't initialized when X hasn't
-    /  been started and it can crash then.
-    */
-    if(sscanf(buffer,"%s %d %d",name, &size, &used) != 3) continue;
+    /* Don't crash when the module isn't there */
+    if(!(fp = fopen(path, "r")))
+      continue;
 
-    if(strcmp(name, "NVdriver") == 0)
-    {
-      fclose(proc);
-      if(used)
-        return 1;
+    if(fscanf(fp, "%d", &used) != 1)
+      used = 0;
+    fclose(fp);
 
-      return 0;
-    }
-
-    if(strcmp(name, "nvidia") == 0)
-    {
-      fclose(proc);
-      if(used)
-        return 2;
-
-      return 0;
-    }
+    return used ? i + 1 : 0;
   }
-  fclose(proc);
 
   return 0;
 }
 
-unsigned int probe_devices(NVCard *nvcard_list)
+/* Find all Nvidia video cards below sysfs_root (normally /sys); the list is allocated in *list and has to be released with free_devices */
+unsigned int probe_devices(NVCard **list, const char *sysfs_root)
 {
-  int dev, irq, reg_addr, i=0;
-  unsigned short devbusfn;
-  char buf[256];
-  FILE *proc;
+  struct pci_device *devs;
+  int num_devs, driver, d, i = 0, max_cards = 0;
+  NVCard *nvcard_list = NULL, *grown;
+
+  *list = NULL;
 
-  proc = fopen("/proc/bus/pci/devices", "r");
-  if(!proc)
+  if((num_devs = pci_scan(sysfs_root, &devs)) < 0)
   {
-    printf("Can't open /proc/bus/pci/devices to detect your videocard.");
+    printf("Can't read %s/bus/pci/devices to detect your videocard.", sysfs_root);
     return 0;
   }
 
-  while(fgets(buf, sizeof(buf)-1, proc))
+  driver = check_driver(sysfs_root);
+
+  for(d = 0; d < num_devs; d++)
   {
-    if(sscanf(buf,"%hx %x %x %x",&devbusfn, &dev, &irq, &reg_addr) != 4) continue;
+    struct pci_device *dev = devs + d;
 
-    /* Check if the card contains an Nvidia chipset */
-    if((dev>>16) == 0x10de)
-    {
-      /*
-      When we enter this block of code we know that the device contains some
-      chip designed by Nvidia. In the past Nvidia only produced videochips but
-      now they also make various other devices. Because of this we need to find
-      out if the device is a videocard or not. There are two ways to do this. We can
-      create a list of all Nvidia videochips or we can check the pci header of the device.
-      We will read the pci header from /proc/bus/pci/(bus)/(function).(device). When
-      the card is in our card database we report the name of the card and else we say
-      it is an unknown card.
-      */
-
-      if(!IsVideoCard(devbusfn))
-        continue;
-
-      if(i == MAX_CARDS)
-      {
-        fprintf(stderr, "Error: stopped probing for video cards after discovering %d video cards\n", MAX_CARDS);
-        return i;
-      }
+    /*
+    Nvidia doesn't only produce videochips anymore, so besides the vendor
+    we check the class in the pci header of the device. When the card is in
+    our card database we report the name of the card and else we say
+    it is an unknown card.
+    */
+    if(pci_config_word(dev, PCI_VENDOR_ID) != PCI_VENDOR_NVIDIA || dev->config[PCI_CLASS_BASE] != PCI_CLASS_DISPLAY)
+      continue;
 
-      nvcard_list[i].device_id = 0x0000ffff & dev;
-      nvcard_list[i].arch = get_gpu_arch(nvcard_list[i].device_id);
-      get_card_name(nvcard_list[i].device_id, nvcard_list[i].adapter_name);
-
-      /*
-      Thanks to all different driver version this is needed now.
-      When nv_driver > 1 the nvidia kernel module is loaded. 
-      For driver versions < 1.0-40xx the register offset could be set to 0.
-      Thanks to a rewritten kernel module in 1.0-40xx the register offset needs
-      to be set again to the real offset.
-      */
-      switch(check_driver())
+    if(i == max_cards)
+    {
+      max_cards = max_cards ? max_cards * 2 : 4;
+      if(!(grown = realloc(nvcard_list, max_cards * sizeof(NVCard))))
       {
-        case 0:
-          nvcard_list[i].dev_name = strdup("/dev/mem");
-          nvcard_list[i].reg_address = reg_addr;
-          break;
-        case 1:
-          nvcard_list[i].dev_name = (char *)calloc(13, sizeof(char));
-          sprintf(nvcard_list[i].dev_name, "/dev/nvidia%d", i);
-          nvcard_list[i].reg_address = 0;
-          break;
-        case 2:
-          nvcard_list[i].dev_name = (char *)calloc(13, sizeof(char));
-          sprintf(nvcard_list[i].dev_name, "/dev/nvidia%d", i);
-          nvcard_list[i].reg_address = reg_addr;
-          break;
+        fprintf(stderr, "Error: stopped probing for video cards after discovering %d video cards\n", i);
+        break;
       }
+      nvcard_list = grown;
+    }
 
-      i++;
+    memset(nvcard_list + i, 0, sizeof(NVCard));
+    nvcard_list[i].backend = &linux_backend;
+    nvcard_list[i].domain = dev->domain;
+    nvcard_list[i].bus = dev->bus;
+    nvcard_list[i].device = dev->device;
+    nvcard_list[i].function = dev->function;
+    if(asprintf(&nvcard_list[i].sysfs_path, "%s/bus/pci/devices/%s", sysfs_root, dev->name) == -1)
+      nvcard_list[i].sysfs_path = NULL;
+    nvcard_list[i].device_id = pci_config_word(dev, PCI_DEVICE_ID);
+    nvcard_list[i].subvendor_id = pci_config_word(dev, PCI_SUBSYSTEM_VENDOR_ID);
+    nvcard_list[i].subsystem_id = pci_config_word(dev, PCI_SUBSYSTEM_ID);
+    nvcard_list[i].arch = get_gpu_arch(nvcard_list[i].device_id);
+    nvcard_list[i].adapter_name = get_card_name(nvcard_list[i].device_id);
+
+    /*
+    Thanks to all different driver version this is needed now.
+    When nv_driver > 1 the nvidia kernel module is loaded. 
+    For driver versions < 1.0-40xx the register offset could be set to 0.
+    Thanks to a rewritten kernel module in 1.0-40xx the register offset needs
+    to be set again to the real offset.
+    */
+    switch(driver)
+    {
+      case 0:
+        nvcard_list[i].dev_name = strdup("/dev/mem");
+        nvcard_list[i].reg_address = pci_resource_start(sysfs_root, dev, 0);
+        break;
+      case 1:
+        nvcard_list[i].dev_name = (char *)calloc(22, sizeof(char));
+        sprintf(nvcard_list[i].dev_name, "/dev/nvidia%d", i);
+        nvcard_list[i].reg_address = 0;
+        break;
+      case 2:
+        nvcard_list[i].dev_name = (char *)calloc(22, sizeof(char));
+        sprintf(nvcard_list[i].dev_name, "/dev/nvidia%d", i);
+        nvcard_list[i].reg_address = pci_resource_start(sysfs_root, dev, 0);
+        break;
     }
+
+    i++;
   }
-  fclose(proc);
+  free(devs);
 
+  *list = nvcard_list;
   return i;
 }
 
-/* Check if the device is a videocard */
-int IsVideoCard(unsigned short devbusfn)
+void free_devices(NVCard *nvcard_list, unsigned int num_cards)
 {
-  int32_t pci_class = pciReadLong(devbusfn, 0x9);
-  /* When the id isn't 0x03 the card isn't a vga card return 0 */
-  return (((htonl(pci_class) >> 8) & 0xf) == 0x03);
-}
+  unsigned int i;
 
-int32_t pciReadLong(unsigned short devbusfn, long offset)
-{
-  char file[25];
-  FILE *device;
-  short bus = PCI_GET_BUS(devbusfn);
-  short dev = PCI_GET_DEVICE(devbusfn);
-  short function = PCI_GET_FUNCTION(devbusfn);
-
-  snprintf(file, sizeof(file), "/proc/bus/pci/%02x/%02x.%x", bus, dev, function);
-  if((device = fopen(file, "r")) != NULL)
+  for(i = 0; i < num_cards; i++)
   {
-    int32_t buffer;
-    fseek(device, offset, SEEK_SET);
-    fread(&buffer, sizeof(int32_t), 1, device);
-    fclose(device);
-
-    return buffer;
+    free(nvcard_list[i].dev_name);
+    free(nvcard_list[i].sysfs_path);
   }
-
-  return -1;
+  free(nvcard_list);
 }
 
-int map_mem(const char *dev_name)
+/* Map the registers of the card; every card has its own mappings so multiple cards can be used at the same time */
+int map_mem(NVCard *nv_card)
 {
   int fd;
 
-  if( (fd = open(dev_name, O_RDWR)) == -1 )
+  if( (fd = open(nv_card->dev_name, O_RDWR)) == -1 )
   {
-    printf("Can't open %s", dev_name);
+    fprintf(stderr, "Can't open %s\n", nv_card->dev_name);
     return 0;
   }
 
   /* Map the registers of the nVidia chip */
-  /* normally pmc is till 0x2000 but extended it for nv40 */
-  nv_card->PMC     = (unsigned int *)map_dev_mem(fd, nv_card->reg_address + 0x000000, 0x2ffff);
+  nv_card->PMC     = (unsigned int *)map_dev_mem(fd, nv_card->reg_address + 0x000000, NV_PMC_SIZE);
   nv_card->PDISPLAY = (unsigned int *)map_dev_mem(fd, nv_card->reg_address + NV_PDISPLAY_OFFSET, NV_PDISPLAY_SIZE);
   nv_card->PRAMIN  = (unsigned int *)map_dev_mem(fd, nv_card->reg_address + NV_PRAMIN_OFFSET, NV_PRAMIN_SIZE);
   nv_card->PROM    = (unsigned char *)map_dev_mem(fd, nv_card->reg_address + NV_PROM_OFFSET, NV_PROM_SIZE);
 
   close(fd);
+
+  nv_card->mapped = 1;
+  if(!nv_card->PMC || !nv_card->PDISPLAY || !nv_card->PRAMIN || !nv_card->PROM)
+  {
+    fprintf(stderr, "Can't map the registers of the card from %s\n", nv_card->dev_name);
+    unmap_mem(nv_card);
+    return 0;
+  }
+
   return 1;
 }
 
-void unmap_mem()
+void unmap_mem(NVCard *nv_card)
+{
+  if(nv_card->PMC)
+    unmap_dev_mem((unsigned long)nv_card->PMC, NV_PMC_SIZE);
+  if(nv_card->PDISPLAY)
+    unmap_dev_mem((unsigned long)nv_card->PDISPLAY, NV_PDISPLAY_SIZE);
+  if(nv_card->PRAMIN)
+    unmap_dev_mem((unsigned long)nv_card->PRAMIN, NV_PRAMIN_SIZE);
+  if(nv_card->PROM)
+    unmap_dev_mem((unsigned long)nv_card->PROM, NV_PROM_SIZE);
+
+  nv_card->PMC = nv_card->PDISPLAY = nv_card->PRAMIN = NULL;
+  nv_card->PROM = NULL;
+  nv_card->mapped = 0;
+}
+
+/* -------- register access through the mappings -------- */
+
+static volatile void *linux_aperture(NVCard *nv_card, int aperture)
+{
+  switch(aperture)
+  {
+    case NV_APERTURE_PMC:
+      return nv_card->PMC;
+    case NV_APERTURE_PDISPLAY:
+      return nv_card->PDISPLAY;
+    case NV_APERTURE_PRAMIN:
+      return nv_card->PRAMIN;
+    default:
+      return nv_card->PROM;
+  }
+}
+
+static unsigned char linux_read8(NVCard *nv_card, int aperture, unsigned int offset)
 {
-  unmap_dev_mem((unsigned long)nv_card->PMC, 0xffff);
-  unmap_dev_mem((unsigned long)nv_card->PDISPLAY, NV_PDISPLAY_SIZE);
-  unmap_dev_mem((unsigned long)nv_card->PRAMIN, NV_PRAMIN_SIZE);
-  unmap_dev_mem((unsigned long)nv_card->PROM, NV_PROM_SIZE);
+  return ((volatile unsigned char *)linux_aperture(nv_card, aperture))[offset];
 }
 
+static uint32_t linux_read32(NVCard *nv_card, int aperture, unsigned int offset)
+{
+  return ((volatile uint32_t *)linux_aperture(nv_card, aperture))[offset/4];
+}
+
+static void linux_write32(NVCard *nv_card, int aperture, unsigned int offset, uint32_t value)
+{
+  ((volatile uint32_t *)linux_aperture(nv_card, aperture))[offset/4] = value;
+}
+
+static void linux_copy(NVCard *nv_card, int aperture, unsigned int offset, void *dst, unsigned int len)
+{
+  memcpy(dst, (const unsigned char *)linux_aperture(nv_card, aperture) + offset, len);
+}
+
+const struct nv_backend linux_backend =
+{
+  "linux",
+  map_mem,
+  unmap_mem,
+  linux_read8,
+  linux_read32,
+  linux_write32,
+  linux_copy
+};
+
 /* -------- mmap on devices -------- */
 /* This piece of code is from nvtv a linux program for tvout */
 /* The author of nvtv got this from xfree86's os-support/linux/lnx_video.c */
@@ -234,6 +271,8 @@ void *map_dev_mem (int fd, unsigned long Base, unsigned long Size)
 
   base = mmap((caddr_t)0, Size + alignOff, PROT_READ|PROT_WRITE,
   mapflags, fd, (off_t)realBase);
+  if(base == MAP_FAILED)
+    return NULL;
   return (void *) ((char *)base + alignOff);
 }
 
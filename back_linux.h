@@ -16,11 +16,12 @@
  * Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA 02111-1307, USA
  */
 
-int check_driver(void);
-unsigned int probe_devices(NVCard *);
-int IsVideoCard(unsigned short);
-int32_t pciReadLong(unsigned short, long);
-int map_mem(const char *);
-void unmap_mem(void);
+int check_driver(const char *);
+unsigned int probe_devices(NVCard **, const char *);
+void free_devices(NVCard *, unsigned int);
+int map_mem(NVCard *);
+void unmap_mem(NVCard *);
 void *map_dev_mem(int, unsigned long, unsigned long);
 void unmap_dev_mem(unsigned long, unsigned long);
+
+extern const struct nv_backend linux_backend;
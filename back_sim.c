@@ -0,0 +1,240 @@
+/*
+ * Copyright(C) 2010 Andrew Powell
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA 02111-1307, USA
+ */
+
+// A simulated card for testing and benchmarking without hardware.
+// The four apertures are served from the files pmc, pdisplay, pramin and prom in a directory; missing files read as zeros.
+// Every read can be slowed down by a fixed latency and PROM reads can return bytes with a flipped bit to exercise the debouncer.
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#include "backend.h"
+#include "back_sim.h"
+#include "info.h"
+
+struct sim_card
+{
+  char *dir;
+  unsigned int latency;     // ns per read
+  uint64_t flip_threshold;  // a PROM read flips a bit when the next random number is below this
+  uint64_t seed;
+  unsigned char *mem[NV_APERTURES];
+};
+
+static const unsigned int sim_size[NV_APERTURES] = { NV_PMC_SIZE, NV_PDISPLAY_SIZE, NV_PRAMIN_SIZE, NV_PROM_SIZE };
+static const char *sim_file[NV_APERTURES] = { "pmc", "pdisplay", "pramin", "prom" };
+
+static void sim_delay(struct sim_card *sim)
+{
+  struct timespec ts;
+  long long end;
+
+  if(!sim->latency)
+    return;
+
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  end = ts.tv_sec * 1000000000LL + ts.tv_nsec + sim->latency;
+  do
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+  while(ts.tv_sec * 1000000000LL + ts.tv_nsec < end);
+}
+
+// xorshift64*
+static uint64_t sim_random(struct sim_card *sim)
+{
+  sim->seed ^= sim->seed >> 12;
+  sim->seed ^= sim->seed << 25;
+  sim->seed ^= sim->seed >> 27;
+  return sim->seed * 0x2545F4914F6CDD1DULL;
+}
+
+static int sim_map_mem(NVCard *nv_card)
+{
+  struct sim_card *sim = nv_card->priv;
+  char *filename;
+  FILE *fp;
+  int i;
+
+  for(i = 0; i < NV_APERTURES; i++)
+  {
+    if(sim->mem[i])
+      continue;
+
+    if(!(sim->mem[i] = calloc(sim_size[i], 1)))
+      return 0;
+
+    if(!(filename = malloc(strlen(sim->dir) + strlen(sim_file[i]) + 2)))
+      return 0;
+    sprintf(filename, "%s/%s", sim->dir, sim_file[i]);
+
+    if((fp = fopen(filename, "rb")))
+    {
+      if(!fread(sim->mem[i], 1, sim_size[i], fp) && ferror(fp))
+        fprintf(stderr, "Warning: Unable to read %s\n", filename);
+      fclose(fp);
+    }
+    free(filename);
+  }
+
+  nv_card->mapped = 1;
+  return 1;
+}
+
+static void sim_unmap_mem(NVCard *nv_card)
+{
+  struct sim_card *sim = nv_card->priv;
+  int i;
+
+  for(i = 0; i < NV_APERTURES; i++)
+  {
+    free(sim->mem[i]);
+    sim->mem[i] = NULL;
+  }
+  nv_card->mapped = 0;
+}
+
+// One byte of an aperture including the PROM noise, without the latency
+static unsigned char sim_byte(struct sim_card *sim, int aperture, unsigned int offset)
+{
+  unsigned char value;
+
+  if(!sim->mem[aperture] || offset >= sim_size[aperture])
+    return 0xff;
+
+  value = sim->mem[aperture][offset];
+
+  if(aperture == NV_APERTURE_PROM && sim->flip_threshold)
+  {
+    uint64_t r = sim_random(sim);
+    if((r >> 11) < sim->flip_threshold)
+      value ^= 1 << (r & 7);
+  }
+
+  return value;
+}
+
+static unsigned char sim_read8(NVCard *nv_card, int aperture, unsigned int offset)
+{
+  struct sim_card *sim = nv_card->priv;
+
+  sim_delay(sim);
+  return sim_byte(sim, aperture, offset);
+}
+
+static uint32_t sim_read32(NVCard *nv_card, int aperture, unsigned int offset)
+{
+  struct sim_card *sim = nv_card->priv;
+
+  offset &= ~3;
+  sim_delay(sim);
+  return sim_byte(sim, aperture, offset) | sim_byte(sim, aperture, offset + 1) << 8 |
+         sim_byte(sim, aperture, offset + 2) << 16 | (uint32_t)sim_byte(sim, aperture, offset + 3) << 24;
+}
+
+static void sim_write32(NVCard *nv_card, int aperture, unsigned int offset, uint32_t value)
+{
+  struct sim_card *sim = nv_card->priv;
+  unsigned char *p;
+
+  // The rom is read-only
+  if(aperture == NV_APERTURE_PROM || !sim->mem[aperture] || offset + 4 > sim_size[aperture])
+    return;
+
+  p = sim->mem[aperture] + (offset & ~3);
+  p[0] = value;
+  p[1] = value >> 8;
+  p[2] = value >> 16;
+  p[3] = value >> 24;
+}
+
+static void sim_copy(NVCard *nv_card, int aperture, unsigned int offset, void *dst, unsigned int len)
+{
+  unsigned char *out = dst;
+  unsigned int i;
+
+  for(i = 0; i < len; i++)
+    out[i] = sim_read8(nv_card, aperture, offset + i);
+}
+
+const struct nv_backend sim_backend =
+{
+  "sim",
+  sim_map_mem,
+  sim_unmap_mem,
+  sim_read8,
+  sim_read32,
+  sim_write32,
+  sim_copy
+};
+
+/* Set up a simulated card serving the files in dir.  latency is the time every read takes in ns and
+/  flip_rate the probability that a PROM read returns the byte with one bit flipped.
+/  The card is returned mapped; the device id is taken from the PCIR structure of the simulated rom.
+*/
+int sim_open_card(NVCard *nv_card, const char *dir, unsigned int latency, double flip_rate)
+{
+  struct sim_card *sim;
+  unsigned int pcir;
+
+  memset(nv_card, 0, sizeof(NVCard));
+
+  if(!(sim = calloc(1, sizeof(struct sim_card))) || !(sim->dir = strdup(dir)))
+  {
+    free(sim);
+    return 0;
+  }
+
+  sim->latency = latency;
+  sim->flip_threshold = flip_rate > 0 ? (uint64_t)(flip_rate * (double)(1ULL << 53)) : 0;
+  sim->seed = 0x9E3779B97F4A7C15ULL;
+
+  nv_card->backend = &sim_backend;
+  nv_card->priv = sim;
+  nv_card->dev_name = sim->dir;
+
+  if(!sim_map_mem(nv_card))
+  {
+    sim_close_card(nv_card);
+    return 0;
+  }
+
+  pcir = sim->mem[NV_APERTURE_PROM][0x18] | sim->mem[NV_APERTURE_PROM][0x19] << 8;
+  if(pcir + 8 <= NV_PROM_SIZE && !memcmp(sim->mem[NV_APERTURE_PROM] + pcir, "PCIR", 4))
+    nv_card->device_id = sim->mem[NV_APERTURE_PROM][pcir+6] | sim->mem[NV_APERTURE_PROM][pcir+7] << 8;
+
+  nv_card->arch = get_gpu_arch(nv_card->device_id);
+  nv_card->adapter_name = get_card_name(nv_card->device_id);
+
+  return 1;
+}
+
+void sim_close_card(NVCard *nv_card)
+{
+  struct sim_card *sim = nv_card->priv;
+
+  if(!sim)
+    return;
+
+  sim_unmap_mem(nv_card);
+  free(sim->dir);
+  free(sim);
+  nv_card->priv = NULL;
+  nv_card->dev_name = NULL;
+}
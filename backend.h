@@ -24,15 +24,23 @@
 
 #include <stdint.h>
 
-/* PCI stuff */
-#if 0
-#define PCI_DEVICE_ID 0x2 /* 16-bit */
-#define PCI_SUBSYSTEM_VENDOR_ID 0x2c /* 16-bit */
-#define PCI_SUBSYSTEM_ID 0x2e /* 16-bit */
-#endif
+/* PCI stuff; offsets in the config space */
+enum
+{
+  PCI_VENDOR_ID = 0x0, /* 16-bit */
+  PCI_DEVICE_ID = 0x2, /* 16-bit */
+  PCI_CLASS_BASE = 0xb, /* 8-bit */
+  PCI_BASE_ADDRESS_0 = 0x10, /* 32-bit */
+  PCI_SUBSYSTEM_VENDOR_ID = 0x2c, /* 16-bit */
+  PCI_SUBSYSTEM_ID = 0x2e, /* 16-bit */
+  PCI_CONFIG_HEADER_SIZE = 0x40, /* the part of the config space which is readable without root */
+  PCI_CLASS_DISPLAY = 0x03,
+  PCI_VENDOR_NVIDIA = 0x10de
+};
 
 enum
 {
+  NV_PMC_SIZE = 0x30000, /* normally pmc is till 0x2000 but extended it for nv40 */
   NV_PMC_BOOT_0 = 0x0,
   NV_PMC_BOOT_0_REVISION_MINOR = 0xf,
   NV_PMC_BOOT_0_REVISION_MAJOR =  0xf0, /* in general A or B, on pre-NV10 it was different */
@@ -87,12 +95,46 @@ enum
   UNKNOWN = (1 << 30)
 };
 
-typedef struct {
-  unsigned int reg_address;
+/* The register ranges of a card; offsets within an aperture are in bytes */
+enum
+{
+  NV_APERTURE_PMC,
+  NV_APERTURE_PDISPLAY,
+  NV_APERTURE_PRAMIN,
+  NV_APERTURE_PROM,
+  NV_APERTURES
+};
+
+struct nv_card;
+
+/* All access to a card goes through its backend so the same code can run on real hardware (back_linux.c) or on a simulated card (back_sim.c) */
+struct nv_backend
+{
+  const char *name;
+  int (*map_mem)(struct nv_card *);
+  void (*unmap_mem)(struct nv_card *);
+  unsigned char (*read8)(struct nv_card *, int, unsigned int);
+  uint32_t (*read32)(struct nv_card *, int, unsigned int);
+  void (*write32)(struct nv_card *, int, unsigned int, uint32_t);
+  void (*copy)(struct nv_card *, int, unsigned int, void *, unsigned int); // bulk read
+};
+
+typedef struct nv_card {
+  unsigned long reg_address;
   char *dev_name; // /dev/mem or /dev/nvidiaX
   uint32_t arch; // Architecture NV10, NV15, NV20 ..; for internal use only as we don't list all architectures
   unsigned short device_id;
-  char adapter_name[64];
+  const char *adapter_name;
+  unsigned short domain;
+  unsigned char bus, device, function; // PCI location
+  unsigned short subvendor_id;
+  unsigned short subsystem_id;
+  char *sysfs_path; // directory of the device in sysfs, NULL if there is none
+
+  char mapped; // the registers are accessible
+
+  const struct nv_backend *backend;
+  void *priv; // backend specific state
 
   volatile unsigned int *PDISPLAY; // NV50 display registers
   volatile unsigned int *PMC;
@@ -100,6 +142,10 @@ typedef struct {
   volatile unsigned char *PROM; // Nvidia bios
 } NVCard;
 
-enum { MAX_CARDS = 0x4 };
+#define NV_MAP_MEM(card)                ((card)->backend->map_mem(card))
+#define NV_UNMAP_MEM(card)              ((card)->backend->unmap_mem(card))
+#define NV_RD08(card, ap, off)          ((card)->backend->read8(card, ap, off))
+#define NV_RD32(card, ap, off)          ((card)->backend->read32(card, ap, off))
+#define NV_WR32(card, ap, off, val)     ((card)->backend->write32(card, ap, off, val))
+#define NV_COPY(card, ap, off, dst, len) ((card)->backend->copy(card, ap, off, dst, len))
 
-extern NVCard* nv_card;
@@ -0,0 +1,429 @@
+/*
+ * Copyright(C) 2010 Andrew Powell
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA 02111-1307, USA
+ */
+
+#define _GNU_SOURCE
+#include <dirent.h>
+#include <pthread.h>
+#include <unistd.h>
+#include <stdio.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/stat.h>
+#include "backend.h"
+#include "bios.h"
+#include "batch.h"
+#include "format.h"
+
+// Batch mode: read and print a whole collection of rom images using one worker thread per core,
+// or dump all cards of a machine with one thread per card.
+// Every image gets its own output buffers so the results can be printed in input order no matter which worker finishes first.
+
+struct batch_job
+{
+  char *filename;
+  char *out;
+  char *err;
+  size_t out_len;
+  size_t err_len;
+  char ok;
+  char done;
+};
+
+struct batch
+{
+  struct batch_job *jobs;
+  u_int num_jobs;
+  u_int max_jobs;
+  u_int next_job;
+  const struct nvbios *opts; // every bios starts as a copy of this one (force, verbose, ...)
+  pthread_mutex_t lock;
+  pthread_cond_t job_done;
+};
+
+// Print the buffered output of one image; under a header in the text format, as the next record in the others
+static void batch_print(int format, u_int *records, const char *title, char *out, size_t out_len, char *err, size_t err_len)
+{
+  if(format == FORMAT_TEXT)
+    printf("==> %s <==\n", title);
+  fflush(stdout);
+  if(err_len)
+  {
+    fwrite(err, 1, err_len, stderr);
+    fflush(stderr);
+  }
+  if(!out_len)
+    return;
+
+  if(format == FORMAT_JSON)
+  {
+    if((*records)++)
+      print_records_separator(stdout, format);
+    if(out[out_len-1] == '\n')
+      out_len--;
+  }
+  fwrite(out, 1, out_len, stdout);
+}
+
+static int batch_add(struct batch *batch, const char *filename)
+{
+  if(batch->num_jobs == batch->max_jobs)
+  {
+    u_int max_jobs = batch->max_jobs ? batch->max_jobs * 2 : 64;
+    struct batch_job *jobs = realloc(batch->jobs, max_jobs * sizeof(struct batch_job));
+
+    if(!jobs)
+      return 0;
+
+    batch->jobs = jobs;
+    batch->max_jobs = max_jobs;
+  }
+
+  memset(batch->jobs + batch->num_jobs, 0, sizeof(struct batch_job));
+  if(!(batch->jobs[batch->num_jobs].filename = strdup(filename)))
+    return 0;
+
+  batch->num_jobs++;
+  return 1;
+}
+
+static int batch_filter(const struct dirent *entry)
+{
+  return entry->d_name[0] != '.';
+}
+
+// Every regular file in the directory, sorted by name
+static int batch_scan_dir(struct batch *batch, const char *dirname)
+{
+  struct dirent **entries;
+  struct stat stbuf;
+  char *filename;
+  int i, n, ret = 1;
+
+  if((n = scandir(dirname, &entries, batch_filter, alphasort)) < 0)
+  {
+    printf("Error: Cannot read directory %s\n", dirname);
+    return 0;
+  }
+
+  for(i = 0; i < n; i++)
+  {
+    if(ret && asprintf(&filename, "%s/%s", dirname, entries[i]->d_name) != -1)
+    {
+      if(!stat(filename, &stbuf) && S_ISREG(stbuf.st_mode))
+        ret = batch_add(batch, filename);
+      free(filename);
+    }
+    free(entries[i]);
+  }
+  free(entries);
+
+  return ret;
+}
+
+// One filename per line; empty lines and lines starting with '#' are skipped.  "-" reads the list from stdin.
+static int batch_read_list(struct batch *batch, const char *listname)
+{
+  FILE *fp = strcmp(listname, "-") ? fopen(listname, "r") : stdin;
+  char *line = NULL;
+  size_t size = 0;
+  ssize_t len;
+  int ret = 1;
+
+  if(!fp)
+  {
+    printf("Error: Cannot open list %s\n", listname);
+    return 0;
+  }
+
+  while(ret && (len = getline(&line, &size, fp)) != -1)
+  {
+    while(len && (line[len-1] == '\n' || line[len-1] == '\r'))
+      line[--len] = 0;
+
+    if(len && line[0] != '#')
+      ret = batch_add(batch, line);
+  }
+
+  free(line);
+  if(fp != stdin)
+    fclose(fp);
+
+  return ret;
+}
+
+static void *batch_worker(void *arg)
+{
+  struct batch *batch = arg;
+  struct batch_job *job;
+  struct nvbios *bios;
+  FILE *out, *err;
+
+  if(!(bios = malloc(sizeof(struct nvbios))))
+    return NULL;
+
+  for(;;)
+  {
+    pthread_mutex_lock(&batch->lock);
+    job = batch->next_job < batch->num_jobs ? batch->jobs + batch->next_job++ : NULL;
+    pthread_mutex_unlock(&batch->lock);
+
+    if(!job)
+      break;
+
+    out = open_memstream(&job->out, &job->out_len);
+    err = open_memstream(&job->err, &job->err_len);
+
+    if(out && err)
+    {
+      *bios = *batch->opts;
+      bios->out = out;
+      bios->err = err;
+
+      if(read_bios(bios, job->filename))
+      {
+        print_bios_info(bios);
+        job->ok = 1;
+      }
+      free_bios(bios);
+    }
+
+    if(out)
+      fclose(out);
+    if(err)
+      fclose(err);
+
+    pthread_mutex_lock(&batch->lock);
+    job->done = 1;
+    pthread_cond_broadcast(&batch->job_done);
+    pthread_mutex_unlock(&batch->lock);
+  }
+
+  free(bios);
+  return NULL;
+}
+
+// Returns the number of images which could not be read or -1 if the batch could not be started at all
+int run_batch(const char *source, struct nvbios *opts)
+{
+  struct batch batch;
+  struct stat stbuf;
+  pthread_t *workers;
+  long num_cpus;
+  u_int i, num_workers, failed = 0, records = 0;
+  int ret;
+
+  memset(&batch, 0, sizeof(struct batch));
+  batch.opts = opts;
+
+  if(!stat(source, &stbuf) && S_ISDIR(stbuf.st_mode))
+    ret = batch_scan_dir(&batch, source);
+  else
+    ret = batch_read_list(&batch, source);
+
+  if(!ret || !batch.num_jobs)
+  {
+    if(ret)
+      printf("Error: No rom images found in %s\n", source);
+
+    for(i = 0; i < batch.num_jobs; i++)
+      free(batch.jobs[i].filename);
+    free(batch.jobs);
+    return -1;
+  }
+
+  num_cpus = sysconf(_SC_NPROCESSORS_ONLN);
+  num_workers = num_cpus < 1 ? 1 : num_cpus;
+  if(num_workers > batch.num_jobs)
+    num_workers = batch.num_jobs;
+
+  if(opts->verbose)
+    fprintf(stderr, "Processing %u rom images with %u workers\n", batch.num_jobs, num_workers);
+
+  pthread_mutex_init(&batch.lock, NULL);
+  pthread_cond_init(&batch.job_done, NULL);
+
+  workers = calloc(num_workers, sizeof(pthread_t));
+  for(i = 0; workers && i < num_workers; i++)
+    if(pthread_create(workers + i, NULL, batch_worker, &batch))
+      break;
+  num_workers = workers ? i : 0;
+
+  // Not even one worker; do the work on this thread
+  if(!num_workers)
+    batch_worker(&batch);
+
+  // Print the results in input order as soon as they are available
+  print_records_begin(stdout, opts->format, 1);
+  for(i = 0; i < batch.num_jobs; i++)
+  {
+    struct batch_job *job = batch.jobs + i;
+
+    pthread_mutex_lock(&batch.lock);
+    while(!job->done)
+      pthread_cond_wait(&batch.job_done, &batch.lock);
+    pthread_mutex_unlock(&batch.lock);
+
+    batch_print(opts->format, &records, job->filename, job->out, job->out_len, job->err, job->err_len);
+
+    if(!job->ok)
+      failed++;
+
+    free(job->out);
+    free(job->err);
+    free(job->filename);
+  }
+  print_records_end(stdout, opts->format, 1);
+
+  for(i = 0; i < num_workers; i++)
+    pthread_join(workers[i], NULL);
+
+  pthread_cond_destroy(&batch.job_done);
+  pthread_mutex_destroy(&batch.lock);
+  free(workers);
+  free(batch.jobs);
+
+  return failed;
+}
+
+/* ---- all cards ---- */
+
+struct card_job
+{
+  NVCard *card;
+  struct nvbios bios;
+  const char *outdir;
+  int print_info;
+  char *out;
+  char *err;
+  size_t out_len;
+  size_t err_len;
+  char ok;
+};
+
+static void *card_worker(void *arg)
+{
+  struct card_job *job = arg;
+  struct nvbios *bios = &job->bios;
+  NVCard *card = job->card;
+  char *filename;
+
+  bios->out = open_memstream(&job->out, &job->out_len);
+  bios->err = open_memstream(&job->err, &job->err_len);
+  bios->card = card;
+
+  // read_bios maps the registers only if the rom can't be read through sysfs
+  if(bios->out && bios->err)
+  {
+    if(read_bios(bios, NULL))
+    {
+      job->ok = 1;
+
+      if(job->print_info)
+        print_bios_info(bios);
+
+      // Name the images after the PCI location of the card, like sysfs does, so they can be told apart
+      if(job->outdir)
+      {
+        if(asprintf(&filename, "%s/%04x:%02x:%02x.%x.rom", job->outdir, card->domain, card->bus, card->device, card->function) != -1)
+        {
+          if(!write_bios(bios, filename))
+          {
+            fprintf(bios->err, "Error: Unable to dump the rom image\n");
+            job->ok = 0;
+          }
+          free(filename);
+        }
+        else
+          job->ok = 0;
+      }
+    }
+    if(card->mapped)
+      NV_UNMAP_MEM(card);
+  }
+
+  free_bios(bios);
+  if(bios->out)
+    fclose(bios->out);
+  if(bios->err)
+    fclose(bios->err);
+
+  return NULL;
+}
+
+// Read (and save to outdir when set) the bios of every card in parallel; returns the number of cards which failed or -1 if nothing could be started
+int run_cards(NVCard *cards, u_int num_cards, struct nvbios *opts, const char *outdir, int print_info)
+{
+  struct card_job *jobs;
+  pthread_t *threads;
+  char *started;
+  char title[128];
+  u_int i, failed = 0, records = 0;
+
+  jobs = calloc(num_cards, sizeof(struct card_job));
+  threads = calloc(num_cards, sizeof(pthread_t));
+  started = calloc(num_cards, 1);
+  if(!jobs || !threads || !started)
+  {
+    free(jobs);
+    free(threads);
+    free(started);
+    return -1;
+  }
+
+  for(i = 0; i < num_cards; i++)
+  {
+    jobs[i].card = cards + i;
+    jobs[i].bios = *opts;
+    jobs[i].outdir = outdir;
+    jobs[i].print_info = print_info;
+
+    started[i] = !pthread_create(threads + i, NULL, card_worker, jobs + i);
+    if(!started[i])
+      card_worker(jobs + i);
+  }
+
+  if(print_info)
+    print_records_begin(stdout, opts->format, 1);
+
+  for(i = 0; i < num_cards; i++)
+  {
+    struct card_job *job = jobs + i;
+
+    if(started[i])
+      pthread_join(threads[i], NULL);
+
+    snprintf(title, sizeof(title), "%04x:%02x:%02x.%x %s", job->card->domain, job->card->bus, job->card->device, job->card->function, job->card->adapter_name);
+    batch_print(opts->format, &records, title, job->out, job->out_len, job->err, job->err_len);
+
+    if(!job->ok)
+      failed++;
+
+    free(job->out);
+    free(job->err);
+  }
+
+  if(print_info)
+    print_records_end(stdout, opts->format, 1);
+
+  free(jobs);
+  free(threads);
+  free(started);
+
+  return failed;
+}
@@ -0,0 +1,1028 @@
+/*
+ * Copyright(C) 2010 Andrew Powell
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA 02111-1307, USA
+ */
+
+// Microbenchmarks for the hot paths of the library; build and run with "make bench"
+
+#include <stdio.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+#include <sys/stat.h>
+#include <sys/types.h>
+#include "backend.h"
+#include "back_sim.h"
+#include "bios.h"
+#include "crc32.h"
+#include "info.h"
+#include "init.h"
+#include "initexec.h"
+#include "pll.h"
+#include "romgen.h"
+#include "search.h"
+
+enum { BENCH_BUF_SIZE = 0x100000, BENCH_ROM_SIZE = 0x10000 };
+
+static const double bench_time = 0.25; // seconds per benchmark
+
+static u_char buf[BENCH_BUF_SIZE];
+static u_int bench_failures;
+
+static double now(void)
+{
+  struct timespec ts;
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return ts.tv_sec + ts.tv_nsec / 1e9;
+}
+
+// Repeat fn for bench_time seconds and report the rate; bytes is the amount of data one call touches, 0 if that means nothing
+static void bench(const char *name, void (*fn)(void *), void *arg, u_int bytes)
+{
+  double start, elapsed;
+  u_long ops = 0;
+
+  start = now();
+  do
+  {
+    fn(arg);
+    ops++;
+  } while((elapsed = now() - start) < bench_time);
+
+  printf("%-48s %12.0f ops/s %10.1f MB/s\n", name, ops / elapsed, (double)bytes * ops / elapsed / 1e6);
+}
+
+static void check(int ok, const char *what)
+{
+  if(!ok)
+  {
+    fprintf(stderr, "Error: %s\n", what);
+    bench_failures++;
+  }
+}
+
+// Deterministic filler so runs are comparable
+static void fill_random(u_char *data, u_int size, uint32_t seed)
+{
+  u_int i;
+
+  for(i = 0; i < size; i++)
+  {
+    seed = seed * 1103515245 + 12345;
+    data[i] = seed >> 16;
+  }
+}
+
+/* ---- masked pattern search ---- */
+
+struct search_arg
+{
+  const u_char *str;
+  const u_char *mask;
+  u_int len;
+  u_int max_matches;
+  u_int matches[256];
+  u_int (*search)(const u_char *, u_int, const u_char *, const u_char *, u_int, u_int *, u_int);
+};
+
+static void bench_search(void *arg)
+{
+  struct search_arg *s = arg;
+  s->search(buf, BENCH_ROM_SIZE, s->str, s->mask, s->len, s->matches, s->max_matches);
+}
+
+static void bench_masked_search(void)
+{
+  // The set_speaker pattern
+  static const u_char toggle_string[5] = { 0x50, 0x0C & 0x24, 0x00, 0xE6, 0x61 };
+  static const u_char toggle_mask[5] = { 0xFF, 0x0C & 0x24, 0x00, 0xFF, 0xFF };
+  // A loose pattern with lots of candidates
+  static const u_char loose_string[3] = { 0x00, 0x0, 0x01 };
+  static const u_char loose_mask[3] = { 0x03, 0x0, 0x03 };
+  struct search_arg ref, simd;
+  u_int n_ref, n_simd, len;
+
+  fill_random(buf, BENCH_BUF_SIZE, 1);
+  memcpy(buf + 0xbeef, toggle_string, 5);
+
+  // Every length and alignment has to give the same answer as the byte by byte search
+  for(len = 1; len <= 5; len++)
+  {
+    u_int size;
+    for(size = len; size < 80; size++)
+    {
+      n_ref = masked_search_scalar(buf + 0xbeef - size / 2, size, toggle_string, toggle_mask, len, ref.matches, 256);
+      n_simd = masked_search(buf + 0xbeef - size / 2, size, toggle_string, toggle_mask, len, simd.matches, 256);
+      check(n_ref == n_simd && !memcmp(ref.matches, simd.matches, n_ref * sizeof(u_int)), "masked_search differs from the scalar search");
+    }
+  }
+
+  n_ref = masked_search_scalar(buf, BENCH_ROM_SIZE, loose_string, loose_mask, 3, ref.matches, 256);
+  n_simd = masked_search(buf, BENCH_ROM_SIZE, loose_string, loose_mask, 3, simd.matches, 256);
+  check(n_ref == n_simd && !memcmp(ref.matches, simd.matches, n_ref * sizeof(u_int)), "masked_search differs from the scalar search");
+
+  ref.str = simd.str = toggle_string;
+  ref.mask = simd.mask = toggle_mask;
+  ref.len = simd.len = 5;
+  ref.max_matches = simd.max_matches = 2;
+  ref.search = masked_search_scalar;
+  simd.search = masked_search;
+
+  bench("masked search 64K, scalar", bench_search, &ref, BENCH_ROM_SIZE);
+  bench("masked search 64K, dispatched", bench_search, &simd, BENCH_ROM_SIZE);
+
+  ref.str = simd.str = loose_string;
+  ref.mask = simd.mask = loose_mask;
+  ref.len = simd.len = 3;
+  ref.max_matches = simd.max_matches = 256;
+
+  bench("masked search 64K all matches, scalar", bench_search, &ref, BENCH_ROM_SIZE);
+  bench("masked search 64K all matches, dispatched", bench_search, &simd, BENCH_ROM_SIZE);
+}
+
+/* ---- crc32 ---- */
+
+struct crc_arg
+{
+  u_int len;
+  unsigned int (*crc)(unsigned long, const unsigned char *, unsigned);
+};
+
+static void bench_crc(void *arg)
+{
+  struct crc_arg *c = arg;
+  c->crc(0, buf, c->len);
+}
+
+static void bench_crc32(void)
+{
+  static const u_int sizes[] = { 0x8000, BENCH_ROM_SIZE, 0x40000, 0x100000 };
+  struct crc_arg table, fast;
+  char name[64];
+  u_int i, off, len;
+
+  fill_random(buf, BENCH_BUF_SIZE, 2);
+
+  // Bit exactness for all tail lengths, alignments and seeds
+  for(off = 0; off < 16; off++)
+    for(len = 0; len < 300; len++)
+      check(crc32_little(off * 77, buf + off, len) == crc32_fast(off * 77, buf + off, len), "crc32_fast differs from crc32_little");
+  check(crc32_little(0, buf, BENCH_BUF_SIZE) == crc32_fast(0, buf, BENCH_BUF_SIZE), "crc32_fast differs from crc32_little");
+  check(crc32_fast(0, (const u_char *)"123456789", 9) == 0xCBF43926, "crc32_fast check value");
+
+  table.crc = crc32_little;
+  fast.crc = crc32_fast;
+
+  for(i = 0; i < sizeof(sizes) / sizeof(sizes[0]); i++)
+  {
+    table.len = fast.len = sizes[i];
+
+    sprintf(name, "crc32 %uK, table", sizes[i] / 1024);
+    bench(name, bench_crc, &table, sizes[i]);
+    sprintf(name, "crc32 %uK, dispatched", sizes[i] / 1024);
+    bench(name, bench_crc, &fast, sizes[i]);
+  }
+}
+
+/* ---- checksum-8 + crc32 ---- */
+
+static u_char sum8(const u_char *data, u_int len)
+{
+  u_char sum = 0;
+
+  while(len--)
+    sum += *data++;
+  return sum;
+}
+
+// Both store the checksum in arg so bench_checksum can compare them
+static void bench_sum_separate(void *arg)
+{
+  u_char *sum = arg;
+
+  *sum = sum8(buf, BENCH_ROM_SIZE);
+  crc32_fast(0, buf, BENCH_ROM_SIZE);
+}
+
+static void bench_sum_fused(void *arg)
+{
+  crc32_sum8(0, buf, BENCH_ROM_SIZE, arg);
+}
+
+static void bench_checksum(void)
+{
+  u_int off, len;
+  u_char sum, separate = 0, fused = 1;
+
+  fill_random(buf, BENCH_BUF_SIZE, 3);
+
+  for(off = 0; off < 16; off++)
+    for(len = 0; len < 300; len++)
+    {
+      check(crc32_sum8(off, buf + off, len, &sum) == crc32_little(off, buf + off, len), "crc32_sum8 differs from crc32_little");
+      check(sum == sum8(buf + off, len), "crc32_sum8 checksum is wrong");
+      check(crc32_sum8_big(off, buf + off, len, &sum) == crc32_big(off, buf + off, len), "crc32_sum8_big differs from crc32_big");
+      check(sum == sum8(buf + off, len), "crc32_sum8_big checksum is wrong");
+    }
+  check(crc32_sum8(0, buf, BENCH_BUF_SIZE, &sum) == crc32_little(0, buf, BENCH_BUF_SIZE) && sum == sum8(buf, BENCH_BUF_SIZE), "crc32_sum8 differs on 1M");
+
+  bench("checksum-8 + crc32 64K, two passes", bench_sum_separate, &separate, BENCH_ROM_SIZE);
+  bench("checksum-8 + crc32 64K, fused", bench_sum_fused, &fused, BENCH_ROM_SIZE);
+  check(separate == fused, "the fused checksum differs from the separate one");
+}
+
+/* ---- checksum update after small edits ---- */
+
+struct patch_arg
+{
+  struct nvbios *bios;
+  void (*update)(struct nvbios *, char);
+  u_int offset;
+  u_int value;
+};
+
+// Patch 4 bytes somewhere in the image and bring the checksum and the CRCs up to date
+static void bench_patch(void *arg)
+{
+  struct patch_arg *p = arg;
+
+  p->offset = (p->offset * 1103515245 + 12345) % (BENCH_ROM_SIZE - 0x100) + 0x10;
+  nv_write32(p->bios, p->offset, ++p->value * 2654435761U);
+  p->update(p->bios, 1);
+}
+
+static void bench_update_checksum(void)
+{
+  struct nvbios bios, ref;
+  struct patch_arg full, patched;
+  u_int i;
+
+  memset(&bios, 0, sizeof(struct nvbios));
+  bios.rom = buf;
+  bios.rom_size = BENCH_ROM_SIZE / 2;
+  fill_random(buf, NV_PROM_SIZE, 5);
+  buf[2] = bios.rom_size >> 9;
+  checksum_bios(&bios, 1);
+
+  // The patched sums have to match a full pass after every edit, inside and outside of the image
+  patched.bios = &bios;
+  patched.update = update_checksum;
+  patched.offset = patched.value = 0;
+  for(i = 0; i < 1000; i++)
+  {
+    bench_patch(&patched);
+
+    ref = bios;
+    checksum_bios(&ref, 0);
+    check(ref.checksum == 0 && ref.crc == bios.crc && ref.fake_crc == bios.fake_crc, "update_checksum differs from checksum_bios");
+  }
+
+  full.bios = patched.bios = &bios;
+  full.update = checksum_bios;
+  full.offset = full.value = 0;
+
+  bench("4 byte edit + checksum 32K, full pass", bench_patch, &full, 4);
+  checksum_bios(&bios, 1);
+  bench("4 byte edit + checksum 32K, patched", bench_patch, &patched, 4);
+}
+
+/* ---- PROM loading from a simulated card ---- */
+
+struct load_arg
+{
+  struct nvbios *bios;
+  int ok;
+};
+
+static void bench_load(void *arg)
+{
+  struct load_arg *l = arg;
+  load_bios_prom(l->bios);
+  l->ok = !memcmp(l->bios->rom, buf, BENCH_ROM_SIZE);
+}
+
+static void bench_load_prom(void)
+{
+  static const struct { u_int latency; double flip_rate; } sims[] = { { 0, 0 }, { 0, 1e-4 }, { 0, 1e-3 }, { 100, 0 } };
+  char dir[] = "/tmp/nhale_bench.XXXXXX", prom[64], name[64];
+  struct nvbios bios;
+  struct load_arg load;
+  NVCard card;
+  FILE *fp;
+  u_int i;
+  u_char sum = 0;
+
+  // A 64K image with a valid checksum; it is not a real rom so verify_bios will complain
+  fill_random(buf, BENCH_ROM_SIZE, 4);
+  buf[0] = 0x55;
+  buf[1] = 0xAA;
+  buf[2] = BENCH_ROM_SIZE >> 9;
+  for(i = 0; i < BENCH_ROM_SIZE - 1; i++)
+    sum += buf[i];
+  buf[BENCH_ROM_SIZE-1] = -sum;
+
+  if(!mkdtemp(dir))
+  {
+    check(0, "cannot create a directory for the simulated card");
+    return;
+  }
+  sprintf(prom, "%s/prom", dir);
+  if(!(fp = fopen(prom, "wb")) || fwrite(buf, 1, BENCH_ROM_SIZE, fp) != BENCH_ROM_SIZE)
+    check(0, "cannot write the simulated rom");
+  if(fp)
+    fclose(fp);
+
+  for(i = 0; i < sizeof(sims) / sizeof(sims[0]); i++)
+  {
+    if(!sim_open_card(&card, dir, sims[i].latency, sims[i].flip_rate))
+    {
+      check(0, "cannot set up the simulated card");
+      break;
+    }
+
+    memset(&bios, 0, sizeof(struct nvbios));
+    bios.card = &card;
+    bios.out = bios.err = fopen("/dev/null", "w");
+    load.bios = &bios;
+
+    bench_load(&load);
+    check(load.ok, "load_bios_prom did not read the simulated rom");
+
+    sprintf(name, "load_bios_prom 64K, %uns, flip rate %g", sims[i].latency, sims[i].flip_rate);
+    bench(name, bench_load, &load, BENCH_ROM_SIZE);
+
+    if(bios.out)
+      fclose(bios.out);
+    free_bios(&bios);
+    sim_close_card(&card);
+  }
+
+  unlink(prom);
+  rmdir(dir);
+}
+
+/* ---- synthetic rom images ---- */
+
+struct image_arg
+{
+  struct nvbios *bios;
+  const struct nvbios *opts;
+  const char *filename;
+  const char *outname;
+  u_int value;
+};
+
+static u_char image[NV_PROM_SIZE];
+
+// The device ids the parsers expect for every perf table version
+static u_short image_device_id(u_char perf_version)
+{
+  if(perf_version < 0x25)
+    return 0x0091; // G70
+  if(perf_version == 0x25)
+    return 0x0191; // G80
+  return perf_version == 0x30 ? 0x0402 : 0x0611; // G84, G92
+}
+
+// Set up a bios over an image in memory the way read_bios would; the bios does not own the rom
+static int open_image(struct nvbios *bios, const struct nvbios *opts, u_char *rom, u_int size)
+{
+  *bios = *opts;
+  bios->rom = rom;
+  bios->rom_size = size;
+  checksum_bios(bios, 0);
+  index_bios(bios);
+  if(!verify_bios(bios) || !parse_bios(bios, 1))
+    return 0;
+  parse_tables(bios, TABLE_ALL);
+  return 1;
+}
+
+static void close_image(struct nvbios *bios)
+{
+  bios->rom = NULL;
+  free_bios(bios);
+}
+
+// Every table version and size the generator knows has to come out of the parsers as it went in
+static void check_images(const struct nvbios *opts)
+{
+  static const u_char perf_versions[] = { 0, 0x21, 0x22, 0x23, 0x24, 0x25, 0x30, 0x35 };
+  static const u_char volt_versions[] = { 0x10, 0x20, 0x30 };
+  static const u_int sizes[] = { 0x8000, 0xC000, 0x10000 };
+  struct romgen gen;
+  struct nvbios bios;
+  u_int p, v, s;
+  int ok;
+
+  for(p = 0; p < sizeof(perf_versions); p++)
+    for(v = 0; v < sizeof(volt_versions); v++)
+      for(s = 0; s < sizeof(sizes) / sizeof(sizes[0]); s++)
+      {
+        gen.size = sizes[s];
+        gen.perf_version = perf_versions[p];
+        gen.volt_version = volt_versions[v];
+        gen.init_repeat = 0;
+        gen.device_id = gen.perf_version ? image_device_id(gen.perf_version) : 0x0330;
+
+        ok = romgen_build(&gen, image) == gen.size && open_image(&bios, opts, image, gen.size);
+        check(ok, "a synthetic image can not be parsed");
+        if(!ok)
+          continue;
+
+        check(!bios.checksum && bios.rom_size == gen.size, "a synthetic image has the wrong size or checksum");
+        if(gen.perf_version)
+        {
+          check(bios.perf_table_version == gen.perf_version && bios.perf_entries == (gen.perf_version < 0x25 ? 3 : 2), "the perf table of a synthetic image is parsed wrong");
+          check(bios.volt_table_version == gen.volt_version && bios.volt_entries, "the voltage table of a synthetic image is parsed wrong");
+          check(bios.caps && bios.crtcl_int_thld == 110, "the temperature table of a synthetic image is parsed wrong");
+        }
+        else
+          check((bios.arch & NV3X) && bios.perf_entries == 3 && bios.volt_entries, "a synthetic BMP image is parsed wrong");
+
+        close_image(&bios);
+      }
+}
+
+static void bench_load_file(void *arg)
+{
+  struct image_arg *a = arg;
+  struct nvbios bios = *a->opts;
+
+  load_bios_file(&bios, a->filename);
+  free_bios(&bios);
+}
+
+static void bench_verify(void *arg)
+{
+  struct image_arg *a = arg;
+  verify_bios(a->bios);
+}
+
+static void bench_parse_read(void *arg)
+{
+  struct image_arg *a = arg;
+
+  parse_bios(a->bios, 1);
+  parse_tables(a->bios, TABLE_ALL);
+}
+
+static void bench_parse_write(void *arg)
+{
+  struct image_arg *a = arg;
+  parse_bios(a->bios, 0);
+}
+
+static void bench_locate(void *arg)
+{
+  struct image_arg *a = arg;
+
+  // Not in the images, so every call scans all of it
+  locate_segment(a->bios, (u_char *)"NPDE", 0, 4);
+}
+
+static void bench_checksum_bios(void *arg)
+{
+  struct image_arg *a = arg;
+  checksum_bios(a->bios, 0);
+}
+
+// A real edit every time so the verification has something to check
+static void bench_write(void *arg)
+{
+  struct image_arg *a = arg;
+
+  a->bios->perf_lst[0].fanspeed = 40 + (++a->value & 1);
+  write_bios(a->bios, a->outname);
+}
+
+// Edits which are not in the perf entries themselves have to end up in the saved checksum and the patched CRC as well
+static void check_write(const struct nvbios *opts, const char *filename, const char *outname)
+{
+  struct nvbios bios = *opts, saved;
+  int ok;
+
+  if(!read_bios(&bios, filename))
+  {
+    check(0, "cannot read the image");
+    return;
+  }
+  parse_tables(&bios, TABLE_ALL);
+  if(bios.arch <= NV3X)
+  {
+    free_bios(&bios);
+    return;
+  }
+
+  bios.active_perf_entries = 1;
+  ok = write_bios(&bios, outname);
+  check(ok, "cannot save an image with fewer active perf entries");
+
+  saved = *opts;
+  if(ok && read_bios(&saved, outname))
+  {
+    parse_tables(&saved, TABLE_ALL);
+    check(saved.active_perf_entries == 1, "the active perf entries are not saved");
+    check(!saved.checksum, "the checksum of a saved image is wrong");
+    check(saved.crc == bios.crc, "the CRC patched by update_checksum differs from the saved image");
+    free_bios(&saved);
+  }
+  else if(ok)
+    check(0, "cannot read the saved image");
+  free_bios(&bios);
+}
+
+// Saving through a symlink replaces the file it points to, and an existing file keeps its mode
+static void check_save_target(const struct nvbios *opts, const char *dir, const char *filename)
+{
+  struct nvbios bios = *opts;
+  struct stat stbuf;
+  char target[64], link[64];
+  FILE *fp;
+
+  if(!read_bios(&bios, filename))
+  {
+    check(0, "cannot read the image");
+    return;
+  }
+
+  sprintf(target, "%s/target.rom", dir);
+  sprintf(link, "%s/link.rom", dir);
+  if((fp = fopen(target, "wb")))
+    fclose(fp);
+  if(!fp || chmod(target, 0640) || symlink("target.rom", link))
+    check(0, "cannot create the file to save over");
+  else
+  {
+    check(write_bios(&bios, link), "cannot save through a symlink");
+    check(!lstat(link, &stbuf) && S_ISLNK(stbuf.st_mode), "saving replaced the symlink");
+    check(!stat(target, &stbuf) && stbuf.st_size == bios.rom_size, "saving through a symlink did not write the file it points to");
+    check(write_bios(&bios, target) && !stat(target, &stbuf) && (stbuf.st_mode & 07777) == 0640, "saving over a file changed its mode");
+  }
+
+  unlink(link);
+  unlink(target);
+  free_bios(&bios);
+}
+
+static void bench_images(void)
+{
+  static const struct { const char *name; struct romgen gen; } images[] =
+  {
+    { "BMP 32K", { 0x8000, 0x0330, 0, 0, 0 } },
+    { "BIT perf 0x24 volt 0x20 32K", { 0x8000, 0x0091, 0x24, 0x20, 0 } },
+    { "BIT perf 0x35 volt 0x30 48K", { 0xC000, 0x0611, 0x35, 0x30, 0 } },
+    { "BIT perf 0x30 volt 0x10 64K", { 0x10000, 0x0402, 0x30, 0x10, 0 } }
+  };
+  char dir[] = "/tmp/nhale_bench.XXXXXX", filename[64], outname[64], name[96];
+  struct nvbios opts, bios, file;
+  struct image_arg arg;
+  u_int i, size;
+  FILE *fp;
+
+  memset(&opts, 0, sizeof(struct nvbios));
+  opts.out = opts.err = fopen("/dev/null", "w");
+
+  check_images(&opts);
+
+  if(!mkdtemp(dir))
+  {
+    check(0, "cannot create a directory for the images");
+    return;
+  }
+  sprintf(filename, "%s/image.rom", dir);
+  sprintf(outname, "%s/out.rom", dir);
+
+  arg.opts = &opts;
+  arg.filename = filename;
+  arg.outname = outname;
+  arg.value = 0;
+
+  for(i = 0; i < sizeof(images) / sizeof(images[0]); i++)
+  {
+    size = romgen_build(&images[i].gen, image);
+    if(!(fp = fopen(filename, "wb")) || fwrite(image, 1, size, fp) != size)
+      check(0, "cannot write the image");
+    if(fp)
+      fclose(fp);
+
+    sprintf(name, "load_bios_file %s", images[i].name);
+    bench(name, bench_load_file, &arg, size);
+
+    if(!open_image(&bios, &opts, image, size))
+    {
+      check(0, "cannot parse the image");
+      continue;
+    }
+    arg.bios = &bios;
+
+    sprintf(name, "verify_bios %s", images[i].name);
+    bench(name, bench_verify, &arg, 0);
+    sprintf(name, "parse_bios read %s", images[i].name);
+    bench(name, bench_parse_read, &arg, 0);
+    sprintf(name, "parse_bios write %s", images[i].name);
+    bench(name, bench_parse_write, &arg, 0);
+    sprintf(name, "locate_segment %s", images[i].name);
+    bench(name, bench_locate, &arg, size);
+    sprintf(name, "checksum_bios %s", images[i].name);
+    bench(name, bench_checksum_bios, &arg, size);
+    close_image(&bios);
+
+    // write_bios works on a loaded file like nhale -s does
+    file = opts;
+    if(!read_bios(&file, filename))
+    {
+      check(0, "cannot read the image");
+      continue;
+    }
+    parse_tables(&file, TABLE_ALL);
+    arg.bios = &file;
+    check_write(&opts, filename, outname);
+    check_save_target(&opts, dir, filename);
+
+    sprintf(name, "write_bios %s", images[i].name);
+    bench(name, bench_write, &arg, size);
+    free_bios(&file);
+  }
+
+  unlink(filename);
+  unlink(outname);
+  rmdir(dir);
+  if(opts.out)
+    fclose(opts.out);
+}
+
+/* ---- init scripts ---- */
+
+struct init_arg
+{
+  struct nvbios *bios;
+  u_int sum;
+  u_int regs[256];
+};
+
+static void bench_init_decode(void *arg)
+{
+  struct init_arg *a = arg;
+
+  free_init_ir(a->bios);
+  parse_init_scripts(a->bios);
+}
+
+// What an analysis pass does: look at every register write of every script
+static void bench_init_walk_ir(void *arg)
+{
+  struct init_arg *a = arg;
+  const struct init_ir *ir = a->bios->init_ir;
+  u_int i, sum = 0;
+
+  for(i = 0; i < ir->num_insns; i++)
+    if(ir->insns[i].op == 0x7a)
+      sum += ir->args[ir->insns[i].args] ^ ir->args[ir->insns[i].args+1];
+  a->sum = sum;
+}
+
+// The same on the raw bytes, the way it had to be done before
+static void bench_init_walk_raw(void *arg)
+{
+  struct init_arg *a = arg;
+  const struct init_ir *ir = a->bios->init_ir;
+  const u_char *rom = a->bios->rom;
+  u_int i, offset, len, sum = 0;
+
+  for(i = 0; i < ir->num_scripts; i++)
+    for(offset = ir->scripts[i].offset; rom[offset] != INIT_OP_DONE && (len = init_op_len(a->bios, offset)); offset += len)
+      if(rom[offset] == 0x7a)
+        sum += (rom[offset+1] | rom[offset+2] << 8 | rom[offset+3] << 16 | (u_int)rom[offset+4] << 24) ^
+               (rom[offset+5] | rom[offset+6] << 8 | rom[offset+7] << 16 | (u_int)rom[offset+8] << 24);
+  a->sum = sum;
+}
+
+static void bench_reg_index(void *arg)
+{
+  struct init_arg *a = arg;
+  struct init_ir *ir = a->bios->init_ir;
+
+  free(ir->reg_writes);
+  ir->reg_writes = NULL;
+  ir->num_reg_writes = 0;
+  index_reg_writes(a->bios);
+}
+
+static void bench_reg_find(void *arg)
+{
+  struct init_arg *a = arg;
+  const struct init_reg_write *w;
+  u_int i, sum = 0;
+
+  for(i = 0; i < 256; i++)
+    sum += find_reg_writes(a->bios->init_ir, a->regs[i], &w);
+  a->sum = sum;
+}
+
+// Every question answered by going through all the writes again
+static void bench_reg_scan(void *arg)
+{
+  struct init_arg *a = arg;
+  const struct init_ir *ir = a->bios->init_ir;
+  u_int i, j, sum = 0;
+
+  for(i = 0; i < 256; i++)
+    for(j = 0; j < ir->num_reg_writes; j++)
+      sum += ir->reg_writes[j].reg == a->regs[i];
+  a->sum = sum;
+}
+
+static void bench_init_run(void *arg)
+{
+  struct init_arg *a = arg;
+  struct init_exec e;
+
+  memset(&e, 0, sizeof(struct init_exec));
+  run_init_scripts(a->bios, &e);
+  a->sum = e.num_snapshot;
+  free_init_exec(&e);
+}
+
+static void bench_init(void)
+{
+  static const struct romgen gen = { 0x10000, 0x0611, 0x35, 0x30, 255 };
+  const struct init_ir *ir;
+  struct nvbios opts, bios;
+  struct init_exec exec;
+  struct init_arg arg;
+  u_int i, bytes = 0, sum;
+
+  memset(&opts, 0, sizeof(struct nvbios));
+  opts.out = opts.err = fopen("/dev/null", "w");
+
+  if(!romgen_build(&gen, image) || !open_image(&bios, &opts, image, gen.size) || !(ir = parse_init_scripts(&bios)))
+  {
+    check(0, "cannot decode the init scripts of the synthetic image");
+    return;
+  }
+
+  check(ir->num_scripts == 2 && !ir->truncated && ir->scripts[0].num_insns == 10 * 256 + 1, "the init scripts are decoded wrong");
+  check(bios.pipe_cfg == 0x3f00ff01 && bios.nvpll == 0x00011c07 && bios.mpll == 0x00021d08, "the registers set by the init scripts are wrong");
+  for(i = 0; i < ir->num_insns; i++)
+    bytes += ir->insns[i].len;
+
+  arg.bios = &bios;
+  bench_init_walk_ir(&arg);
+  sum = arg.sum;
+  bench_init_walk_raw(&arg);
+  check(sum == arg.sum, "walking the init IR differs from walking the raw scripts");
+
+  bench("parse_init_scripts 2.6K insns", bench_init_decode, &arg, bytes);
+  bench("walk init scripts, IR", bench_init_walk_ir, &arg, bytes);
+  bench("walk init scripts, raw", bench_init_walk_raw, &arg, bytes);
+
+  memset(&exec, 0, sizeof(struct init_exec));
+  check(run_init_scripts(&bios, &exec) && !exec.flags, "cannot run the init scripts");
+  check(get_init_reg(&exec, 0x1540, NULL) == bios.pipe_cfg && get_init_reg(&exec, 0x4000, NULL) == bios.nvpll &&
+        get_init_reg(&exec, 0x4020, NULL) == bios.mpll && get_init_reg(&exec, 0x100204, NULL) == 8, "the init scripts leave the wrong registers");
+  check(exec.num_nops == 256 * 2 + 1 && exec.num_plls == 256, "the init scripts record the wrong instructions");
+  free_init_exec(&exec);
+
+  // An INIT_REPEAT with a count of 0 runs its body once, so one INIT_ZM_CR less
+  ir = parse_init_scripts(&bios);
+  for(i = 0; ir && i < ir->num_insns && ir->insns[i].op != 0x33; i++);
+  if(ir && i < ir->num_insns)
+  {
+    u_int count = ir->insns[i].offset + 1;
+
+    image[count] = 0;
+    free_init_ir(&bios);
+    memset(&exec, 0, sizeof(struct init_exec));
+    check(run_init_scripts(&bios, &exec) && exec.num_nops == 256 * 2, "an INIT_REPEAT count of 0 does not run the body once");
+    free_init_exec(&exec);
+    image[count] = 2;
+    free_init_ir(&bios);
+  }
+  else
+    check(0, "the init scripts have no INIT_REPEAT");
+
+  bench("run_init_scripts 2.6K insns", bench_init_run, &arg, bytes);
+
+  if(!index_reg_writes(&bios))
+  {
+    check(0, "cannot index the register writes");
+    close_image(&bios);
+    fclose(opts.out);
+    return;
+  }
+
+  // Half of the registers are written, half are not
+  for(i = 0; i < 256; i++)
+    arg.regs[i] = i & 1 ? bios.init_ir->reg_writes[i * 7919 % bios.init_ir->num_reg_writes].reg : i * 4;
+  bench_reg_find(&arg);
+  sum = arg.sum;
+  bench_reg_scan(&arg);
+  check(sum == arg.sum, "the register index finds other writes than a scan");
+
+  bench("index_reg_writes", bench_reg_index, &arg, 0);
+  bench("256 register queries, index", bench_reg_find, &arg, 0);
+  bench("256 register queries, scan", bench_reg_scan, &arg, 0);
+
+  close_image(&bios);
+  if(opts.out)
+    fclose(opts.out);
+}
+
+/* ---- pll ---- */
+
+struct pll_arg
+{
+  struct pll pll;
+  u_int khz[256];
+  u_int sum;
+};
+
+static void bench_solve_pll(void *arg)
+{
+  struct pll_arg *a = arg;
+  struct pll_coefs coefs;
+  u_int i, sum = 0;
+
+  for(i = 0; i < 256; i++)
+    sum += solve_pll(&a->pll, PLL_REFCLK, a->khz[i], &coefs);
+  a->sum = sum;
+}
+
+static void bench_pll_list(void *arg)
+{
+  struct pll_arg *a = arg;
+
+  free_pll_clocks();
+  a->sum = pll_clock_list(&a->pll, PLL_REFCLK)->num_clocks;
+}
+
+static void bench_nearest_pll(void *arg)
+{
+  struct pll_arg *a = arg;
+  const struct pll_clocks *clocks = pll_clock_list(&a->pll, PLL_REFCLK);
+  u_int i, sum = 0;
+
+  for(i = 0; i < 256; i++)
+    sum += nearest_pll_clock(clocks, a->khz[i], NULL);
+  a->sum = sum;
+}
+
+static u_int khz_diff(u_int a, u_int b)
+{
+  return a > b ? a - b : b - a;
+}
+
+static void bench_pll(void)
+{
+  // A two stage PLL like the memory PLL of the NV4x
+  static const struct vco vco1 = { 5000, 27000, 200000, 800000, 1, 255, 1, 13 };
+  static const struct vco vco2 = { 30000, 400000, 400000, 1400000, 1, 31, 1, 4 };
+  static const struct romgen gen = { 0x10000, 0x0611, 0x35, 0x30, 0 };
+  const struct pll_clocks *clocks;
+  const struct pll *rom_pll;
+  struct pll_coefs coefs;
+  struct pll_arg arg;
+  struct nvbios opts, bios;
+  u_int i, solved, listed, bad = 0;
+
+  // The limits of the synthetic image come from its 'C' table
+  memset(&opts, 0, sizeof(struct nvbios));
+  opts.out = opts.err = fopen("/dev/null", "w");
+  if(romgen_build(&gen, image) && open_image(&bios, &opts, image, gen.size))
+  {
+    rom_pll = find_pll(&bios, 0x4020);
+    check(bios.pll_entries == 2 && rom_pll && rom_pll->VCO1.maxFreq == 1000000 && rom_pll->var1d == 6, "the pll limits of the synthetic image are parsed wrong");
+    close_image(&bios);
+  }
+  else
+    check(0, "cannot open the synthetic image");
+  if(opts.out)
+    fclose(opts.out);
+
+  memset(&arg, 0, sizeof(struct pll_arg));
+  arg.pll.reg = 0x4020;
+  arg.pll.VCO1 = vco1;
+  arg.pll.VCO2 = vco2;
+  arg.pll.var1d = 6;
+  for(i = 0; i < 256; i++)
+    arg.khz[i] = 10000 + i * 5413;
+
+  if(!(clocks = pll_clock_list(&arg.pll, PLL_REFCLK)))
+  {
+    check(0, "cannot list the clocks of the pll");
+    return;
+  }
+
+  // Both have to find a clock as close as any
+  for(i = 0; i < 256; i++)
+  {
+    solved = solve_pll(&arg.pll, PLL_REFCLK, arg.khz[i], &coefs);
+    if(pll_clock(&arg.pll, PLL_REFCLK, &coefs) != solved)
+      bad++;
+    listed = nearest_pll_clock(clocks, arg.khz[i], &coefs);
+    if(pll_clock(&arg.pll, PLL_REFCLK, &coefs) != listed || khz_diff(solved, arg.khz[i]) > khz_diff(listed, arg.khz[i]) + 1 ||
+       khz_diff(listed, arg.khz[i]) > khz_diff(solved, arg.khz[i]) + 1)
+      bad++;
+  }
+  check(!bad, "solve_pll and the clock list disagree");
+
+  bench("256 solve_pll", bench_solve_pll, &arg, 0);
+  bench("pll_clock_list", bench_pll_list, &arg, 0);
+  bench("256 nearest_pll_clock", bench_nearest_pll, &arg, 0);
+
+  free_pll_clocks();
+}
+
+/* ---- id lookups ---- */
+
+enum { LOOKUPS_PER_OP = 256 };
+
+struct lookup_arg
+{
+  u_int id;
+  void (*lookup)(u_int);
+};
+
+// Keeps the compiler from dropping the lookups
+static volatile uintptr_t lookup_sink;
+
+static void lookup_card_name(u_int id)
+{
+  lookup_sink += (uintptr_t)get_card_name(id);
+}
+
+static void lookup_gpu_arch(u_int id)
+{
+  lookup_sink += get_gpu_arch(id);
+}
+
+static void lookup_subvendor_name(u_int id)
+{
+  lookup_sink += (uintptr_t)get_subvendor_name(id);
+}
+
+// A sweep over the whole id space, so hits and misses come in their natural ratio
+static void bench_lookup(void *arg)
+{
+  struct lookup_arg *l = arg;
+  u_int i;
+
+  for(i = 0; i < LOOKUPS_PER_OP; i++)
+    l->lookup(l->id++ & 0xffff);
+}
+
+static void bench_ids(void)
+{
+  struct lookup_arg arg;
+  char name[64];
+
+  arg.id = 0;
+  arg.lookup = lookup_card_name;
+  sprintf(name, "get_card_name x%u", LOOKUPS_PER_OP);
+  bench(name, bench_lookup, &arg, 0);
+
+  arg.lookup = lookup_gpu_arch;
+  sprintf(name, "get_gpu_arch x%u", LOOKUPS_PER_OP);
+  bench(name, bench_lookup, &arg, 0);
+
+  arg.lookup = lookup_subvendor_name;
+  sprintf(name, "get_subvendor_name x%u", LOOKUPS_PER_OP);
+  bench(name, bench_lookup, &arg, 0);
+}
+
+int main(int argc, char **argv)
+{
+  bench_masked_search();
+  bench_crc32();
+  bench_checksum();
+  bench_update_checksum();
+  bench_load_prom();
+  bench_images();
+  bench_init();
+  bench_pll();
+  bench_ids();
+
+  if(bench_failures)
+  {
+    fprintf(stderr, "%u consistency checks failed\n", bench_failures);
+    return -1;
+  }
+
+  return 0;
+}
@@ -22,39 +22,54 @@
  * Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA 02111-1307, USA
  */
 
+#define _GNU_SOURCE
+#include <errno.h>
 #include <fcntl.h>
 #include <sys/mman.h>
 #include <unistd.h>
 #include <stdio.h>
+#include <stddef.h>
 #include <stdint.h>
 #include <stdlib.h>
 #include <string.h>
 #include <sys/stat.h>
+#include <sys/vfs.h>
 #include "backend.h"
 #include "bios.h"
 #include "info.h"
 #include "crc32.h"
+#include "search.h"
+#include "format.h"
+#include "init.h"
+#include "initexec.h"
 #include "config.h"
 
 #define READ_BYTE(rom, offset) (*(u_char *)(rom + offset))
 
+// All messages go through the streams of the bios they belong to so that several bioses can be handled at once (see batch.c)
+#define OUT(bios) ((bios)->out ? (bios)->out : stdout)
+#define ERR(bios) ((bios)->err ? (bios)->err : stderr)
+// Diagnostics share out with the info in the text format; the structured formats keep out for the data alone
+#define LOG(bios) ((bios)->format != FORMAT_TEXT ? ERR(bios) : OUT(bios))
+
 // This file should now support big endian (imported from config.h)
-// NOTICE: Never read or write any type larger than one byte from the rom without these macros
+// NOTICE: Never read any type larger than one byte from the rom without these macros; writes go through nv_write*
 
 #ifndef NHALE_BIG_ENDIAN
   #define READ_LE_SHORT(rom, offset) (*(u_short *)(rom + offset))
   #define READ_LE_INT(rom, offset)   (*(u_int *)(rom + offset))
-  #define WRITE_LE_SHORT(data)       (data)
-  #define WRITE_LE_INT(data)         (data)
-  #define CRC(x,y,z)                 crc32_little(x,y,z)
+  #define CRC(x,y,z)                 crc32_fast(x,y,z)
+  #define CRC_SUM8(w,x,y,z)          crc32_sum8(w,x,y,z)
 #else
   #define READ_LE_SHORT(rom, offset) (READ_BYTE(rom, offset+1) << 8 | READ_BYTE(rom, offset))
   #define READ_LE_INT(rom, offset)   (READ_LE_SHORT(rom, offset+2) << 16 | READ_LE_SHORT(rom, offset))
-  #define WRITE_LE_SHORT(data)       (((data) << 8 & 0xff00) | ((data) >> 8 & 0x00ff ))
-  #define WRITE_LE_INT(data)         (WRITE_LE_SHORT(data) << 16 | WRITE_LE_SHORT(data >> 16))
   #define CRC(x,y,z)                 crc32_big(x,y,z)
+  #define CRC_SUM8(w,x,y,z)          crc32_sum8_big(w,x,y,z)
 #endif
 
+// Size of the mapping behind bios->rom, see map_rom
+enum { ROM_WINDOW_SIZE = NV_PROM_SIZE + 0x1000 };
+
 // NOTICE: Never divide a value (by a non-power of two) from the rom and store in the nvbios structure.  Because of finite precision we cannot guarantee we can get the original value back.  This is especially important when the user doesn't edit their rom at all and thus no values should change.
 
 // NOTE: Whenever an index is found we should probably check for out of bounds cases before parsing values after it
@@ -65,19 +80,6 @@
 // NOTE: Make an undo stack
 // TODO: with #define assert or #define debug assert x_entries < x_active_entries
 
-// these are macros for the caps member of struct nvbios
-
-enum
-{
-  TEMP_CORRECTION = (1 << 0),
-  FNBST_THLD_1 = (1 << 1),
-  FNBST_THLD_2 = (1 << 2),
-  CRTCL_THLD_1 = (1 << 3),
-  CRTCL_THLD_2 = (1 << 4),
-  THRTL_THLD_1 = (1 << 5),
-  THRTL_THLD_2 = (1 << 6)
-};
-
 struct BitTableHeader
 {
   uint8_t version;
@@ -103,51 +105,165 @@ struct BitPerformanceTableHeader
   uint8_t num_entries;
 };
 
+/* Strings are not copied out of the rom, the bios only keeps a view (offset, length, mask) on them.
+/  Since the view points at the rom itself there is nothing to write back when the bios is saved.
+*/
+
 // Read a string from a given offset
-void nv_read(struct nvbios *bios, char *str, u_short offset)
+void nv_read(struct nvbios *bios, struct rom_string *str, u_short offset)
 {
   u_short i;
-  for(i = 0; bios->rom[offset+i] && i < 255; i++)
-    str[i] = bios->rom[offset+i];
-  str[i] = 0;
+  for(i = 0; bios->rom[offset+i] && i < 255; i++);
+  nv_read_masked_segment(bios, str, offset, i, 0);
 }
 
-void nv_write(struct nvbios *bios, char *str, u_short offset)
+void nv_read_segment(struct nvbios *bios, struct rom_string *str, u_short offset, u_char len)
 {
-  u_short i;
-  for(i = 0; bios->rom[offset+i] && i < 255; i++)
-    bios->rom[offset+i] = str[i];
+  nv_read_masked_segment(bios, str, offset, len, 0);
 }
 
-void nv_read_segment(struct nvbios *bios, char *str, u_short offset, u_short len)
+// static mask
+void nv_read_masked_segment(struct nvbios *bios, struct rom_string *str, u_short offset, u_char len, u_char mask)
 {
-  u_short i;
-  for(i = 0; i < len; i++)
-    str[i] = bios->rom[offset+i];
-  str[i] = 0;
+  str->offset = offset;
+  str->len = len;
+  str->mask = mask;
 }
 
-void nv_write_segment(struct nvbios *bios, char *str, u_short offset, u_short len)
+// Decode a string into buf, which has to hold at least 256 chars; returns buf
+char *nv_string(struct nvbios *bios, const struct rom_string *str, char *buf)
 {
   u_short i;
-  for(i = 0; i < len; i++)
-    bios->rom[offset+i] = str[i];
+  for(i = 0; i < str->len && (bios->rom[str->offset+i] ^ str->mask); i++)
+    buf[i] = bios->rom[str->offset+i] ^ str->mask;
+  buf[i] = 0;
+  return buf;
 }
 
-// static mask
-void nv_read_masked_segment(struct nvbios *bios, char *str, u_short offset, u_short len, u_char mask)
+/* All writes to the rom go through these helpers. Bytes which keep their value are not stored and every real change
+/  is recorded in bios->dirty together with the table being written, so write_bios only has to verify what was touched.
+*/
+static void nv_mark_dirty(struct nvbios *bios, u_int offset, u_int len)
 {
-  u_short i;
-  for(i = 0; i < len; i++)
-    str[i] = bios->rom[offset+i] ^ mask;
-  str[i] = 0;
+  struct rom_dirty *dirty = &bios->dirty;
+  struct rom_range *last = dirty->num_ranges ? dirty->ranges + dirty->num_ranges - 1 : NULL;
+
+  dirty->tables |= dirty->writer;
+
+  // The writers walk their tables front to back so most changes touch or extend the previous range
+  if(last && offset <= last->end && offset + len >= last->start)
+  {
+    if(offset < last->start)
+      last->start = offset;
+    if(offset + len > last->end)
+      last->end = offset + len;
+  }
+  else if(dirty->num_ranges < MAX_DIRTY_RANGES)
+  {
+    dirty->ranges[dirty->num_ranges].start = offset;
+    dirty->ranges[dirty->num_ranges].end = offset + len;
+    dirty->num_ranges++;
+  }
+  else
+    dirty->overflow = 1;
 }
 
-void nv_write_masked_segment(struct nvbios *bios, char *str, u_short offset, u_short len, u_char mask)
+// Keep the checksum and the CRCs up to date with a change of len bytes; delta is old ^ new
+static void nv_patch_sums(struct nvbios *bios, u_int offset, const u_char *data, const u_char *delta, u_int len)
 {
-  u_short i;
+  struct rom_dirty *dirty = &bios->dirty;
+  u_int i, size = bios->rom_size < NV_PROM_SIZE ? bios->rom_size : NV_PROM_SIZE;
+
+  // The size byte moves the end of the image, after that only a full pass will do
+  if(offset <= 2 && offset + len > 2 && delta[2-offset])
+  {
+    dirty->sums_valid = 0;
+    return;
+  }
+
+  if(offset < size)
+  {
+    u_int n = offset + len > size ? size - offset : len;
+
+    for(i = 0; i < n; i++)
+      dirty->sum_delta += data[i] - (data[i] ^ delta[i]);
+    dirty->crc_delta ^= crc32_patch(size, offset, delta, n);
+  }
+  dirty->fake_crc_delta ^= crc32_patch(NV_PROM_SIZE, offset, delta, len);
+}
+
+// Store up to 4 bytes; only the span which really changes is written and recorded
+static void nv_write(struct nvbios *bios, u_int offset, const u_char *data, u_int len)
+{
+  u_char delta[4];
+  u_int i, first = len, last = 0;
+
   for(i = 0; i < len; i++)
-    bios->rom[offset+i] = str[i] ^ mask;
+  {
+    delta[i] = bios->rom[offset+i] ^ data[i];
+    if(delta[i])
+    {
+      if(first == len)
+        first = i;
+      last = i;
+    }
+  }
+
+  if(first == len)
+    return;
+
+  if(bios->dirty.sums_valid)
+    nv_patch_sums(bios, offset + first, data + first, delta + first, last - first + 1);
+
+  memcpy(bios->rom + offset + first, data + first, last - first + 1);
+  nv_mark_dirty(bios, offset + first, last - first + 1);
+}
+
+void nv_write8(struct nvbios *bios, u_int offset, u_char value)
+{
+  nv_write(bios, offset, &value, 1);
+}
+
+void nv_write16(struct nvbios *bios, u_int offset, u_short value)
+{
+  u_char data[2] = { value, value >> 8 };
+
+  nv_write(bios, offset, data, 2);
+}
+
+void nv_write32(struct nvbios *bios, u_int offset, u_int value)
+{
+  u_char data[4] = { value, value >> 8, value >> 16, value >> 24 };
+
+  nv_write(bios, offset, data, 4);
+}
+
+/* Same as checksum_bios for a rom which has only been changed through the nv_write* helpers since: the sums are patched
+/  with the changes instead of going over the whole rom again, so this costs time proportional to the edits.
+*/
+void update_checksum(struct nvbios *bios, char fix_checksum)
+{
+  struct rom_dirty *dirty = &bios->dirty;
+  u_int size = bios->rom_size < NV_PROM_SIZE ? bios->rom_size : NV_PROM_SIZE;
+
+  if(!dirty->sums_valid)
+  {
+    checksum_bios(bios, fix_checksum);
+    return;
+  }
+
+  bios->checksum = dirty->sum + dirty->sum_delta;
+
+  if(fix_checksum)
+    nv_write8(bios, size - 1, bios->rom[size-1] - bios->checksum);
+
+  bios->crc ^= dirty->crc_delta;
+  bios->fake_crc ^= dirty->fake_crc_delta;
+
+  dirty->sum += dirty->sum_delta;
+  dirty->sum_delta = 0;
+  dirty->crc_delta = 0;
+  dirty->fake_crc_delta = 0;
 }
 
 // The bios version can be bigger than 4 numbers but it is only stored in a string which is hard to locate?
@@ -194,8 +310,8 @@ void nv40_str_to_bios_version(struct nvbios *bios, char *str, short offset)
 
   sscanf(str, "%02hhX.%02hhX.%02hhX.%02hhX.%02hhX", temp, temp + 1, temp + 2, temp + 3, &extra);
   version = (temp[0] << 24) + (temp[1] << 16) + (temp[2] << 8) + temp[3];
-  bios->rom[offset+4] = extra;
-  *(u_int *)(bios->rom+offset) = WRITE_LE_INT(version);
+  nv_write8(bios, offset + 4, extra);
+  nv_write32(bios, offset, version);
 }
 
 // Parse the GeforceFX performance table
@@ -216,7 +332,7 @@ void nv30_parse_performance_table(struct nvbios *bios, int offset, char rnw)
     bios->active_perf_entries = bios->perf_entries; // TODO: determine if all entries are active on nv30
   }
   else
-    bios->rom[offset+2] = bios->perf_entries;
+    nv_write8(bios, offset + 2, bios->perf_entries);
 
   size = bios->rom[offset+3];
   offset += start + 1;
@@ -226,7 +342,7 @@ void nv30_parse_performance_table(struct nvbios *bios, int offset, char rnw)
   {
     if(i == MAX_PERF_LVLS)
     {
-      fprintf(stderr, "Error: Excess performance table entries (internal maximum: %d)\n", MAX_PERF_LVLS);
+      fprintf(ERR(bios), "Error: Excess performance table entries (internal maximum: %d)\n", MAX_PERF_LVLS);
       break;
     }
 
@@ -251,10 +367,10 @@ void nv30_parse_performance_table(struct nvbios *bios, int offset, char rnw)
     }
     else
     {
-      *(int *)(bios->rom + offset) = WRITE_LE_INT(bios->perf_lst[i].nvclk);
-      *(int *)(bios->rom + offset + 4) = WRITE_LE_INT(bios->perf_lst[i].memclk);
-      bios->rom[offset+54] = bios->perf_lst[i].fanspeed;
-      bios->rom[offset+55] = bios->perf_lst[i].voltage;
+      nv_write32(bios, offset, bios->perf_lst[i].nvclk);
+      nv_write32(bios, offset + 4, bios->perf_lst[i].memclk);
+      nv_write8(bios, offset + 54, bios->perf_lst[i].fanspeed);
+      nv_write8(bios, offset + 55, bios->perf_lst[i].voltage);
     }
 
     offset += size;
@@ -312,18 +428,18 @@ void parse_bit_performance_table(struct nvbios *bios, int offset, char rnw)
     case 0x40:
       // support will eventually be added here
     default:
-      fprintf(stderr, "Error: This performance table version is currently unsupported\n");
+      fprintf(ERR(bios), "Error: This performance table version is currently unsupported\n");
       return;
   }
 
   if(rnw)
     bios->active_perf_entries = header->num_active_entries;
   else
-    header->num_active_entries = bios->active_perf_entries;
+    nv_write8(bios, offset + offsetof(struct BitPerformanceTableHeader, num_active_entries), bios->active_perf_entries);
 
   if(bios->verbose)
     if(bios->active_perf_entries > MAX_PERF_LVLS)
-      fprintf(stderr, "Warning: There seem to be more active performance table entries than internal maximum: %d\n", MAX_PERF_LVLS);
+      fprintf(ERR(bios), "Warning: There seem to be more active performance table entries than internal maximum: %d\n", MAX_PERF_LVLS);
 
   // +5 contains the number of entries, +4 the size of one in bytes and +3 is some 'offset'
   entry_size = header->offset + header->entry_size * header->num_entries;
@@ -336,14 +452,14 @@ void parse_bit_performance_table(struct nvbios *bios, int offset, char rnw)
   {
     if(i == MAX_PERF_LVLS)
     {
-      fprintf(stderr, "Error: Excess performance table entries (internal maximum: %d)\n", MAX_PERF_LVLS);
+      fprintf(ERR(bios), "Error: Excess performance table entries (internal maximum: %d)\n", MAX_PERF_LVLS);
       break;
     }
 
     // This is very unlikely
     if(!rnw  && i == bios->perf_entries)
     {
-      fprintf(stderr, "Error: Excess performance table entries (rom-based maximum: %d)\n", bios->perf_entries);
+      fprintf(ERR(bios), "Error: Excess performance table entries (rom-based maximum: %d)\n", bios->perf_entries);
       break;
     }
 
@@ -351,7 +467,7 @@ void parse_bit_performance_table(struct nvbios *bios, int offset, char rnw)
     // Do the last 4 bits of the first byte tell if an entry is active on 0x35?
     if((header->version < 0x35) && (bios->rom[offset] & 0xf0) != 0x20)
     {
-      fprintf(stderr, "Error: Performance table alignment error\n");
+      fprintf(ERR(bios), "Error: Performance table alignment error\n");
       break;
     }
 
@@ -378,11 +494,11 @@ void parse_bit_performance_table(struct nvbios *bios, int offset, char rnw)
     }
     else
     {
-      bios->rom[offset+fanspeed_offset] = bios->perf_lst[i].fanspeed;
-      bios->rom[offset+voltage_offset] = bios->perf_lst[i].voltage;
+      nv_write8(bios, offset + fanspeed_offset, bios->perf_lst[i].fanspeed);
+      nv_write8(bios, offset + voltage_offset, bios->perf_lst[i].voltage);
 
-      *(u_short *)(bios->rom + offset + nvclk_offset) = WRITE_LE_SHORT(bios->perf_lst[i].nvclk);
-      *(u_short *)(bios->rom + offset + memclk_offset) = WRITE_LE_SHORT(bios->perf_lst[i].memclk);
+      nv_write16(bios, offset + nvclk_offset, bios->perf_lst[i].nvclk);
+      nv_write16(bios, offset + memclk_offset, bios->perf_lst[i].memclk);
 
       // !!! Warning this was signed char *
       // FIXME: need to figure out how to parse delta first
@@ -392,15 +508,12 @@ void parse_bit_performance_table(struct nvbios *bios, int offset, char rnw)
 
       /* Geforce8 cards have a shader clock, further the memory clock is at a different offset as well */
       if(shader_offset)
-        *(u_short *)(bios->rom + offset + shader_offset) = WRITE_LE_SHORT(bios->perf_lst[i].shaderclk);
+        nv_write16(bios, offset + shader_offset, bios->perf_lst[i].shaderclk);
   //   else
   //     bios->perf_lst[i].memclk *= 2;  //FIXME
 
       if(lock_offset)
-      {
-        bios->rom[offset+lock_offset] &= 0xF0;
-        bios->rom[offset+lock_offset] |= bios->perf_lst[i].lock;
-      }
+        nv_write8(bios, offset + lock_offset, (bios->rom[offset+lock_offset] & 0xF0) | bios->perf_lst[i].lock);
     }
 
     i++;
@@ -411,9 +524,9 @@ void parse_bit_performance_table(struct nvbios *bios, int offset, char rnw)
 
   if(rnw)
   {
-    printf("perf table version: %X\n", header->version);
-    printf("active perf entries: %d\n", header->num_active_entries);
-    printf("number of perf entries: %d\n", i);
+    fprintf(LOG(bios), "perf table version: %X\n", header->version);
+    fprintf(LOG(bios), "active perf entries: %d\n", header->num_active_entries);
+    fprintf(LOG(bios), "number of perf entries: %d\n", i);
   }
 }
 
@@ -461,7 +574,7 @@ void parse_bit_temperature_table(struct nvbios *bios, int offset, char rnw)
       case 0x1:
 #if DEBUG
         if(rnw)
-          printf("0x1: (%0x) %d 0x%0x\n", value, (value>>9) & 0x7f, value & 0x3ff);
+          fprintf(LOG(bios), "0x1: (%0x) %d 0x%0x\n", value, (value>>9) & 0x7f, value & 0x3ff);
 #endif
         if(rnw)
           if((value & 0x8f) == 0)
@@ -474,12 +587,11 @@ void parse_bit_temperature_table(struct nvbios *bios, int offset, char rnw)
             if(rnw)
             {
               if(bios->verbose)
-                fprintf(stderr, "Unknown temperature correction\n");
+                fprintf(ERR(bios), "Unknown temperature correction\n");
             }
             else
             {
-              *(u_short *)(bios->rom + offset + 1) &= WRITE_LE_SHORT(~0xe0);
-              *(u_short *)(bios->rom + offset + 1) |= WRITE_LE_SHORT(bios->temp_correction << 9);
+              nv_write16(bios, offset + 1, (READ_LE_SHORT(bios->rom, offset + 1) & ~0xe0) | bios->temp_correction << 9);
               bios->caps &= ~TEMP_CORRECTION;
             }
           }
@@ -493,7 +605,7 @@ void parse_bit_temperature_table(struct nvbios *bios, int offset, char rnw)
             else
             {
               if(bios->verbose)
-                fprintf(stderr, "Unknown temperature correction\n");
+                fprintf(ERR(bios), "Unknown temperature correction\n");
             }
           }
         }
@@ -526,12 +638,11 @@ void parse_bit_temperature_table(struct nvbios *bios, int offset, char rnw)
           if(rnw)
           {
             if(bios->verbose)
-              fprintf(stderr, "Unknown temperature threshold for id  %d\n", id);
+              fprintf(ERR(bios), "Unknown temperature threshold for id  %d\n", id);
           }
           else
           {
-            *(u_short *)(bios->rom + offset + 1) &= WRITE_LE_SHORT(~0x1ff0);
-            *(u_short *)(bios->rom + offset + 1) |= WRITE_LE_SHORT(*int_thld << 4);
+            nv_write16(bios, offset + 1, (READ_LE_SHORT(bios->rom, offset + 1) & ~0x1ff0) | *int_thld << 4);
             bios->caps &= ~thld_caps[0];
           }
         }
@@ -544,8 +655,7 @@ void parse_bit_temperature_table(struct nvbios *bios, int offset, char rnw)
           }
           else
           {
-            *(u_short *)(bios->rom + offset + 1) &= WRITE_LE_SHORT(~0x1ff0);
-            *(u_short *)(bios->rom + offset + 1) |= WRITE_LE_SHORT(*ext_thld << 4);
+            nv_write16(bios, offset + 1, (READ_LE_SHORT(bios->rom, offset + 1) & ~0x1ff0) | *ext_thld << 4);
             bios->caps &= ~thld_caps[1];
           }
         }
@@ -559,7 +669,7 @@ void parse_bit_temperature_table(struct nvbios *bios, int offset, char rnw)
           else
           {
             if(bios->verbose)
-              fprintf(stderr, "Unknown temperature threshold for id  %d\n", id);
+              fprintf(ERR(bios), "Unknown temperature threshold for id  %d\n", id);
           }
         }
         break;
@@ -582,7 +692,7 @@ void parse_bit_temperature_table(struct nvbios *bios, int offset, char rnw)
 #if DEBUG
       default:
         if(rnw)
-          printf("0x%x: %x\n", id, value);
+          fprintf(LOG(bios), "0x%x: %x\n", id, value);
 #endif
     }
     offset += header->entry_size;
@@ -593,10 +703,10 @@ void parse_bit_temperature_table(struct nvbios *bios, int offset, char rnw)
 
   if(rnw)
   {
-    printf("temperature table version: %#x\n", header->version);
-    printf("correction: %d\n", bios->sensor_cfg.temp_correction);
-    printf("offset: %.3f\n", (float)bios->sensor_cfg.diode_offset_mult / (float)bios->sensor_cfg.diode_offset_div);
-    printf("slope: %.3f\n", (float)bios->sensor_cfg.slope_mult / (float)bios->sensor_cfg.slope_div);
+    fprintf(LOG(bios), "temperature table version: %#x\n", header->version);
+    fprintf(LOG(bios), "correction: %d\n", bios->sensor_cfg.temp_correction);
+    fprintf(LOG(bios), "offset: %.3f\n", (float)bios->sensor_cfg.diode_offset_mult / (float)bios->sensor_cfg.diode_offset_div);
+    fprintf(LOG(bios), "slope: %.3f\n", (float)bios->sensor_cfg.slope_mult / (float)bios->sensor_cfg.slope_div);
   }
 }
 
@@ -644,7 +754,7 @@ void parse_voltage_table(struct nvbios *bios, int offset, char rnw)
       break;
     case 0x40:
     default:
-      printf("Currently unsupported voltage table version\n");
+      fprintf(LOG(bios), "Currently unsupported voltage table version\n");
       return;
   }
 
@@ -654,17 +764,17 @@ void parse_voltage_table(struct nvbios *bios, int offset, char rnw)
     bios->active_volt_entries = bios->rom[offset+active_offset];
   }
   else
-    bios->rom[offset+active_offset] = bios->active_volt_entries;
+    nv_write8(bios, offset + active_offset, bios->active_volt_entries);
 
   if(rnw)
   {
-    printf("voltage table version: %X\n", bios->rom[offset]);
-    printf("number of volt entries: %d\n", bios->volt_entries);
+    fprintf(LOG(bios), "voltage table version: %X\n", bios->rom[offset]);
+    fprintf(LOG(bios), "number of volt entries: %d\n", bios->volt_entries);
   }
 
   if(bios->verbose)
     if(bios->active_volt_entries > MAX_VOLT_LVLS)
-      fprintf(stderr, "Warning: There seem to be more active voltage table entries than internal maximum: %d\n", MAX_VOLT_LVLS);
+      fprintf(ERR(bios), "Warning: There seem to be more active voltage table entries than internal maximum: %d\n", MAX_VOLT_LVLS);
 
   offset += start;
   i = 0;
@@ -672,7 +782,7 @@ void parse_voltage_table(struct nvbios *bios, int offset, char rnw)
   {
     if(i == MAX_VOLT_LVLS)
     {
-      fprintf(stderr, "Error: Excess voltage table entries (internal maximum: %d)\n", MAX_VOLT_LVLS);
+      fprintf(ERR(bios), "Error: Excess voltage table entries (internal maximum: %d)\n", MAX_VOLT_LVLS);
       break;
     }
 
@@ -683,8 +793,8 @@ void parse_voltage_table(struct nvbios *bios, int offset, char rnw)
     }
     else
     {
-      bios->rom[offset] = bios->volt_lst[i].voltage;
-      bios->rom[offset+1] = bios->volt_lst[i].VID;
+      nv_write8(bios, offset, bios->volt_lst[i].voltage);
+      nv_write8(bios, offset + 1, bios->volt_lst[i].VID);
     }
 
     i++;
@@ -702,7 +812,7 @@ void parse_string_table(struct nvbios *bios, int offset, int length, char rnw)
 
   if(length != 0x15)
   {
-    fprintf(stderr, "Error: Unknown String Table\n");
+    fprintf(ERR(bios), "Error: Unknown String Table\n");
     return;
   }
 
@@ -713,61 +823,51 @@ void parse_string_table(struct nvbios *bios, int offset, int length, char rnw)
   else
     off = READ_LE_SHORT(bios->rom, offset + 0x12) + bios->rom[offset+0x14];
 
-  if(rnw)
-    nv_read_masked_segment(bios, bios->str[7], off, 0x2E, 0xFF);
-  else
-    nv_write_masked_segment(bios, bios->str[7], off, 0x2E, 0xFF);
+  if(!rnw)
+    return;
+
+  nv_read_masked_segment(bios, &bios->str[7], off, 0x2E, 0xFF);
 
   for(i = 0; i < 7; i++)
   {
     off = READ_LE_SHORT(bios->rom, offset);
     len = bios->rom[offset+2];
 
-    if(rnw)
-      nv_read_segment(bios, bios->str[i], off, len);
-    else
-      nv_write_segment(bios, bios->str[i], off, len);
+    nv_read_segment(bios, &bios->str[i], off, len);
 
     offset += 3;
   }
 }
 
+/* The BMP parsers only locate the tables; they are decoded by parse_tables */
 void nv5_parse(struct nvbios *bios, u_short nv_offset, char rnw)
 {
-  /* Go to the position containing the offset to the card name, it is 30 away from NV. */
-  int offset = READ_LE_SHORT(bios->rom, nv_offset + 30);
+  if(!rnw)
+    return;
 
-  if(rnw)
-    nv_read(bios, bios->str[0], offset);
-  else
-    nv_write(bios, bios->str[0], offset);
+  /* Go to the position containing the offset to the card name, it is 30 away from NV. */
+  bios->tables.strings = READ_LE_SHORT(bios->rom, nv_offset + 30);
+  bios->tables.present = TABLE_STRINGS;
 }
 
 void nv30_parse(struct nvbios *bios, u_short nv_offset, char rnw)
 {
   u_short init_offset = 0;
-  u_short perf_offset=0;
-  u_short volt_offset=0;
 
-  int offset = READ_LE_SHORT(bios->rom, nv_offset + 30);
+  if(!rnw)
+    return;
 
-  if(rnw)
-    nv_read(bios, bios->str[0],offset);
-  else
-    nv_write(bios, bios->str[0],offset);
+  bios->tables.strings = READ_LE_SHORT(bios->rom, nv_offset + 30);
 
   init_offset = READ_LE_SHORT(bios->rom, nv_offset + 0x4d);
 
-  volt_offset = READ_LE_SHORT(bios->rom, nv_offset + 0x98);
-  parse_voltage_table(bios, volt_offset, rnw);
-
-  perf_offset = READ_LE_SHORT(bios->rom, nv_offset + 0x94);
-  nv30_parse_performance_table(bios, perf_offset, rnw);
+  bios->tables.volt = READ_LE_SHORT(bios->rom, nv_offset + 0x98);
+  bios->tables.perf = READ_LE_SHORT(bios->rom, nv_offset + 0x94);
+  bios->tables.present = TABLE_STRINGS | TABLE_VOLT | TABLE_PERF;
 }
 
 void parse_bit_structure(struct nvbios *bios, u_int bit_offset, char rnw)
 {
-  u_short offset;
   u_short entry_length, entry_offset;
   u_short bit_table_version = 0;
 
@@ -786,9 +886,9 @@ void parse_bit_structure(struct nvbios *bios, u_int bit_offset, char rnw)
         if(bios->verbose)
         {
           if(entry_length == 0x060C)
-            printf("BIT table version : %X.%X%02X\n", (entry_offset & 0x00F0) >> 4, entry_offset & 0x000F, (entry_offset & 0xFF00) >> 8);
+            fprintf(LOG(bios), "BIT table version : %X.%X%02X\n", (entry_offset & 0x00F0) >> 4, entry_offset & 0x000F, (entry_offset & 0xFF00) >> 8);
           else  // unknown because entry size isn't 0x6 and start isn't 0xC away
-            fprintf(stderr, "Warning: Unknown BIT table\n");
+            fprintf(ERR(bios), "Warning: Unknown BIT table\n");
         }
 
         bit_table_version = entry_offset;
@@ -805,65 +905,87 @@ void parse_bit_structure(struct nvbios *bios, u_int bit_offset, char rnw)
         else
         {
           nv40_str_to_bios_version(bios, bios->version[0], entry_offset);
-          *(u_short *)(bios->rom + entry_offset + 0x0a) = WRITE_LE_SHORT(bios->text_time);
+          nv_write16(bios, entry_offset + 0x0a, bios->text_time);
         }
         break;
       case 'C': // Configuration table; it contains at least PLL parameters
-        offset = READ_LE_SHORT(bios->rom, entry_offset + 0x8);
-        //if(rnw)
-        //  parse_bit_pll_table(bios, offset); //this function can only read
+        if(rnw && entry_length >= 0x0a && entry_offset + 0x0aU <= bios->rom_size)
+        {
+          bios->tables.pll = READ_LE_SHORT(bios->rom, entry_offset + 0x08);
+          if(bios->tables.pll)
+            bios->tables.present |= TABLE_PLL;
+        }
         break;
-      case 'I': // Init table
-        offset = READ_LE_SHORT(bios->rom, entry_offset);
-        //if(rnw)
-        //  parse_bit_init_script_table(bios, offset, entry_length); //this function can only read
+      case 'I': // Init table; the scripts are decoded on demand by parse_init_scripts
+        if(rnw)
+        {
+          bios->tables.init = entry_offset;
+          bios->tables.init_len = entry_length;
+        }
+        break;
+      case 'M': // Memory table; some init opcodes have an entry for each memory configuration
+        if(rnw)
+        {
+          if(entry->id[1] == 1 && entry_length >= 5)
+          {
+            bios->tables.ram_cfgs = bios->rom[entry_offset+2];
+            bios->tables.ram_restrict = READ_LE_SHORT(bios->rom, entry_offset+3);
+          }
+          else if(entry->id[1] == 2 && entry_length >= 3)
+          {
+            bios->tables.ram_cfgs = bios->rom[entry_offset];
+            bios->tables.ram_restrict = READ_LE_SHORT(bios->rom, entry_offset+1);
+          }
+        }
         break;
       case 'P': // Performance table, Temperature table, and Voltage table
         // NOTE: Make sure perf table has not moved in version 0x4413.  This would affect perf & temp table versions
         // NOTE: Why is Fermi 0x4512?
         // TODO: dont use version, use arch?
         // TODO: test the rebranded G96's
-        offset = READ_LE_SHORT(bios->rom, entry_offset);
-        parse_bit_performance_table(bios, offset, rnw);
+        if(!rnw)
+          break;
+
+        bios->tables.perf = READ_LE_SHORT(bios->rom, entry_offset);
 
         // test: again not sure yet
         // NOTE: I need to change the GT200 perf40 arch's so this doesnt look so hacky
         // NOTE: One test that always works so far is if perf_table_version == 0x40
         if(bios->arch & (GF100 | UNKNOWN) || bit_table_version == 0x4413)
         {
-          offset = READ_LE_SHORT(bios->rom, entry_offset + 0x0c);
-          parse_voltage_table(bios,offset, rnw);
-
+          bios->tables.volt = READ_LE_SHORT(bios->rom, entry_offset + 0x0c);
           // test: not sure this is correct
-          offset = READ_LE_SHORT(bios->rom, entry_offset + 0x10); // potential offsets: 0x4, 0x8, 0x10, 0x18
-          parse_bit_temperature_table(bios, offset, rnw);
+          bios->tables.temp = READ_LE_SHORT(bios->rom, entry_offset + 0x10); // potential offsets: 0x4, 0x8, 0x10, 0x18
+          bios->tables.volt_first = 1;
         }
         else
         {
-          offset = READ_LE_SHORT(bios->rom, entry_offset + 0x0c);
-          parse_bit_temperature_table(bios, offset, rnw);
-
-          offset = READ_LE_SHORT(bios->rom, entry_offset + 0x10);
-          parse_voltage_table(bios, offset, rnw);
+          bios->tables.temp = READ_LE_SHORT(bios->rom, entry_offset + 0x0c);
+          bios->tables.volt = READ_LE_SHORT(bios->rom, entry_offset + 0x10);
         }
+        bios->tables.present |= TABLE_PERF | TABLE_VOLT | TABLE_TEMP;
         break;
       case 'S': // table with string references
-        parse_string_table(bios, entry_offset, entry_length, rnw);
+        if(rnw)
+        {
+          bios->tables.strings = entry_offset;
+          bios->tables.strings_len = entry_length;
+          bios->tables.present |= TABLE_STRINGS;
+        }
         break;
       case 'i': // bios version(2), bios build date, board id, hierarchy id
         if(rnw)
         {
           nv40_bios_version_to_str(bios, bios->version[1], entry_offset);
           bios->board_id = READ_LE_SHORT(bios->rom, entry_offset + 0x0b);
-          nv_read_segment(bios, bios->build_date,entry_offset + 0x0f, 8);
+          nv_read_segment(bios, &bios->build_date, entry_offset + 0x0f, 8);
           bios->hierarchy_id = bios->rom[entry_offset+0x24];
         }
         else
         {
           nv40_str_to_bios_version(bios, bios->version[1], entry_offset);
-          *(u_short *)(bios->rom + entry_offset + 0x0b) = WRITE_LE_SHORT(bios->board_id);
-          nv_write_segment(bios, bios->build_date,entry_offset + 0x0f, 8);
-          bios->rom[entry_offset+0x24] = bios->hierarchy_id;
+          nv_write16(bios, entry_offset + 0x0b, bios->board_id);
+          nv_write8(bios, entry_offset + 0x24, bios->hierarchy_id);
         }
         break;
     }
@@ -871,41 +993,176 @@ void parse_bit_structure(struct nvbios *bios, u_int bit_offset, char rnw)
   }
 }
 
+// Decode (rnw) or write back one of the tables located by parse_bios
+static void parse_table(struct nvbios *bios, u_int table, char rnw)
+{
+  struct rom_tables *t = &bios->tables;
+
+  if(!rnw)
+    bios->dirty.writer = table;
+
+  switch(table)
+  {
+    case TABLE_PERF:
+      if(bios->arch <= NV3X)
+        nv30_parse_performance_table(bios, t->perf, rnw);
+      else
+        parse_bit_performance_table(bios, t->perf, rnw);
+      break;
+    case TABLE_VOLT:
+      parse_voltage_table(bios, t->volt, rnw);
+      break;
+    case TABLE_TEMP:
+      parse_bit_temperature_table(bios, t->temp, rnw);
+      break;
+    case TABLE_STRINGS:
+      if(bios->arch > NV3X)
+        parse_string_table(bios, t->strings, t->strings_len, rnw);
+      else if(rnw)
+        nv_read(bios, &bios->str[0], t->strings);
+      break;
+    case TABLE_PLL:
+      parse_bit_pll_table(bios, t->pll, rnw);
+      break;
+  }
+}
+
+/* The struct nvbios fields each table is decoded into; used to find and verify edits */
+#define TABLE_FIELDS(table, first, next) { table, offsetof(struct nvbios, first), offsetof(struct nvbios, next) }
+
+static const struct table_fields
+{
+  u_int table;
+  size_t start;
+  size_t end;
+} table_fields[] =
+{
+  TABLE_FIELDS(TABLE_HEADER, arch, index),
+  TABLE_FIELDS(TABLE_HEADER, subven_id, str),
+  TABLE_FIELDS(TABLE_HEADER, version, temp_table_version),
+  TABLE_FIELDS(TABLE_STRINGS, str, version),
+  TABLE_FIELDS(TABLE_TEMP, caps, no_correct_checksum),
+  TABLE_FIELDS(TABLE_TEMP, temp_table_version, volt_table_version),
+  TABLE_FIELDS(TABLE_TEMP, sensor_cfg, mpll),
+  TABLE_FIELDS(TABLE_VOLT, volt_table_version, perf_table_version),
+  TABLE_FIELDS(TABLE_PERF, perf_table_version, pll_entries),
+  TABLE_FIELDS(TABLE_PLL, pll_entries, pll_lst),
+};
+
+enum { NUM_TABLE_FIELDS = sizeof(table_fields) / sizeof(table_fields[0]) };
+
+static u_int table_fields_crc(const struct nvbios *bios, u_int table)
+{
+  u_int i, crc = 0;
+
+  for(i = 0; i < NUM_TABLE_FIELDS; i++)
+    if(table_fields[i].table == table)
+      crc = crc32_fast(crc, (const u_char *)bios + table_fields[i].start, table_fields[i].end - table_fields[i].start);
+
+  // The PLL limits live out of line
+  if(table == TABLE_PLL && bios->pll_lst)
+    crc = crc32_fast(crc, (const u_char *)bios->pll_lst, bios->pll_entries * sizeof(struct pll));
+  return crc;
+}
+
+// Remember the decoded state of a table so edits to its fields can be detected
+static void table_fields_decoded(struct nvbios *bios, u_int table)
+{
+  bios->tables.fields_crc[__builtin_ctz(table)] = table_fields_crc(bios, table);
+}
+
+// Every reader expects to start from a cleared struct
+static void clear_table_fields(struct nvbios *bios, u_int table)
+{
+  u_int i;
+
+  for(i = 0; i < NUM_TABLE_FIELDS; i++)
+    if(table_fields[i].table == table)
+      memset((u_char *)bios + table_fields[i].start, 0, table_fields[i].end - table_fields[i].start);
+
+  // Only verify_edits clears fields, on a copy which shares the PLL list with the bios it was made from
+  if(table == TABLE_PLL)
+    bios->pll_lst = NULL;
+}
+
+static int compare_table_fields(const struct nvbios *a, const struct nvbios *b, u_int table)
+{
+  u_int i;
+
+  for(i = 0; i < NUM_TABLE_FIELDS; i++)
+    if(table_fields[i].table == table && memcmp((const u_char *)a + table_fields[i].start, (const u_char *)b + table_fields[i].start, table_fields[i].end - table_fields[i].start))
+      return 0;
+
+  if(table == TABLE_PLL && a->pll_entries && memcmp(a->pll_lst, b->pll_lst, a->pll_entries * sizeof(struct pll)))
+    return 0;
+  return 1;
+}
+
+/* Decode the requested tables (TABLE_* flags) which haven't been decoded yet. parse_bios only locates the tables
+/  so queries which just need the ids, names or the CRC never touch them. Returns 0 if one of them is not in the rom.
+*/
+int parse_tables(struct nvbios *bios, u_int tables)
+{
+  // Decode in rom order so the diagnostics come out in a stable order
+  static const u_int bmp_order[] = { TABLE_STRINGS, TABLE_VOLT, TABLE_PERF, TABLE_TEMP, TABLE_PLL };
+  static const u_int bit_order[] = { TABLE_PERF, TABLE_TEMP, TABLE_VOLT, TABLE_STRINGS, TABLE_PLL };
+  static const u_int bit_volt_order[] = { TABLE_PERF, TABLE_VOLT, TABLE_TEMP, TABLE_STRINGS, TABLE_PLL };
+  const u_int *order;
+  u_int i;
+
+  if(bios->arch <= NV3X)
+    order = bmp_order;
+  else
+    order = bios->tables.volt_first ? bit_volt_order : bit_order;
+
+  for(i = 0; i < NUM_TABLES - 1; i++)
+  {
+    if(!(tables & order[i] & bios->tables.present & ~bios->tables.parsed))
+      continue;
+
+    parse_table(bios, order[i], 1);
+    bios->tables.parsed |= order[i];
+    table_fields_decoded(bios, order[i]);
+  }
+
+  return (bios->tables.present & tables) == tables;
+}
+
 int parse_bios(struct nvbios *bios, char rnw)
 {
   u_short bit_offset;
   u_short nv_offset;
   u_short pcir_offset;
-
-  u_char pcir_tag[5] = "PCIR";
-  u_char nv_tag[5] = "\xFF\x7FNV";
-  u_char bit_tag[4] = "BIT";
+  u_int i;
 
   // TODO: ? Maybe I should remove the arch unknown tests since its really just based on table versions
 
   // Does pcir_offset + 20 == 1 indicate BMP?
   if(rnw)
   {
+    // A freshly loaded rom; forget the tables of the previous one
+    memset(&bios->tables, 0, sizeof(struct rom_tables));
+
     bios->subven_id = READ_LE_SHORT(bios->rom, 0x54);
     bios->subsys_id = READ_LE_SHORT(bios->rom, 0x56);
-    nv_read_segment(bios, bios->mod_date, 0x38, 8);
+    nv_read_segment(bios, &bios->mod_date, 0x38, 8);
 
-    pcir_offset = locate_segment(bios, pcir_tag, 0, 4);
+    pcir_offset = bios->index.pcir;
 
     bios->device_id = READ_LE_SHORT(bios->rom, pcir_offset + 6);
-    get_card_name(bios->device_id, bios->adapter_name);
+    bios->adapter_name = get_card_name(bios->device_id);
     bios->arch = get_gpu_arch(bios->device_id);
-    get_subvendor_name(bios->subven_id, bios->vendor_name);
+    bios->vendor_name = get_subvendor_name(bios->subven_id);
 
     if(bios->arch & UNKNOWN)
-      fprintf(stderr, "Warning: attempting to parse unknown architecture.\n");
+      fprintf(ERR(bios), "Warning: attempting to parse unknown architecture.\n");
 
     /* We are dealing with a card that only contains the BMP structure */
     if(bios->arch <= NV3X)
     {
       int version;
       /* The main offset starts with "0xff 0x7f NV" */
-      nv_offset = locate_segment(bios, nv_tag, 0, 4);
+      nv_offset = bios->index.nv;
 
       bios->major = bios->rom[nv_offset+5];
       bios->minor = bios->rom[nv_offset+6];
@@ -923,25 +1180,28 @@ int parse_bios(struct nvbios *bios, char rnw)
     else  // use newest methods on unknown architectures
     {
       /* For NV40 card the BIT structure is used instead of the BMP structure (last one doesn't exist anymore on 6600/6800le cards). */
-      bit_offset = locate_segment(bios, bit_tag, 0, 3);
+      bit_offset = bios->index.bit;
 
       parse_bit_structure(bios, bit_offset, rnw);
     }
+
+    table_fields_decoded(bios, TABLE_HEADER);
   }
   else
   {
-    *(u_short *)(bios->rom + 0x54) = WRITE_LE_SHORT(bios->subven_id);
-    *(u_short *)(bios->rom + 0x56) = WRITE_LE_SHORT(bios->subsys_id);
-    nv_write_segment(bios, bios->mod_date, 0x38, 8);
+    bios->dirty.writer = TABLE_HEADER;
 
-    pcir_offset = locate_segment(bios, pcir_tag, 0, 4);
+    nv_write16(bios, 0x54, bios->subven_id);
+    nv_write16(bios, 0x56, bios->subsys_id);
 
-    *(u_short *)(bios->rom + pcir_offset + 6) = WRITE_LE_SHORT(bios->device_id);
+    pcir_offset = bios->index.pcir;
+
+    nv_write16(bios, pcir_offset + 6, bios->device_id);
 
     if(bios->arch & UNKNOWN && !bios->force)
     {
-      printf("Error: Bios writing is unsupported on UNKNOWN architectures.\n");
-      printf("       Use -f or --force if you are sure you know what you are doing\n");
+      fprintf(LOG(bios), "Error: Bios writing is unsupported on UNKNOWN architectures.\n");
+      fprintf(LOG(bios), "       Use -f or --force if you are sure you know what you are doing\n");
       return 0;
     }
 
@@ -949,12 +1209,12 @@ int parse_bios(struct nvbios *bios, char rnw)
     if(bios->arch <= NV3X)
     {
       // The main offset starts with "0xff 0x7f NV"
-      nv_offset = locate_segment(bios, nv_tag, 0, 4);
+      nv_offset = bios->index.nv;
 
       // Go to the bios version
       // Not perfect for bioses containing 5 numbers
       int version = str_to_bios_version(bios->version[0]);
-      *(u_int *)(bios->rom + nv_offset + 10) = WRITE_LE_INT(version);
+      nv_write32(bios, nv_offset + 10, version);
 
       if(bios->arch & NV3X)
         nv30_parse(bios, nv_offset, rnw);
@@ -963,21 +1223,22 @@ int parse_bios(struct nvbios *bios, char rnw)
     }
     else  // use newest methods on unknown architectures
     {
-      bit_offset = locate_segment(bios, bit_tag, 0, 3);
+      bit_offset = bios->index.bit;
 
       parse_bit_structure(bios, bit_offset, rnw);
     }
 
-    // Recompute checksum for filesaves and CRC for user viewing purposes only
-    u_int i;
-    for(i = 0, bios->checksum = 0; i < bios->rom_size; i++)
-      bios->checksum = bios->checksum + bios->rom[i];
+    // Only the decoded tables can have been edited
+    for(i = TABLE_PERF; i & TABLE_ALL; i <<= 1)
+      if(bios->tables.parsed & i)
+        parse_table(bios, i, rnw);
+    bios->dirty.writer = 0;
 
-    if(!bios->no_correct_checksum)
-      bios->rom[bios->rom_size-1] = bios->rom[bios->rom_size-1] - bios->checksum;
+    // Recompute checksum for filesaves and CRC for user viewing purposes only
+    update_checksum(bios, !bios->no_correct_checksum);
 
-    bios->crc = CRC(0, bios->rom, bios->rom_size);
-    bios->fake_crc = CRC(0, bios->rom, NV_PROM_SIZE);
+    // The edits might have moved or overwritten a signature
+    index_bios(bios);
 
     if(!verify_bios(bios))
       return 0;
@@ -1002,20 +1263,158 @@ u_int locate_segment(struct nvbios *bios, u_char *str, u_short offset, u_short l
 // dynamic mask
 u_int locate_masked_segment(struct nvbios *bios, u_char *str, u_char *mask, u_short offset, u_short len)
 {
-  u_int i,j;
+  u_int match;
 
-  if(!len)
+  if(locate_masked_segments(bios, str, mask, offset, len, &match, 1))
+    return match;
+  return 0;
+}
+
+// Find up to max_matches occurrences at once; returns the number of matches found
+u_int locate_masked_segments(struct nvbios *bios, u_char *str, u_char *mask, u_short offset, u_short len, u_int *matches, u_int max_matches)
+{
+  u_int i, n;
+
+  if(offset >= bios->rom_size)
     return 0;
 
-  for(i = offset; i <= bios->rom_size - len; i++)
+  n = masked_search(bios->rom + offset, bios->rom_size - offset, str, mask, len, matches, max_matches);
+  for(i = 0; i < n; i++)
+    matches[i] += offset;
+
+  return n;
+}
+
+/* The rom lives in its own window of NV_PROM_SIZE bytes followed by a page of zeros, so a sloppy offset near the end still reads zeros.
+/  A file is mapped privately over the start of the window: it is parsed straight from the page cache and a page is only copied when an edit writes to it.
+/  Without a file (fd < 0) the window is plain zeroed memory for the loaders that copy the rom from the card.
+*/
+static int map_rom(struct nvbios *bios, int fd, u_int size)
+{
+  u_char *rom;
+
+  if(bios->rom)
+    munmap(bios->rom, ROM_WINDOW_SIZE);
+  bios->rom = NULL;
+
+  rom = mmap(NULL, ROM_WINDOW_SIZE, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+  if(rom == MAP_FAILED)
+    return 0;
+
+  if(fd >= 0 && mmap(rom, size, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_FIXED, fd, 0) == MAP_FAILED)
+  {
+    munmap(rom, ROM_WINDOW_SIZE);
+    return 0;
+  }
+
+  bios->rom = rom;
+  return 1;
+}
+
+// Replace a file mapping by a copy of its own so the bios no longer depends on the file (which might be about to be overwritten)
+static int unshare_rom(struct nvbios *bios)
+{
+  u_char *rom = bios->rom;
+
+  bios->rom = NULL;
+  if(!map_rom(bios, -1, 0))
+  {
+    bios->rom = rom;
+    return 0;
+  }
+
+  memcpy(bios->rom, rom, NV_PROM_SIZE);
+  munmap(rom, ROM_WINDOW_SIZE);
+  return 1;
+}
+
+// Release the rom window and the tables parsed out of line; the bios can be loaded again afterwards
+void free_bios(struct nvbios *bios)
+{
+  if(bios->rom)
+    munmap(bios->rom, ROM_WINDOW_SIZE);
+  bios->rom = NULL;
+
+  free(bios->pll_lst);
+  bios->pll_lst = NULL;
+  bios->pll_entries = 0;
+
+  free_init_ir(bios);
+}
+
+/* Record the offsets of all signatures we are interested in using a single pass over the rom.
+/  Like locate_segment only the first occurrence is recorded and 0 means the signature wasn't found.
+/  This has to be redone after anything changed the rom.
+*/
+void index_bios(struct nvbios *bios)
+{
+  struct rom_index *index = &bios->index;
+  const u_char *rom = bios->rom;
+  u_int i, size = bios->rom_size;
+
+  memset(index, 0, sizeof(struct rom_index));
+
+  if(size < 3)
+    return;
+
+  for(i = 0; i <= size - 3; i++)
   {
-    for(j = 0; j < len; j++)
-      if((bios->rom[i+j] & mask[j]) != (str[j] & mask[j]))
+    switch(rom[i])
+    {
+      case 'P':
+        if(!index->pcir && i + 4 <= size && !memcmp(rom + i, "PCIR", 4))
+          index->pcir = i;
         break;
-    if(j == len)
-      return i;
+      case 'N':
+        if(!index->npde && i + 4 <= size && !memcmp(rom + i, "NPDE", 4))
+          index->npde = i;
+        break;
+      case 'B':
+        if(!index->bit && rom[i+1] == 'I' && rom[i+2] == 'T')
+          index->bit = i;
+        break;
+      case 0xFF:
+        if(!index->nv && i + 4 <= size && !memcmp(rom + i, "\xFF\x7FNV", 4))
+          index->nv = i;
+        break;
+      case 0x55: // every image in the rom starts with 0x55 0xAA on a 512 byte boundary
+        if(!(i & 0x1ff) && rom[i+1] == 0xAA && index->num_images < MAX_ROM_IMAGES)
+          index->images[index->num_images++] = i;
+        break;
+    }
   }
-  return 0;
+}
+
+/* Compute the 8 bit checksum over rom_size, the CRC over rom_size and the fake CRC over NV_PROM_SIZE in a single pass.
+/  With fix_checksum set the last byte of the image is corrected so the checksum becomes zero; bios->checksum keeps the value from before the fix.
+*/
+void checksum_bios(struct nvbios *bios, char fix_checksum)
+{
+  u_int size = bios->rom_size < NV_PROM_SIZE ? bios->rom_size : NV_PROM_SIZE;
+  u_char sum = 0;
+
+  bios->crc = 0;
+  if(size)
+  {
+    bios->crc = CRC_SUM8(0, bios->rom, size - 1, &sum);
+    bios->checksum = sum + bios->rom[size-1];
+
+    if(fix_checksum)
+      bios->rom[size-1] = bios->rom[size-1] - bios->checksum;
+
+    bios->crc = CRC(bios->crc, bios->rom + size - 1, 1);
+  }
+  else
+    bios->checksum = 0;
+
+  bios->fake_crc = CRC(bios->crc, bios->rom + size, NV_PROM_SIZE - size);
+
+  // From here on the nv_write* helpers keep the sums up to date
+  bios->dirty.sums_valid = size > 0;
+  bios->dirty.sum = fix_checksum ? 0 : bios->checksum;
+  bios->dirty.sum_delta = 0;
+  bios->dirty.crc_delta = 0;
+  bios->dirty.fake_crc_delta = 0;
 }
 
 // Determine actual rom size
@@ -1026,8 +1425,6 @@ u_int get_rom_size(struct nvbios *bios)
 
 #if DEBUG
 
-NVCard *nv_card;
-
 int main(int argc, char **argv)
 {
   struct nvbios bios, bios_cpy;
@@ -1042,10 +1439,12 @@ int main(int argc, char **argv)
 
   bios_cpy = bios;
   write_bios(&bios, "debug.rom");
+  bios_cpy.rom = bios.rom; // write_bios gives the bios its own copy of the rom
 
   if(memcmp(&bios, &bios_cpy, sizeof(struct nvbios)))
     printf("Write bios critical error\n");
 
+  free_bios(&bios);
   return 0;
 }
 
@@ -1062,7 +1461,7 @@ int verify_bios(struct nvbios *bios)
   // Signature test: All bioses start with this '0x55 0xAA'
   if((bios->rom[0] != 0x55) || (bios->rom[1] != 0xAA))
   {
-    printf("Error: ROM signature failure\n");
+    fprintf(LOG(bios), "Error: ROM signature failure\n");
     return 0;
   }
 
@@ -1070,7 +1469,7 @@ int verify_bios(struct nvbios *bios)
   // The reason we are doing this check is that we mmap NV_PROM_SIZE and use it as the max size in a few places
   if(bios->rom_size > NV_PROM_SIZE)
   {
-    printf("Error: This rom is too big\n");
+    fprintf(LOG(bios), "Error: This rom is too big\n");
     return 0;
   }
 
@@ -1080,15 +1479,14 @@ int verify_bios(struct nvbios *bios)
   offset_based_size = READ_LE_SHORT(bios->rom, size_offset);
   if(index_based_size != offset_based_size)
   {
-    printf("Error: Rom size validation failure\n");
+    fprintf(LOG(bios), "Error: Rom size validation failure\n");
     return 0;
   }
 
   // PCIR tag test
-  u_char pcir_tag[5] = "PCIR";
-  if(!(pcir_offset = locate_segment(bios, pcir_tag, 0, 4)))
+  if(!(pcir_offset = bios->index.pcir))
   {
-    printf("Error: Could not find \"PCIR\" string\n");
+    fprintf(LOG(bios), "Error: Could not find \"PCIR\" string\n");
     return 0;
   }
 
@@ -1097,7 +1495,7 @@ int verify_bios(struct nvbios *bios)
   // Fail if the bios is not from an Nvidia card
   if(READ_LE_SHORT(bios->rom, pcir_offset + 4) != 0x10de)
   {
-    printf("Error: Could not find Nvidia signature\n");
+    fprintf(LOG(bios), "Error: Could not find Nvidia signature\n");
     return 0;
   }
 
@@ -1105,10 +1503,9 @@ int verify_bios(struct nvbios *bios)
   if(get_gpu_arch(device_id) & (NV5 | NV1X | NV2X | NV3X))
   {
     /* The main offset starts with "0xff 0x7f N V" */
-    u_char nv_tag[5] = "\xFF\x7FNV";
-    if(!(nv_offset = locate_segment(bios, nv_tag, 0, 4)))
+    if(!(nv_offset = bios->index.nv))
     {
-      printf("Error: Could not find \"FF7FNV\" string\n");
+      fprintf(LOG(bios), "Error: Could not find \"FF7FNV\" string\n");
       return 0;
     }
 
@@ -1116,17 +1513,16 @@ int verify_bios(struct nvbios *bios)
     // !!! Warning this was signed char *
     if(bios->rom[nv_offset+5] < 5)
     {
-      printf("Error: This card/rom is too old\n");
+      fprintf(LOG(bios), "Error: This card/rom is too old\n");
       return 0;
     }
   }
   else
   {
   // For NV40 card the BIT structure is used instead of the BMP structure (last one doesn't exist anymore on 6600/6800le cards).
-    u_char bit_tag[4] = "BIT";
-    if(!locate_segment(bios, bit_tag, pcir_offset, 3))
+    if(!bios->index.bit)
     {
-      printf("Error: Could not find \"BIT\" string\n");
+      fprintf(LOG(bios), "Error: Could not find \"BIT\" string\n");
       return 0;
     }
   }
@@ -1136,14 +1532,23 @@ int verify_bios(struct nvbios *bios)
 
 int read_bios(struct nvbios *bios, const char *filename)
 {
-  int (*load_bios[2])(struct nvbios *) = { &load_bios_prom, &load_bios_pramin };
-  int i = bios->pramin_priority; //this is either 0 or 1
+  // sysfs is the fastest and safest source so it always goes first
+  int (*load_bios[3])(struct nvbios *) = { &load_bios_sysfs, &load_bios_prom, &load_bios_pramin };
+  u_int i;
 
   if(!bios)
     return 0;
 
+  bios->filename = filename;
+
+  if(bios->pramin_priority)
+  {
+    load_bios[1] = &load_bios_pramin;
+    load_bios[2] = &load_bios_prom;
+  }
+
   if(bios->verbose)
-    printf("------------------------------------\n%s\n------------------------------------\n", __func__);
+    fprintf(LOG(bios), "------------------------------------\n%s\n------------------------------------\n", __func__);
 
   // TODO: Compare opcodes/data in pramin roms to see what has changed
   // Loading from PROM might fail on laptops as sometimes GPU BIOS is hidden in the System BIOS?
@@ -1156,90 +1561,247 @@ int read_bios(struct nvbios *bios, const char *filename)
   }
   else
   {
-    if(!(*load_bios[i])(bios)) //either prom or pramin read
+    // The registers are only mapped once the rom can't be read through sysfs, which works without /dev/mem
+    for(i = 0; i < 3 && !(*load_bios[i])(bios); i++)
+      if(!i && bios->card && !bios->card->mapped)
+        NV_MAP_MEM(bios->card);
+
+    if(i == 3)
     {
-      if(!(*load_bios[1-i])(bios)) // the opposite of what is above
-      {
-        printf("Error: Unable to shadow the video bios from PROM or PRAMIN\n");
-        return 0;
-      }
+      fprintf(LOG(bios), "Error: Unable to shadow the video bios from sysfs, PROM or PRAMIN\n");
+      return 0;
     }
   }
 
   // Do not exit on this condition as the user may just want to save their bios and not edit it
   if(!parse_bios(bios, 1))
-    fprintf(stderr, "Warning: Unable to parse the bios\n");
+    fprintf(ERR(bios), "Warning: Unable to parse the bios\n");
 
   return 1;
 }
 
-int write_bios(struct nvbios *bios, const char *filename)
+// Write the whole image to fd, either with write() or through a shared mapping of the file
+static int write_rom(struct nvbios *bios, int fd)
 {
-  if(!bios)
-    return 0;
-
-  if(bios->verbose)
-    printf("------------------------------------\n%s\n------------------------------------\n", __func__);
+  u_int done = 0;
+  ssize_t ret;
 
-  if(!parse_bios(bios, 0) && !bios->force)        // write the (potentially edited) bios content to the rom
+  if(bios->mmap_output)
   {
-    printf("Error: An error occured in writing the bios so output has been disabled\n");
-    printf("       Use -f or --force if you are sure you know what you are doing\n");
+    u_char *out;
 
-    return 0;
-  }
+    if(ftruncate(fd, bios->rom_size))
+      return 0;
 
-  // Internal verification:
-  //    Detect if the user added a reserved string or a reserved end tag to the rom in an illegal place
-  //    Detect if the programmer's read and write functions are not inverses of one another
+    out = mmap(NULL, bios->rom_size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    if(out == MAP_FAILED)
+      return 0;
 
-  struct nvbios bios_cpy;                         // create a new bios struct
-  memset(&bios_cpy, 0, sizeof(struct nvbios));    // clear all bios content
-  memcpy(bios_cpy.rom, bios->rom, NV_PROM_SIZE);  // copy rom data from old bios struct to new bios struct
-  bios_cpy.rom_size = bios->rom_size;             // copy some other struct bios members that parse_bios will not set
-  bios_cpy.force = bios->force;
+    memcpy(out, bios->rom, bios->rom_size);
+    ret = msync(out, bios->rom_size, MS_SYNC);
+    munmap(out, bios->rom_size);
 
-  if(!parse_bios(&bios_cpy, 1) && !bios->force)   // re-read the bios
+    return !ret;
+  }
+
+  while(done < bios->rom_size)
   {
-    printf("Error: An error occured in parsing the edited bios so output has been disabled\n");
-    printf("       Use -f or --force if you are sure you know what you are doing\n");
+    if((ret = write(fd, bios->rom + done, bios->rom_size - done)) < 0)
+      return 0;
+    done += ret;
+  }
+
+  return 1;
+}
+
+/* Save the image so that filename always holds either the old or the complete new file, even after a crash:
+/  the image goes to a temporary file in the same directory which is synced and then renamed over filename.
+/  Anything that is not a regular file (a device, a pipe, ...) is simply written in place.
+*/
+static int save_bios_file(struct nvbios *bios, const char *filename)
+{
+  static u_int save_seq;
+  struct stat stbuf;
+  char *tmpname, *slash, *target;
+  int fd, ok, tries = 0, exists;
 
+  exists = !stat(filename, &stbuf);
+  if(exists && !S_ISREG(stbuf.st_mode))
+  {
+    if((fd = open(filename, O_WRONLY)) == -1)
+    {
+      fprintf(LOG(bios), "Error: Unable to write to file %s\n", filename);
+      return 0;
+    }
+
+    ok = write_rom(bios, fd);
+    close(fd);
+
+    if(!ok)
+      fprintf(LOG(bios), "Error: Unable to write to file %s\n", filename);
+    return ok;
+  }
+
+  // Like fopen the file a symlink points to is replaced, not the link, so the temporary file goes next to it
+  if(!(target = exists ? realpath(filename, NULL) : strdup(filename)))
+  {
+    fprintf(LOG(bios), "Error: Unable to write to file %s\n", filename);
     return 0;
   }
 
-  // Copy all other struct bios members so the bioses can be compared
-  bios_cpy.checksum = bios->checksum;
-  bios_cpy.crc = bios->crc;
-  bios_cpy.fake_crc = bios->fake_crc;
-  bios_cpy.no_correct_checksum = bios->no_correct_checksum;
-  bios_cpy.pramin_priority = bios->pramin_priority;
-  bios_cpy.verbose = bios->verbose;
+  if(!(tmpname = malloc(strlen(target) + 32)))
+  {
+    free(target);
+    return 0;
+  }
 
-  if(memcmp(&bios_cpy, bios, sizeof(struct nvbios))) // compare the bioses
+  // Created with the permissions fopen would give it, the kernel applies the umask; the process id and the
+  // sequence number keep the names of concurrent saves (--all saves every card on its own thread) apart
+  do
   {
-    printf("Error: Unable to reparse the edited bios to get the appropriate struct bios members\n");
+    sprintf(tmpname, "%s.%d.%u", target, (int)getpid(), __sync_fetch_and_add(&save_seq, 1));
+    fd = open(tmpname, O_CREAT | O_EXCL | O_WRONLY, 0666);
+  }
+  while(fd == -1 && errno == EEXIST && ++tries < 100);
+
+  if(fd == -1)
+  {
+    fprintf(LOG(bios), "Error: Unable to write to file %s\n", filename);
+    free(tmpname);
+    free(target);
     return 0;
   }
 
-  FILE *fp = NULL;
-  u_int i;
+  // An existing file keeps its mode and, when we may give it away, its owner; chown goes first as it clears setuid
+  if(exists)
+  {
+    if((stbuf.st_uid != geteuid() || stbuf.st_gid != getegid()) && fchown(fd, stbuf.st_uid, stbuf.st_gid) && bios->verbose)
+      fprintf(LOG(bios), "Warning: %s now belongs to the current user\n", filename);
+    fchmod(fd, stbuf.st_mode & 07777);
+  }
 
-  //  NOTE: nvflash lets you flash the 64K Pramin with invalid checksum*
+  ok = write_rom(bios, fd) && !fsync(fd);
+  ok = !close(fd) && ok;
+  ok = ok && !rename(tmpname, target);
+  free(target);
 
-  fp = fopen(filename, "w+");
-  if(!fp)
+  if(!ok)
   {
-    printf("Error: Unable to write to file %s\n", filename);
+    fprintf(LOG(bios), "Error: Unable to write to file %s\n", filename);
+    unlink(tmpname);
+    free(tmpname);
     return 0;
   }
 
-  for(i = 0; i < bios->rom_size; i++)
-    fprintf(fp, "%c", bios->rom[i]);
+  // Make the rename itself durable
+  if((slash = strrchr(tmpname, '/')))
+    slash[slash == tmpname] = 0;
+  if((fd = open(slash ? tmpname : ".", O_RDONLY | O_DIRECTORY)) != -1)
+  {
+    fsync(fd);
+    close(fd);
+  }
+
+  free(tmpname);
+  return 1;
+}
+
+/* Re-read the tables which were edited or whose bytes changed since they were decoded and compare only their fields
+/  with what was written. Tables which were neither edited nor written to are not touched at all.
+*/
+static int verify_edits(struct nvbios *bios)
+{
+  struct nvbios check;
+  u_int table, tables = bios->dirty.tables;
+  int ok = 1;
+
+  for(table = TABLE_PERF; table <= TABLE_HEADER; table <<= 1)
+    if((bios->tables.parsed | TABLE_HEADER) & table && table_fields_crc(bios, table) != bios->tables.fields_crc[__builtin_ctz(table)])
+      tables |= table;
+
+  if(bios->dirty.overflow)
+    tables |= bios->tables.parsed | TABLE_HEADER;
 
-  fclose(fp);
+  check = *bios;
+  check.verbose = 0;
+
+  // The tables depend on the architecture and the table versions so the header goes first
+  if(tables & TABLE_HEADER)
+  {
+    clear_table_fields(&check, TABLE_HEADER);
+    ok = parse_bios(&check, 1);
+    check.tables = bios->tables;
+  }
+
+  for(table = TABLE_PERF; table & TABLE_ALL; table <<= 1)
+  {
+    if(!(tables & table & bios->tables.parsed))
+      continue;
+
+    clear_table_fields(&check, table);
+    parse_table(&check, table, 1);
+  }
+
+  for(table = TABLE_PERF; table <= TABLE_HEADER; table <<= 1)
+    if(tables & table && !compare_table_fields(&check, bios, table))
+      ok = 0;
+
+  if(check.pll_lst != bios->pll_lst)
+    free(check.pll_lst);
+
+  if(!ok)
+    return 0;
+
+  // What is in the rom now is what the fields say
+  for(table = TABLE_PERF; table <= TABLE_HEADER; table <<= 1)
+    if(tables & table)
+      table_fields_decoded(bios, table);
+  bios->dirty.num_ranges = 0;
+  bios->dirty.overflow = 0;
+  bios->dirty.tables = 0;
+
+  return 1;
+}
+
+int write_bios(struct nvbios *bios, const char *filename)
+{
+  if(!bios)
+    return 0;
+
+  if(bios->verbose)
+    fprintf(LOG(bios), "------------------------------------\n%s\n------------------------------------\n", __func__);
+
+  // The edits below must not end up in (or depend on) the file the rom was mapped from
+  if(!unshare_rom(bios))
+  {
+    fprintf(LOG(bios), "Error: Out of memory\n");
+    return 0;
+  }
+
+  if(!parse_bios(bios, 0) && !bios->force)        // write the (potentially edited) bios content to the rom
+  {
+    fprintf(LOG(bios), "Error: An error occured in writing the bios so output has been disabled\n");
+    fprintf(LOG(bios), "       Use -f or --force if you are sure you know what you are doing\n");
+
+    return 0;
+  }
+
+  // Internal verification:
+  //    Detect if the user added a reserved string or a reserved end tag to the rom in an illegal place (done by parse_bios)
+  //    Detect if the programmer's read and write functions are not inverses of one another
+  if(!verify_edits(bios))
+  {
+    fprintf(LOG(bios), "Error: Unable to reparse the edited bios to get the appropriate struct bios members\n");
+    return 0;
+  }
+
+  //  NOTE: nvflash lets you flash the 64K Pramin with invalid checksum*
+
+  if(!save_bios_file(bios, filename))
+    return 0;
 
   if(bios->verbose)
-    printf("Bios outputted to file '%s'\n", filename);
+    fprintf(LOG(bios), "Bios outputted to file '%s'\n", filename);
 
   return 1;
 }
@@ -1248,7 +1810,6 @@ int write_bios(struct nvbios *bios, const char *filename)
 int load_bios_file(struct nvbios *bios, const char* filename)
 {
   int fd = 0;
-  u_char *rom;
   struct stat stbuf;
   u_int size, proj_file_size;
 
@@ -1256,34 +1817,32 @@ int load_bios_file(struct nvbios *bios, const char* filename)
 
   if((stbuf.st_mode & S_IFMT) == S_IFDIR)
   {
-    printf("Error: %s is a directory, not a file\n", filename);
+    fprintf(LOG(bios), "Error: %s is a directory, not a file\n", filename);
     return 0;
   }
 
   size = stbuf.st_size;
 
-  if(size < 3)
+  if(size < 3 || size > NV_PROM_SIZE)
   {
-    printf("Error: %s has invalid file size\n", filename);
+    fprintf(LOG(bios), "Error: %s has invalid file size\n", filename);
     return 0;
   }
 
   if((fd = open(filename, O_RDONLY)) == -1)
   {
-    printf("Error: Cannot access file %s\n", filename);
+    fprintf(LOG(bios), "Error: Cannot access file %s\n", filename);
     return 0;
   }
 
-  rom = (u_char *)mmap(0, size, PROT_READ, MAP_SHARED, fd, 0);
-  if(!rom)
+  /* Map the bios; the mapping stays valid after the file is closed */
+  if(!map_rom(bios, fd, size))
+  {
+    fprintf(LOG(bios), "Error: Cannot map file %s\n", filename);
+    close(fd);
     return 0;
+  }
 
-  /* Copy bios data */
-  memcpy(bios->rom, rom, size);
-
-  munmap(rom, size);
-
-  /* Close the bios */
   close(fd);
 
   proj_file_size = get_rom_size(bios);
@@ -1291,22 +1850,104 @@ int load_bios_file(struct nvbios *bios, const char* filename)
   // NOTE: Should I add --force here?
   if(size != proj_file_size)
   {
-    printf("Error: The file size %d B does not match the projected file size %d B\n", size, proj_file_size);
+    fprintf(LOG(bios), "Error: The file size %d B does not match the projected file size %d B\n", size, proj_file_size);
     return 0;
   }
 
   bios->rom_size = size;
 
-  u_int i;
-  for(i = 0, bios->checksum = 0; i < bios->rom_size; i++)
-    bios->checksum = bios->checksum + bios->rom[i];
+  // CRC check not implemented because we are unsure file corresponds to physically connected GPU.
+  checksum_bios(bios, 0);
 
   if(bios->checksum)
-    fprintf(stderr, "Warning: File %s has an incorrect checksum\n", filename);
+    fprintf(ERR(bios), "Warning: File %s has an incorrect checksum\n", filename);
 
-  // CRC check not implemented because we are unsure file corresponds to physically connected GPU.
-  bios->crc = CRC(0, bios->rom, bios->rom_size);
-  bios->fake_crc = CRC(0, bios->rom, NV_PROM_SIZE);
+  index_bios(bios);
+
+  return verify_bios(bios);
+}
+
+enum { SYSFS_MAGIC = 0x62656572 };
+
+/* Set the sysfs rom attribute; the kernel only allows reading it after "1" has been written to it.
+/  Anything which isn't sysfs (a fake tree for testing) is left alone.
+*/
+static int sysfs_rom_enable(int fd, const char *value)
+{
+  struct statfs fsbuf;
+
+  if(fstatfs(fd, &fsbuf) || fsbuf.f_type != SYSFS_MAGIC)
+    return 1;
+
+  return pwrite(fd, value, 1, 0) == 1;
+}
+
+/* Load the bios through the rom attribute of the PCI device in sysfs. The kernel takes care of enabling the
+/  PROM (or hands out the shadow copy of the system bios) so this is both faster and safer than the register access.
+*/
+int load_bios_sysfs(struct nvbios *bios)
+{
+  NVCard *card = bios->card;
+  char *filename;
+  u_int size = 0;
+  ssize_t ret;
+  int fd;
+
+  if(!card || !card->sysfs_path)
+    return 0;
+
+  if(asprintf(&filename, "%s/rom", card->sysfs_path) == -1)
+    return 0;
+
+  // Enabling the rom needs write access; a readable one which is already enabled is fine as well
+  if((fd = open(filename, O_RDWR)) == -1 && (fd = open(filename, O_RDONLY)) == -1)
+  {
+    if(bios->verbose)
+      fprintf(LOG(bios), "Cannot open %s, falling back to the registers\n", filename);
+    free(filename);
+    return 0;
+  }
+  free(filename);
+
+  if(!map_rom(bios, -1, 0))
+  {
+    close(fd);
+    return 0;
+  }
+
+  sysfs_rom_enable(fd, "1");
+
+  // Normally a single read returns the whole rom
+  while(size < NV_PROM_SIZE && (ret = pread(fd, bios->rom + size, NV_PROM_SIZE - size, size)) > 0)
+    size += ret;
+
+  sysfs_rom_enable(fd, "0");
+  close(fd);
+
+  if(size < 3)
+  {
+    if(bios->verbose)
+      fprintf(LOG(bios), "The sysfs rom of %s is empty, falling back to the registers\n", card->dev_name);
+    return 0;
+  }
+
+  bios->rom_size = get_rom_size(bios);
+
+  if(bios->rom_size > size)
+  {
+    fprintf(LOG(bios), "Error: Only %u B of the %u B rom could be read from sysfs\n", size, bios->rom_size);
+    return 0;
+  }
+
+  checksum_bios(bios, 0);
+
+  if(bios->checksum)
+  {
+    fprintf(LOG(bios), "Error: Incorrect checksum read from sysfs\n");
+    return 0;
+  }
+
+  index_bios(bios);
 
   return verify_bios(bios);
 }
@@ -1314,119 +1955,212 @@ int load_bios_file(struct nvbios *bios, const char* filename)
 /* Load the bios from video memory. Note it might not be cached there at all times. */
 int load_bios_pramin(struct nvbios *bios)
 {
-  u_char *rom;
+  NVCard *card = bios->card;
   uint32_t old_bar0_pramin = 0;
 
+  if(!card || !card->mapped)
+    return 0;
+
   /* Don't use this on unknown cards because we don't know if it needs PRAMIN fixups. */
-  if(!nv_card->arch && !bios->force)
+  if(!card->arch && !bios->force)
   {
-    printf("Error: Reading the bios from videocard memory is disabled on unknown architectures\n");
-    printf("       Use -f or --force if you are sure you know what you are doing\n");
+    fprintf(LOG(bios), "Error: Reading the bios from videocard memory is disabled on unknown architectures\n");
+    fprintf(LOG(bios), "       Use -f or --force if you are sure you know what you are doing\n");
     return 0;
   }
 
   /* On NV5x cards we need to let pramin point to the bios */
-  if(nv_card->arch > NV4X)
+  if(card->arch > NV4X)
   {
-    uint32_t vbios_vram = (nv_card->PDISPLAY[0x9f04/4] & ~0xff) << 8;
+    uint32_t vbios_vram = (NV_RD32(card, NV_APERTURE_PDISPLAY, 0x9f04) & ~0xff) << 8;
 
     if(!vbios_vram)
-      vbios_vram = (nv_card->PMC[0x1700/4] << 16) + 0xf0000;
+      vbios_vram = (NV_RD32(card, NV_APERTURE_PMC, 0x1700) << 16) + 0xf0000;
 
-    old_bar0_pramin = nv_card->PMC[0x1700/4];
-    nv_card->PMC[0x1700/4] = (vbios_vram >> 16);
+    old_bar0_pramin = NV_RD32(card, NV_APERTURE_PMC, 0x1700);
+    NV_WR32(card, NV_APERTURE_PMC, 0x1700, vbios_vram >> 16);
   }
 
   /* Copy bios data */
-  rom = (u_char*)nv_card->PRAMIN;
-  memcpy(bios->rom, rom, NV_PROM_SIZE);
+  if(!map_rom(bios, -1, 0))
+    return 0;
+  NV_COPY(card, NV_APERTURE_PRAMIN, 0, bios->rom, NV_PROM_SIZE);
 
-  if(nv_card->arch > NV4X)
-    nv_card->PMC[0x1700/4] = old_bar0_pramin;
+  if(card->arch > NV4X)
+    NV_WR32(card, NV_APERTURE_PMC, 0x1700, old_bar0_pramin);
 
   bios->rom_size = get_rom_size(bios);
 
-  u_int i;
-  for(i = 0, bios->checksum = 0; i < bios->rom_size; i++)
-    bios->checksum = bios->checksum + bios->rom[i];
+  // TODO: Find the stamped CRC in a register
+  checksum_bios(bios, 0);
 
   // I do not currently allow --force here.
   if(bios->checksum)
   {
-    printf("Error: Incorrect checksum read from PRAMIN\n");
+    fprintf(LOG(bios), "Error: Incorrect checksum read from PRAMIN\n");
     return 0;
   }
 
-  // TODO: Find the stamped CRC in a register
-  bios->crc = CRC(0, bios->rom, bios->rom_size);
-  bios->fake_crc = CRC(0, bios->rom, NV_PROM_SIZE);
+  index_bios(bios);
 
   return verify_bios(bios);
 }
 
-/* Load the video bios from the ROM. Note laptops might not have a ROM which can be accessed from the GPU */
-int load_bios_prom(struct nvbios *bios)
+enum { STABLE_COUNT = 7, MAX_ALLOWED_DELAY = STABLE_COUNT * 3, PROM_LEARN_SIZE = 0x1000, PROM_VERIFY_BLOCK = 0x100 };
+
+static void prom_store_word(u_char *rom, uint32_t word)
 {
-  u_int i,j;
-  u_int delay;
-  enum { STABLE_COUNT = 7 , MAX_ALLOWED_DELAY = STABLE_COUNT * 3};
-  u_int max_delay = STABLE_COUNT;
+  rom[0] = word;
+  rom[1] = word >> 8;
+  rom[2] = word >> 16;
+  rom[3] = word >> 24;
+}
 
-  /* enable bios parsing; on some boards the display might turn off */
-  nv_card->PMC[0x1850/4] = 0x0;
+/* Very simple software debouncer for stable output: read a PROM word until it was the same STABLE_COUNT times in a row.
+/  Returns the number of reads it took (at least STABLE_COUNT) or 0 on a timeout.
+*/
+static u_int prom_debounce_word(NVCard *card, u_int offset, uint32_t *word)
+{
+  uint32_t value, next;
+  u_int j, delay = 0;
 
-  // TODO: perhaps use the identified EEPROM to find the number of delays (faster but less flexible)
+  value = NV_RD32(card, NV_APERTURE_PROM, offset);
 
-  // Very simple software debouncer for stable output
-  for(i = 0; i < NV_PROM_SIZE; i++)
+  for(j = 0; j < STABLE_COUNT; j++)
   {
-    delay = 0;
-    bios->rom[i] = nv_card->PROM[i];
+    if(delay == MAX_ALLOWED_DELAY)
+      return 0;
 
-    for(j = 0; j < STABLE_COUNT; j++)
+    if(value != (next = NV_RD32(card, NV_APERTURE_PROM, offset)))
     {
-      if(delay == MAX_ALLOWED_DELAY)
-      {
-        printf("Error: Timeout occurred while waiting for stable PROM output\n");
-        return 0;
-      }
+      value = next;
+      j = -1;
+    }
 
-      if(bios->rom[i] != nv_card->PROM[i])
-      {
-        bios->rom[i] = nv_card->PROM[i];
-        j = -1;
-      }
+    delay++;
+  }
 
-      delay++;
-    }
+  *word = value;
+  return delay;
+}
+
+/* Adaptive debouncer: debouncing every byte STABLE_COUNT times is slow on EEPROMs that are stable right away, so
+/    1. the first PROM_LEARN_SIZE bytes are fully debounced a word at a time, which tells how many reads a word needs to settle
+/       (ignoring the slowest 1/256 of the words, a rare glitch is left to the verification),
+/    2. the rest is read with just that many reads per word,
+/    3. a second pass compares the CRC of every PROM_VERIFY_BLOCK bytes with a fresh read and fully debounces the blocks that disagree.
+/  Returns 0 on a timeout.
+*/
+static int prom_read(struct nvbios *bios, NVCard *card)
+{
+  u_int i, j, delay;
+  u_int max_delay = STABLE_COUNT, settle, reread = 0;
+  u_int extra[MAX_ALLOWED_DELAY - STABLE_COUNT + 1];
+  u_char block[PROM_VERIFY_BLOCK];
+  uint32_t word, last;
+
+  // TODO: perhaps use the identified EEPROM to find the number of delays (faster but less flexible)
 
+  // Learn the settle count; every read before the final stable run is one the word needed to settle
+  memset(extra, 0, sizeof(extra));
+  for(i = 0; i < PROM_LEARN_SIZE; i += 4)
+  {
+    if(!(delay = prom_debounce_word(card, i, &word)))
+      return 0;
+
+    prom_store_word(bios->rom + i, word);
+    extra[delay - STABLE_COUNT]++;
     if(delay > max_delay)
       max_delay = delay;
   }
 
+  for(settle = 0, j = 0; j < (PROM_LEARN_SIZE / 4) * 255 / 256; settle++)
+    j += extra[settle];
+
   if(bios->verbose)
-    printf("This EEPROM probably requires %d delays\n", max_delay - STABLE_COUNT);
+    fprintf(LOG(bios), "This EEPROM probably requires %d delays (%d at most)\n", settle - 1, max_delay - STABLE_COUNT);
+
+  for(; i < NV_PROM_SIZE; i += 4)
+  {
+    for(j = 0, word = last = 0; j < settle; j++)
+    {
+      last = word;
+      word = NV_RD32(card, NV_APERTURE_PROM, i);
+    }
+
+    // Still moving after the learned number of reads
+    if(settle > 1 && word != last && !prom_debounce_word(card, i, &word))
+      return 0;
+
+    prom_store_word(bios->rom + i, word);
+  }
+
+  // Verify the part that was not fully debounced
+  for(i = PROM_LEARN_SIZE; i < NV_PROM_SIZE; i += PROM_VERIFY_BLOCK)
+  {
+    for(j = 0; j < PROM_VERIFY_BLOCK; j += 4)
+      prom_store_word(block + j, NV_RD32(card, NV_APERTURE_PROM, i + j));
+
+    if(CRC(0, block, PROM_VERIFY_BLOCK) == CRC(0, bios->rom + i, PROM_VERIFY_BLOCK))
+      continue;
+
+    for(j = 0; j < PROM_VERIFY_BLOCK; j += 4)
+    {
+      if(!prom_debounce_word(card, i + j, &word))
+        return 0;
+      prom_store_word(bios->rom + i + j, word);
+    }
+    reread++;
+  }
+
+  if(bios->verbose && reread)
+    fprintf(LOG(bios), "Re-read %u of %u PROM blocks which were unstable\n", reread, (NV_PROM_SIZE - PROM_LEARN_SIZE) / PROM_VERIFY_BLOCK);
+
+  return 1;
+}
+
+/* Load the video bios from the ROM. Note laptops might not have a ROM which can be accessed from the GPU */
+int load_bios_prom(struct nvbios *bios)
+{
+  NVCard *card = bios->card;
+  int ok;
+
+  if(!card || !card->mapped)
+    return 0;
+
+  if(!map_rom(bios, -1, 0))
+    return 0;
+
+  /* enable bios parsing; on some boards the display might turn off */
+  NV_WR32(card, NV_APERTURE_PMC, 0x1850, 0x0);
+
+  ok = prom_read(bios, card);
 
   /* disable the rom; if we don't do it the screens stays black on some cards */
-  nv_card->PMC[0x1850/4] = 0x1;
+  NV_WR32(card, NV_APERTURE_PMC, 0x1850, 0x1);
+
+  if(!ok)
+  {
+    fprintf(LOG(bios), "Error: Timeout occurred while waiting for stable PROM output\n");
+    return 0;
+  }
 
   bios->rom_size = get_rom_size(bios);
 
-  for(i = 0, bios->checksum = 0; i < bios->rom_size; i++)
-    bios->checksum = bios->checksum + bios->rom[i];
+  // TODO: Find the stamped CRC in a register
+  checksum_bios(bios, 0);
 
   // I do not currently allow --force here.
   if(bios->checksum)
   {
-    printf("Error: Incorrect checksum read from PROM\n");
+    fprintf(LOG(bios), "Error: Incorrect checksum read from PROM\n");
     return 0;
   }
 
-  // TODO: Find the stamped CRC in a register
-  bios->crc = CRC(0, bios->rom, bios->rom_size);
-  bios->fake_crc = CRC(0, bios->rom, NV_PROM_SIZE);
+  index_bios(bios);
 
   return verify_bios(bios);
+
 }
 
 void print_bios_info(struct nvbios *bios)
@@ -1435,72 +2169,92 @@ void print_bios_info(struct nvbios *bios)
     return;
   // TODO: I either need to call parse_bios again before this or call parse_bios after every edit
   u_int i;
+  char str[256];
+
+  if(bios->run_init)
+  {
+    print_init_exec(bios);
+    return;
+  }
+  if(bios->find_reg)
+  {
+    print_reg_writes(bios);
+    return;
+  }
+
+  parse_tables(bios, TABLE_ALL);
 
-  printf("\nAdapter           : %s\n", bios->adapter_name);
-  printf("Vendor            : Nvidia\n");  //currently its impossible for this to be anything else b/c of verify_bios
-  printf("Subvendor         : %s\n", bios->vendor_name);
-  printf("File size         : %u%s KB  (%u B)\n", bios->rom_size/1024, bios->rom_size%1024 ? ".5" : "", bios->rom_size);
-  printf("Checksum-8        : %02X\n", bios->checksum);
-  printf("~CRC32            : %08X\n", bios->crc);
+  if(bios->format != FORMAT_TEXT)
+  {
+    print_bios_record(bios);
+    return;
+  }
+
+  fprintf(OUT(bios), "\nAdapter           : %s\n", bios->adapter_name);
+  fprintf(OUT(bios), "Vendor            : Nvidia\n");  //currently its impossible for this to be anything else b/c of verify_bios
+  fprintf(OUT(bios), "Subvendor         : %s\n", bios->vendor_name);
+  fprintf(OUT(bios), "File size         : %u%s KB  (%u B)\n", bios->rom_size/1024, bios->rom_size%1024 ? ".5" : "", bios->rom_size);
+  fprintf(OUT(bios), "Checksum-8        : %02X\n", bios->checksum);
+  fprintf(OUT(bios), "~CRC32            : %08X\n", bios->crc);
 //  printf("~Fake CRC         : %08X\n", bios->fake_crc);
 //  printf("CRC32?            : %08X\n", ~bios->crc);
 //  printf("Fake CRC?         : %08X\n", ~bios->fake_crc);
-  printf("Version [1]       : %s\n", bios->version[0]);
+  fprintf(OUT(bios), "Version [1]       : %s\n", bios->version[0]);
 
   if(bios->arch > NV3X)
-    printf("Version [2]       : %s\n", bios->version[1]);
+    fprintf(OUT(bios), "Version [2]       : %s\n", bios->version[1]);
 
-  printf("Device ID         : %04X\n", bios->device_id);
-  printf("Subvendor ID      : %04X\n", bios->subven_id);
-  printf("Subsystem ID      : %04X\n", bios->subsys_id);
+  fprintf(OUT(bios), "Device ID         : %04X\n", bios->device_id);
+  fprintf(OUT(bios), "Subvendor ID      : %04X\n", bios->subven_id);
+  fprintf(OUT(bios), "Subsystem ID      : %04X\n", bios->subsys_id);
 
   if(bios->arch > NV3X)
   {
-    printf("Board ID          : %04X\n", bios->board_id);
-    printf("Hierarchy ID      : ");
+    fprintf(OUT(bios), "Board ID          : %04X\n", bios->board_id);
+    fprintf(OUT(bios), "Hierarchy ID      : ");
     switch(bios->hierarchy_id)
     {
       case 0:
-        printf("None\n");
+        fprintf(OUT(bios), "None\n");
         break;
       case 1:
-        printf("Normal Board\n");
+        fprintf(OUT(bios), "Normal Board\n");
         break;
       case 2:
       case 3:
       case 4:
       case 5:
-        printf("Switch Port %u\n", bios->hierarchy_id - 2);
+        fprintf(OUT(bios), "Switch Port %u\n", bios->hierarchy_id - 2);
         break;
       default:
-        printf("%X\n", bios->hierarchy_id);
+        fprintf(OUT(bios), "%X\n", bios->hierarchy_id);
     }
-    printf("Build Date        : %s\n", bios->build_date);
+    fprintf(OUT(bios), "Build Date        : %s\n", nv_string(bios, &bios->build_date, str));
   }
 
-  printf("Modification Date : %s\n", bios->mod_date);
-  printf("Sign-on           : %s", bios->str[0]);
+  fprintf(OUT(bios), "Modification Date : %s\n", nv_string(bios, &bios->mod_date, str));
+  fprintf(OUT(bios), "Sign-on           : %s", nv_string(bios, &bios->str[0], str));
 
   if(bios->arch > NV3X)
   {
-    printf("Version           : %s", bios->str[1]);
-    printf("Copyright         : %s", bios->str[2]);
-    printf("OEM               : %s\n", bios->str[3]);
-    printf("VESA Vendor       : %s\n", bios->str[4]);
-    printf("VESA Name         : %s\n", bios->str[5]);
-    printf("VESA Revision     : %s\n", bios->str[6]);
-    printf("Release           : %s", bios->str[7]);
-    printf("Text time         : %u ms\n", bios->text_time);
+    fprintf(OUT(bios), "Version           : %s", nv_string(bios, &bios->str[1], str));
+    fprintf(OUT(bios), "Copyright         : %s", nv_string(bios, &bios->str[2], str));
+    fprintf(OUT(bios), "OEM               : %s\n", nv_string(bios, &bios->str[3], str));
+    fprintf(OUT(bios), "VESA Vendor       : %s\n", nv_string(bios, &bios->str[4], str));
+    fprintf(OUT(bios), "VESA Name         : %s\n", nv_string(bios, &bios->str[5], str));
+    fprintf(OUT(bios), "VESA Revision     : %s\n", nv_string(bios, &bios->str[6], str));
+    fprintf(OUT(bios), "Release           : %s", nv_string(bios, &bios->str[7], str));
+    fprintf(OUT(bios), "Text time         : %u ms\n", bios->text_time);
   }
   else
-    printf("BMP version: %x.%x\n", bios->major, bios->minor);
+    fprintf(OUT(bios), "BMP version: %x.%x\n", bios->major, bios->minor);
 
   //TODO: print delta; only print delta if(bios->arch & (NV47 | NV49))
 
   char shader_num[21], lock_nibble[8];
 
   if(bios->perf_entries)
-    printf("\nPerf lvl | Active |  Gpu Freq %s|  Mem Freq | Voltage | Fan  %s\n", bios->arch & NV5X ? "| Shad Freq " : "", bios->arch & NV4X ? "| Lock " : "");
+    fprintf(OUT(bios), "\nPerf lvl | Active |  Gpu Freq %s|  Mem Freq | Voltage | Fan  %s\n", bios->arch & NV5X ? "| Shad Freq " : "", bios->arch & NV4X ? "| Lock " : "");
 
   for(i = 0; i < bios->perf_entries; i++)
   {
@@ -1519,53 +2273,53 @@ void print_bios_info(struct nvbios *bios)
       display_nvclk /= 100;
       display_memclk /= 50;
       if(display_nvclk > 0xFFFF || display_memclk > 0xFFFF)
-        fprintf(stderr, "Warning: Core clock or Memory clock is too high.  Masking clks...\n");
+        fprintf(ERR(bios), "Warning: Core clock or Memory clock is too high.  Masking clks...\n");
       display_nvclk &= 0xFFFF;
       display_memclk &= 0xFFFF;
     }
 
     /* The voltage is stored in multiples of 10mV, scale it to V */
     float display_voltage = (float)bios->perf_lst[i].voltage / 100.0;
-    printf("%8d |    %s | %5u MHz%s | %5u MHz | %1.2f V  | %3d%%%s\n", i, i < bios->active_perf_entries ? "Yes" : "No ", display_nvclk, shader_num, display_memclk, display_voltage, bios->perf_lst[i].fanspeed, lock_nibble);
+    fprintf(OUT(bios), "%8d |    %s | %5u MHz%s | %5u MHz | %1.2f V  | %3d%%%s\n", i, i < bios->active_perf_entries ? "Yes" : "No ", display_nvclk, shader_num, display_memclk, display_voltage, bios->perf_lst[i].fanspeed, lock_nibble);
   }
 
   if(bios->volt_entries)
   {
-    printf("\nVID mask: %02X\n", bios->volt_mask);
-    printf("\nVolt lvl | Active | Voltage | VID\n");
+    fprintf(OUT(bios), "\nVID mask: %02X\n", bios->volt_mask);
+    fprintf(OUT(bios), "\nVolt lvl | Active | Voltage | VID\n");
   }
 
   for(i = 0; i < bios->volt_entries; i++)
   {
     /* The voltage is stored in multiples of 10mV, scale it to V */
     float display_voltage = (float)bios->volt_lst[i].voltage / 100.0;
-    printf("%8d |    %s | %1.2f V  | %02X\n", i, i < bios->active_volt_entries ? "Yes" : "No ", display_voltage, bios->volt_lst[i].VID);
+    fprintf(OUT(bios), "%8d |    %s | %1.2f V  | %02X\n", i, i < bios->active_volt_entries ? "Yes" : "No ", display_voltage, bios->volt_lst[i].VID);
   }
 
-  printf("\n");
+  fprintf(OUT(bios), "\n");
 
   if(bios->caps & TEMP_CORRECTION)
-    printf("Temparature compensation         : %d\n", bios->temp_correction);
+    fprintf(OUT(bios), "Temparature compensation         : %d\n", bios->temp_correction);
 
   if(bios->caps & FNBST_THLD_1)
-    printf("Fanboost internal threshold      : %u\n", bios->fnbst_int_thld);
+    fprintf(OUT(bios), "Fanboost internal threshold      : %u\n", bios->fnbst_int_thld);
 
   if(bios->caps & FNBST_THLD_2)
-    printf("Fanboost external threshold      : %u\n", bios->fnbst_ext_thld);
+    fprintf(OUT(bios), "Fanboost external threshold      : %u\n", bios->fnbst_ext_thld);
 
   if(bios->caps & THRTL_THLD_1)
-    printf("Throttle internal threshold      : %u\n", bios->thrtl_int_thld);
+    fprintf(OUT(bios), "Throttle internal threshold      : %u\n", bios->thrtl_int_thld);
 
   if(bios->caps & THRTL_THLD_2)
-    printf("Throttle external threshold      : %u\n", bios->thrtl_ext_thld);
+    fprintf(OUT(bios), "Throttle external threshold      : %u\n", bios->thrtl_ext_thld);
 
   if(bios->caps & CRTCL_THLD_1)
-    printf("Critical internal threshold      : %u\n", bios->crtcl_int_thld);
+    fprintf(OUT(bios), "Critical internal threshold      : %u\n", bios->crtcl_int_thld);
 
   if(bios->caps & CRTCL_THLD_2)
-    printf("Critical external threshold      : %u\n", bios->crtcl_ext_thld);
+    fprintf(OUT(bios), "Critical external threshold      : %u\n", bios->crtcl_ext_thld);
 
-  printf("\n");
+  fprintf(OUT(bios), "\n");
 }
 
 // Disable/Enable PCM motherboard speaker access
@@ -1581,19 +2335,20 @@ int set_speaker(struct nvbios *bios, char state)
   u_char toggle_string[5] = { 0x50, 0x0C & 0x24, 0x00, 0xE6, 0x61 };
   u_char reset_string[3] = { 0x58, 0xE6, 0x61 };
   u_char mask[5] = { 0xFF, 0x0C & 0x24, 0x00, 0xFF, 0xFF };
+  u_int matches[2];
 
-  first_offset = locate_masked_segment(bios, toggle_string, mask, 0, 5);
-
-  if(!first_offset)
+  // One search for both the write and a possible second write
+  switch(locate_masked_segments(bios, toggle_string, mask, 0, 5, matches, 2))
   {
-    printf("Error: could not find write to port 61 (PC Speaker)\n");
-    return 0;
-  }
-
-  if(locate_masked_segment(bios, toggle_string, mask, first_offset + 1, 5))
-  {
-    printf("Error: found potential speaker %s multiple times\n", state? "enable" : "disable");
-    return 0;
+    case 0:
+      fprintf(LOG(bios), "Error: could not find write to port 61 (PC Speaker)\n");
+      return 0;
+    case 1:
+      first_offset = matches[0];
+      break;
+    default:
+      fprintf(LOG(bios), "Error: found potential speaker %s multiple times\n", state? "enable" : "disable");
+      return 0;
   }
 
   // Here is where the AL register's previous value is reset and rewritten?
@@ -1601,13 +2356,13 @@ int set_speaker(struct nvbios *bios, char state)
 
   if(!second_offset)
   {
-    printf("Error: could not find reset of port 61 (PC Speaker)\n");
+    fprintf(LOG(bios), "Error: could not find reset of port 61 (PC Speaker)\n");
     return 0;
   }
 
   if(second_offset - first_offset != 0x0B)
   {
-    printf("Error: offsets may have changed.  Contact developer\n");
+    fprintf(LOG(bios), "Error: offsets may have changed.  Contact developer\n");
     return 0;
   }
 
@@ -1615,20 +2370,20 @@ int set_speaker(struct nvbios *bios, char state)
   if(state)
   {
     //opcode for OR byte
-    bios->rom[first_offset+1] = 0x0C;
+    nv_write8(bios, first_offset + 1, 0x0C);
     //operand 0x03 = enable speaker
-    bios->rom[first_offset+2] |= 0x03;
+    nv_write8(bios, first_offset + 2, bios->rom[first_offset+2] | 0x03);
   }
   else
   {
     // opcode for AND byte
-    bios->rom[first_offset+1] = 0x24;
+    nv_write8(bios, first_offset + 1, 0x24);
     // operand ~0x03 = disable speaker
-    bios->rom[first_offset+2] &= 0xFC;
+    nv_write8(bios, first_offset + 2, bios->rom[first_offset+2] & 0xFC);
   }
 
   if(bios->verbose)
-    printf(" + ROM EDIT : Successfully %s speaker\n", state ? "enabled" : "disabled");
+    fprintf(LOG(bios), " + ROM EDIT : Successfully %s speaker\n", state ? "enabled" : "disabled");
 
   return 1;
 }
@@ -1638,374 +2393,150 @@ int set_print(struct nvbios *bios, char state)
   return 0;
 }
 
-/* Init script tables contain dozens of entries containing commands to initialize
-/  the card. There are lots of different commands each having a different 'id' useally
-/  most entries also have a different size. The task of this function is to move to the
-/  next entry in the table.
+/* Parse the table containing pll programming limits. Only the entries which fit in the rom are used, whatever
+/  the header claims, and writing puts back the limits of the entries which were read.
 */
-// Warning this was a signed char *rom
-int bit_init_script_table_get_next_entry(struct nvbios *bios, int offset)
+void parse_bit_pll_table(struct nvbios *bios, u_short offset, char rnw)
 {
-  u_char id = bios->rom[offset];
-//  int i=0;
+  struct BitTableHeader *header = (struct BitTableHeader*)(bios->rom+offset);
+  u_int i, entry, num_entries, size = bios->rom_size < NV_PROM_SIZE ? bios->rom_size : NV_PROM_SIZE;
+  struct pll *pll;
 
-  switch(id)
+  if(rnw)
   {
-    case '2': /* 0x32 */
-      offset += 43;
-      break;
-    case '3': /* 0x33: INIT_REPEAT */
-      offset += 2;
-      break;
-    case '6': /* 0x36: INIT_REPEAT_END */
-      offset += 1;
-      break;
-    case '7': /* 0x37 */
-      offset += 11;
-      break;
-    case '8': /* 0x38: INIT_NOT */
-      offset += 1;
-      break;
-    case '9': /* 0x39 */
-      offset += 2;
-      break;
-    case 'J': /* 0x4A */
-      offset += 43;
-      break;
-    case 'K': /* 0x4B */
-#if DEBUG
-      /* +1 = PLL register, +5 = value */
-      printf("'%c'\t%08x %08x\n", id, READ_LE_INT(bios->rom, offset+1), READ_LE_INT(bios->rom, offset+5));
-#endif
-      offset += 9;
-      break;
-    case 'M': /* 0x4D: INIT_ZM_I2C_BYTE */
-#if DEBUG
-      printf("'%c'\ti2c bytes: %x\n", id, bios->rom[offset+3]);
-#endif
-      offset += 4 + bios->rom[offset+3]*2;
-      break;
-    case 'Q': /* 0x51 */
-      offset += 5 + bios->rom[offset+4];
-      break;
-    case 'R': /* 0x52 */
-      offset += 4;
-      break;
-    case 'S': /* 0x53: INIT_ZM_CR */
-#if DEBUG
-      /* +1 CRTC index (8-bit)
-      /  +2 value (8-bit)
-      */
-      printf("'%c'\tCRTC index: %x value: %x\n", id, bios->rom[offset+1], bios->rom[offset+2]);
-#endif
-      offset += 3;
-      break;
-    case 'T': /* 0x54 */
-      offset += 2 + bios->rom[offset+1] * 2;
-      break;
-    case 'V': /* 0x56 */
-      offset += 3;
-      break;
-    case 'X': /* 0x58 */
-#if DEBUG
-      {
-        int i;
-        /* +1 register base (32-bit)
-        /  +5 number of values (8-bit)
-        /  +6 value (32-bit) to regbase+4
-        /  .. */
-        int base = READ_LE_INT(bios->rom, offset+1);
-        int number = bios->rom[offset+5];
-
-        printf("'%c'\tbase: %08x number: %d\n", id, base, number);
-        for(i=0; i<number; i++)
-          printf("'%c'\t %08x: %08x\n", id, base+4*i, READ_LE_INT(bios->rom, offset+6 + 4*i));
-      }
-#endif
-      offset += 6 + bios->rom[offset+5] * 4;
-      break;
-    case '[': /* 0x5b */
-      offset += 3;
-      break;
-    case '_': /* 0x5F */
-      offset += 22;
-      break;
-    case 'b': /* 0x62 */
-      offset += 5;
-      break;
-    case 'c': /* 0x63 */
-      offset +=1;
-      break;
-    case 'e': /* 0x65: INIT_RESET */
-#if DEBUG
-      /* +1 register (32-bit)
-      /  +5 value (32-bit)
-      /  +9 value (32-bit)
-      */
-      printf("'%c'\t%08x %08x %08x\n", id, READ_LE_INT(bios->rom, offset+1), READ_LE_INT(bios->rom, offset+5), READ_LE_INT(bios->rom, offset+9));
-#endif
-      offset += 13;
-      break;
-    case 'i': /* 0x69 */
-      offset += 5;
-      break;
-    case 'k': /* 0x6b: INIT_SUB */
-#if DEBUG
-      printf("'%c' executing SUB: %x\n", id, bios->rom[offset+1]);
-#endif
-      offset += 2;
-      break;
-    case 'n': /* 0x6e */
-#if DEBUG
-      /* +1 = register, +5 = AND-mask, +9 = value */
-      printf("'%c'\t%08x %08x %08x\n", id, READ_LE_INT(bios->rom, offset+1), READ_LE_INT(bios->rom, offset+5), READ_LE_INT(bios->rom, offset+9));
-#endif
-      offset += 13;
-      break;
-    case 'o': /* 0x6f */
-      offset += 2;
-      break;
-    case 'q': /* 0x71: quit */
-      offset += 1;
-      break;
-    case 'r': /* 0x72: INIT_RESUME */
-      offset += 1;
-      break;
-    case 't': /* 0x74 */
-      offset += 3;
-      break;
-    case 'u': /* 0x75: INIT_CONDITION */
-#if DEBUG
-      printf("'%c'\t condition: %d\n", id, bios->rom[offset+1]);
-#endif
-      offset += 2;
-      break;
-    case 'v': /* 0x76: INIT_IO_CONDITION */
-#if DEBUG
-      printf("'%c'\t IO condition: %d\n", id, bios->rom[offset+1]);
-#endif
-      offset += 2;
-      break;
-    case 'x': /* 0x78: INIT_INDEX_IO */
-#if DEBUG
-      /* +1 CRTC reg (16-bit)
-      /  +3 CRTC index (8-bit)
-      /  +4 AND-mask (8-bit)
-      /  +5 OR-with (8-bit)
-      */
-      printf("'%c'\tCRTC reg: %x CRTC index: %x AND-mask: %x OR-with: %x\n", id, READ_LE_SHORT(bios->rom, offset+1), bios->rom[offset+3], bios->rom[offset+4], bios->rom[offset+5]);
-#endif
-      offset += 6;
-      break;
-    case 'y': /* 0x79 */
-#if DEBUG
-      /* +1 = register, +5 = clock */
-      printf("'%c'\t%08x %08x (%dMHz)\n", id, READ_LE_INT(bios->rom, offset+1), READ_LE_SHORT(bios->rom, offset+5), READ_LE_SHORT(bios->rom, offset+5)/100);
-#endif
-      offset += 7;
-      break;
-    case 'z': /* 0x7a: INIT_ZM_REG */
-#if DEBUG
-      /* +1 = register, +5 = value */
-      printf("'%c'\t%08x %08x\n", id, READ_LE_INT(bios->rom, offset+1), READ_LE_INT(bios->rom, offset+5));
-#endif
-      offset += 9;
-      break;
-    case 0x8e: /* 0x8e */
-      /* +1 what is this doing? */
-      offset += 1;
-      break;
-    case 0x8f: /* 0x8f: INIT_ZM_REG */
-#if DEBUG
-      {
-        int i;
-        /* +1 register 
-        /  +5 = length of sequence (?)
-        /  +6 = num entries
-        */
-        int size = bios->rom[offset+5];
-        int number = bios->rom[offset+6];
-        printf("'%c'\treg: %08x size: %d number: %d", id, READ_LE_INT(bios->rom, offset+1), size, number);
-        /* why times 2? */
-        for(i=0; i<number*size*2; i++)
-          printf(" %08x", READ_LE_INT(bios->rom, offset + 7 + i));
-        printf("\n");
-      }
-#endif
-      offset += bios->rom[offset+6] * 32 + 7;
-      break;
-    case 0x90: /* 0x90 */
-      offset += 9;
-      break;
-    case 0x91: /* 0x91 */
-#if DEBUG
-      /* +1 = pll register, +5 = ?, +9 = ?, +13 = ? */
-      printf("'%c'\t%08x %08x\n", id, READ_LE_INT(bios->rom, offset+1), READ_LE_INT(bios->rom, offset+5));
-#endif
-      offset += 18;
-      break;
-    case 0x97: /* 0x97 */
-#if DEBUG
-      printf("'%c'\t%08x %08x\n", id, READ_LE_INT(bios->rom, offset+1), READ_LE_INT(bios->rom, offset+5));
-#endif
-      offset += 13;
-      break;
-    default:
-      printf("Unhandled init script entry with id '%c' at %04x\n", id, offset);
-      return 0;
+    free(bios->pll_lst);
+    bios->pll_lst = NULL;
+    bios->pll_entries = 0;
   }
 
-  return offset;
-}
-
-
-void parse_bit_init_script_table(struct nvbios *bios, int init_offset, int len)
-{
-  int offset;
-//  int done=0;
-  u_char id;
-
-  /* Table 1 */
-  offset = READ_LE_SHORT(bios->rom, init_offset);
+  if(offset + sizeof(struct BitTableHeader) > size)
+  {
+    if(rnw)
+      fprintf(ERR(bios), "Warning: PLL table at %04X is outside the rom\n", offset);
+    return;
+  }
 
-  /* For pipeline modding purposes we cache 0x1540 and for PLL generation the PLLs */
-  id = bios->rom[offset];
-  while(id != 'q')
+  // versions: 0x20, 0x21; the older and newer tables have a different layout
+  if((header->version != 0x20 && header->version != 0x21) || header->start < sizeof(struct BitTableHeader) || header->entry_size < 0x1f)
   {
-    offset = bit_init_script_table_get_next_entry(bios, offset);
-    /* Break out of the loop if we find an unknown entry id */
-    if(!offset)
-      break;
-    id = bios->rom[offset];
+    if(rnw && bios->verbose)
+      fprintf(LOG(bios), "Unsupported PLL table version: %X\n", header->version);
+    return;
+  }
 
-    if(id == 'z')
-    {
-      int reg = READ_LE_INT(bios->rom, offset+1);
-      u_int val = READ_LE_INT(bios->rom, offset+5);
-      switch(reg)
-      {
-        case 0x1540:
-          bios->pipe_cfg = val;
-          break;
-        case 0x4000:
-          bios->nvpll = val;
-          break;
-        case 0x4020:
-          bios->mpll = val;
-          break;
-      }
-    }
+  // In u_int so an entry start past 64K can't wrap around into the rom
+  entry = offset + header->start;
+  num_entries = entry + 0x1f <= size ? (size - entry - 0x1f) / header->entry_size + 1 : 0;
+  if(num_entries < header->num_entries)
+  {
+    if(rnw)
+      fprintf(ERR(bios), "Warning: PLL table truncated to %u of %u entries\n", num_entries, header->num_entries);
   }
+  else
+    num_entries = header->num_entries;
 
-#if DEBUG /* Read all init tables and print some debug info */
-  int i;
-/* Table 1 */
-  offset = READ_LE_SHORT(bios->rom, init_offset);
+  if(rnw)
+  {
+    if(!num_entries || !(bios->pll_lst = calloc(num_entries, sizeof(struct pll))))
+      return;
+    bios->pll_entries = num_entries;
+  }
+  else if(num_entries > bios->pll_entries)
+    num_entries = bios->pll_entries;
 
-  for(i=0; i<=len; i+=2)
+  for(i = 0; i < num_entries; i++)
   {
-    /* Not all tables have to exist */
-    if(!offset)
+    pll = bios->pll_lst + i;
+
+    if(rnw)
     {
-      init_offset += 2;
-      offset = READ_LE_SHORT(bios->rom, init_offset);
-      continue;
+      /* Each type of pll (corresponding to a certain register) has its own limits */
+      pll->reg = READ_LE_INT(bios->rom, entry);
+
+      /* Minimum/maximum frequency each VCO can generate */
+      pll->VCO1.minFreq = READ_LE_SHORT(bios->rom, entry+0x4)*1000;
+      pll->VCO1.maxFreq = READ_LE_SHORT(bios->rom, entry+0x6)*1000;
+      pll->VCO2.minFreq = READ_LE_SHORT(bios->rom, entry+0x8)*1000;
+      pll->VCO2.maxFreq = READ_LE_SHORT(bios->rom, entry+0xa)*1000;
+
+      /* Minimum/maximum input frequency for each VCO */
+      pll->VCO1.minInputFreq = READ_LE_SHORT(bios->rom, entry+0xc)*1000;
+      pll->VCO1.maxInputFreq = READ_LE_SHORT(bios->rom, entry+0xe)*1000;
+      pll->VCO2.minInputFreq = READ_LE_SHORT(bios->rom, entry+0x10)*1000;
+      pll->VCO2.maxInputFreq = READ_LE_SHORT(bios->rom, entry+0x12)*1000;
+
+      /* Low and high values for the dividers and multipliers */
+      pll->VCO1.minN = bios->rom[entry+0x14];
+      pll->VCO1.maxN = bios->rom[entry+0x15];
+      pll->VCO1.minM = bios->rom[entry+0x16];
+      pll->VCO1.maxM = bios->rom[entry+0x17];
+      pll->VCO2.minN = bios->rom[entry+0x18];
+      pll->VCO2.maxN = bios->rom[entry+0x19];
+      pll->VCO2.minM = bios->rom[entry+0x1a];
+      pll->VCO2.maxM = bios->rom[entry+0x1b];
+
+      pll->var1d = bios->rom[entry+0x1d];
+      pll->var1e = bios->rom[entry+0x1e];
     }
-
-    printf("Init script table %d\n", i/2+1);
-    id = bios->rom[offset];
-
-    while(id != 'q')
+    else
     {
-      /* Break out of the loop if we find an unknown entry id */
-      if(!offset)
-        break;
-
-      if(!(id == 'K' || id == 'n' || id == 'x' || id == 'y' || id == 'z'))
-        printf("'%c' (%x)\n", id, id);
-      offset = bit_init_script_table_get_next_entry(bios, offset);
-      id = bios->rom[offset];
+      nv_write32(bios, entry, pll->reg);
+
+      nv_write16(bios, entry+0x4, pll->VCO1.minFreq / 1000);
+      nv_write16(bios, entry+0x6, pll->VCO1.maxFreq / 1000);
+      nv_write16(bios, entry+0x8, pll->VCO2.minFreq / 1000);
+      nv_write16(bios, entry+0xa, pll->VCO2.maxFreq / 1000);
+
+      nv_write16(bios, entry+0xc, pll->VCO1.minInputFreq / 1000);
+      nv_write16(bios, entry+0xe, pll->VCO1.maxInputFreq / 1000);
+      nv_write16(bios, entry+0x10, pll->VCO2.minInputFreq / 1000);
+      nv_write16(bios, entry+0x12, pll->VCO2.maxInputFreq / 1000);
+
+      nv_write8(bios, entry+0x14, pll->VCO1.minN);
+      nv_write8(bios, entry+0x15, pll->VCO1.maxN);
+      nv_write8(bios, entry+0x16, pll->VCO1.minM);
+      nv_write8(bios, entry+0x17, pll->VCO1.maxM);
+      nv_write8(bios, entry+0x18, pll->VCO2.minN);
+      nv_write8(bios, entry+0x19, pll->VCO2.maxN);
+      nv_write8(bios, entry+0x1a, pll->VCO2.minM);
+      nv_write8(bios, entry+0x1b, pll->VCO2.maxM);
+
+      nv_write8(bios, entry+0x1d, pll->var1d);
+      nv_write8(bios, entry+0x1e, pll->var1e);
     }
 
-    /* Pointer to next init table */
-    init_offset += 2;
-    /* Get location of next table */
-    offset = READ_LE_SHORT(bios->rom, init_offset);
-  }
-#endif
-
-}
-
-/* Parse the table containing pll programming limits */
-void parse_bit_pll_table(struct nvbios *bios, u_short offset)
-{
-  struct BitTableHeader *header = (struct BitTableHeader*)(bios->rom+offset);
-  int i;
-
-  offset += header->start;
-  for(i=0; i<header->num_entries; i++)
-  {
-    /* Each type of pll (corresponding to a certain register) has its own limits */
-    bios->pll_lst[i].reg = READ_LE_INT(bios->rom, offset);
-
-    /* Minimum/maximum frequency each VCO can generate */
-    bios->pll_lst[i].VCO1.minFreq = READ_LE_SHORT(bios->rom, offset+0x4)*1000;
-    bios->pll_lst[i].VCO1.maxFreq = READ_LE_SHORT(bios->rom, offset+0x6)*1000;
-    bios->pll_lst[i].VCO2.minFreq = READ_LE_SHORT(bios->rom, offset+0x8)*1000;
-    bios->pll_lst[i].VCO2.maxFreq = READ_LE_SHORT(bios->rom, offset+0xa)*1000;
-
-    /* Minimum/maximum input frequency for each VCO */
-    bios->pll_lst[i].VCO1.minInputFreq = READ_LE_SHORT(bios->rom, offset+0xc)*1000;
-    bios->pll_lst[i].VCO1.maxInputFreq = READ_LE_SHORT(bios->rom, offset+0xe)*1000;
-    bios->pll_lst[i].VCO2.minInputFreq = READ_LE_SHORT(bios->rom, offset+0x10)*1000;
-    bios->pll_lst[i].VCO2.maxInputFreq = READ_LE_SHORT(bios->rom, offset+0x12)*1000;
-
-    /* Low and high values for the dividers and multipliers */
-    bios->pll_lst[i].VCO1.minN = bios->rom[offset+0x14];
-    bios->pll_lst[i].VCO1.maxN = bios->rom[offset+0x15];
-    bios->pll_lst[i].VCO1.minM = bios->rom[offset+0x16];
-    bios->pll_lst[i].VCO1.maxM = bios->rom[offset+0x17];
-    bios->pll_lst[i].VCO2.minN = bios->rom[offset+0x18];
-    bios->pll_lst[i].VCO2.maxN = bios->rom[offset+0x19];
-    bios->pll_lst[i].VCO2.minM = bios->rom[offset+0x1a];
-    bios->pll_lst[i].VCO2.maxM = bios->rom[offset+0x1b];
-
-    bios->pll_lst[i].var1d = bios->rom[offset+0x1d];;
-    bios->pll_lst[i].var1e = bios->rom[offset+0x1e];
-
 #if DEBUG
-    printf("register: %#08x\n", READ_LE_INT(bios->rom, offset));
+    fprintf(LOG(bios), "register: %#08x\n", READ_LE_INT(bios->rom, entry));
 
     /* Minimum/maximum frequency each VCO can generate */
-    printf("minVCO_1: %d\n", READ_LE_SHORT(bios->rom, offset+0x4));
-    printf("maxVCO_1: %d\n", READ_LE_SHORT(bios->rom, offset+0x6));
-    printf("minVCO_2: %d\n", READ_LE_SHORT(bios->rom, offset+0x8));
-    printf("maxVCO_2: %d\n", READ_LE_SHORT(bios->rom, offset+0xa));
+    fprintf(LOG(bios), "minVCO_1: %d\n", READ_LE_SHORT(bios->rom, entry+0x4));
+    fprintf(LOG(bios), "maxVCO_1: %d\n", READ_LE_SHORT(bios->rom, entry+0x6));
+    fprintf(LOG(bios), "minVCO_2: %d\n", READ_LE_SHORT(bios->rom, entry+0x8));
+    fprintf(LOG(bios), "maxVCO_2: %d\n", READ_LE_SHORT(bios->rom, entry+0xa));
 
     /* Minimum/maximum input frequency for each VCO */
-    printf("minVCO_1_in: %d\n", READ_LE_SHORT(bios->rom, offset+0xc));
-    printf("minVCO_2_in: %d\n", READ_LE_SHORT(bios->rom, offset+0xe));
-    printf("maxVCO_1_in: %d\n", READ_LE_SHORT(bios->rom, offset+0x10));
-    printf("maxVCO_2_in: %d\n", READ_LE_SHORT(bios->rom, offset+0x12));
+    fprintf(LOG(bios), "minVCO_1_in: %d\n", READ_LE_SHORT(bios->rom, entry+0xc));
+    fprintf(LOG(bios), "minVCO_2_in: %d\n", READ_LE_SHORT(bios->rom, entry+0xe));
+    fprintf(LOG(bios), "maxVCO_1_in: %d\n", READ_LE_SHORT(bios->rom, entry+0x10));
+    fprintf(LOG(bios), "maxVCO_2_in: %d\n", READ_LE_SHORT(bios->rom, entry+0x12));
 
     /* Low and high values for the dividers and multipliers */
-    printf("N1_low: %d\n", bios->rom[offset+0x14]);
-    printf("N1_high: %d\n", bios->rom[offset+0x15]);
-    printf("M1_low: %d\n", bios->rom[offset+0x16]);
-    printf("M1_high: %d\n", bios->rom[offset+0x17]);
-    printf("N2_low: %d\n", bios->rom[offset+0x18]);
-    printf("N2_high: %d\n", bios->rom[offset+0x19]);
-    printf("M2_low: %d\n", bios->rom[offset+0x1a]);
-    printf("M2_high: %d\n", bios->rom[offset+0x1b]);
+    fprintf(LOG(bios), "N1_low: %d\n", bios->rom[entry+0x14]);
+    fprintf(LOG(bios), "N1_high: %d\n", bios->rom[entry+0x15]);
+    fprintf(LOG(bios), "M1_low: %d\n", bios->rom[entry+0x16]);
+    fprintf(LOG(bios), "M1_high: %d\n", bios->rom[entry+0x17]);
+    fprintf(LOG(bios), "N2_low: %d\n", bios->rom[entry+0x18]);
+    fprintf(LOG(bios), "N2_high: %d\n", bios->rom[entry+0x19]);
+    fprintf(LOG(bios), "M2_low: %d\n", bios->rom[entry+0x1a]);
+    fprintf(LOG(bios), "M2_high: %d\n", bios->rom[entry+0x1b]);
 
     /* What's the purpose of these? */
-    printf("1c: %d\n", bios->rom[offset+0x1c]);
-    printf("1d: %d\n", bios->rom[offset+0x1d]);
-    printf("1e: %d\n", bios->rom[offset+0x1e]);
-    printf("\n");
+    fprintf(LOG(bios), "1c: %d\n", bios->rom[entry+0x1c]);
+    fprintf(LOG(bios), "1d: %d\n", bios->rom[entry+0x1d]);
+    fprintf(LOG(bios), "1e: %d\n", bios->rom[entry+0x1e]);
+    fprintf(LOG(bios), "\n");
 #endif
 
-    bios->pll_entries = i+1;
-    offset += header->entry_size;
+    entry += header->entry_size;
   }
 }
@@ -50,6 +50,14 @@ struct pll
   struct vco VCO2;
 };
 
+/* A string in the rom image; the bios only remembers where it is, see nv_string */
+struct rom_string
+{
+  unsigned short offset;
+  unsigned char len;
+  unsigned char mask; // every byte is stored xor'ed with this
+};
+
 struct sensor
 {
   int slope_div;
@@ -59,11 +67,85 @@ struct sensor
   int temp_correction;
 };
 
-enum { MAX_PERF_LVLS = 0x4, MAX_VOLT_LVLS = 0x8 };
+enum { MAX_PERF_LVLS = 0x4, MAX_VOLT_LVLS = 0x8, MAX_ROM_IMAGES = 0x8 };
+
+/* Offsets of the signatures in the rom, filled in by index_bios; 0 means not found */
+struct rom_index
+{
+  u_short pcir;   // "PCIR"
+  u_short npde;   // "NPDE"
+  u_short nv;     // "0xff 0x7f NV", BMP structure
+  u_short bit;    // "BIT"
+  u_char num_images;
+  u_short images[MAX_ROM_IMAGES]; // "0x55 0xAA" image headers
+};
+
+enum { TABLE_PERF = 0x1, TABLE_VOLT = 0x2, TABLE_TEMP = 0x4, TABLE_STRINGS = 0x8, TABLE_PLL = 0x10, TABLE_ALL = 0x1f, TABLE_HEADER = 0x20, NUM_TABLES = 6 };
+
+/* Offsets of the tables, filled in by parse_bios; the tables themselves are decoded by parse_tables */
+struct rom_tables
+{
+  u_short perf;
+  u_short volt;
+  u_short temp;
+  u_short strings;
+  u_short strings_len;
+  u_short pll;       // the PLL limits from the 'C' BIT entry
+  u_short init;      // the 'I' BIT entry: pointers to the init script table, the condition tables, ...
+  u_char init_len;
+  u_char ram_cfgs;   // number of memory configurations from the 'M' BIT entry; some init opcodes have an entry for each
+  u_short ram_restrict; // the 'M' table mapping the memory strap to one of those configurations
+  u_char volt_first; // the voltage table comes before the temperature table
+  u_char present;    // TABLE_* flags of the tables in the rom
+  u_char parsed;     // TABLE_* flags of the tables which have been decoded
+  u_int fields_crc[NUM_TABLES]; // CRC of the struct nvbios fields of every table as decoded, to tell which ones were edited
+};
+
+enum { MAX_DIRTY_RANGES = 32 };
+
+// these are macros for the caps member of struct nvbios
+
+enum
+{
+  TEMP_CORRECTION = (1 << 0),
+  FNBST_THLD_1 = (1 << 1),
+  FNBST_THLD_2 = (1 << 2),
+  CRTCL_THLD_1 = (1 << 3),
+  CRTCL_THLD_2 = (1 << 4),
+  THRTL_THLD_1 = (1 << 5),
+  THRTL_THLD_2 = (1 << 6)
+};
+
+/* Output formats of print_bios_info; everything but FORMAT_TEXT is meant for machines (see format.c) */
+enum { FORMAT_TEXT = 0, FORMAT_JSON, FORMAT_NDJSON, FORMAT_CSV };
+
+/* The parts of the rom changed by the nv_write* helpers since the last verification, and how the changes since the
+/  last checksum_bios moved the checksum and the CRCs
+*/
+struct rom_dirty
+{
+  struct rom_range
+  {
+    u_int start;
+    u_int end;
+  } ranges[MAX_DIRTY_RANGES];
+  u_short num_ranges;
+  u_char overflow; // more changes than ranges; treat everything as changed
+  u_char tables;   // TABLE_* flags of the tables the changes belong to
+  u_char writer;   // TABLE_* flag of the table being written
+
+  u_char sums_valid; // checksum, crc and fake_crc plus the deltas below describe the rom
+  u_char sum;        // checksum-8 of the image at the last checksum update
+  u_char sum_delta;
+  u_int crc_delta;
+  u_int fake_crc_delta;
+};
+
+struct init_ir;
 
 struct nvbios
 {
-  unsigned char rom[NV_PROM_SIZE]; // raw data from bios
+  unsigned char *rom; // raw data from bios, always NV_PROM_SIZE bytes; mapped by the loaders and released with free_bios
   unsigned int rom_size; //rom_size could be NV_PROM_SIZE or less (multiple of 512 bits)
   unsigned char checksum;
   unsigned int crc;
@@ -73,7 +155,21 @@ struct nvbios
   char force;
   char verbose;
   char pramin_priority;
+  char mmap_output; // write the output file through a shared mapping
+  char format;      // FORMAT_*; the diagnostics move from out to err in the structured formats
+  char find_reg;    // 1: print the init script writes to find_reg_addr instead of the rom information, 2: only those of find_reg_value
+  uint32_t find_reg_addr;
+  uint32_t find_reg_value;
+  char run_init;    // print the registers after running the init scripts instead of the rom information
   uint32_t arch;
+  struct rom_index index;
+  struct rom_tables tables;
+  struct rom_dirty dirty;
+
+  NVCard *card; // mapped card to shadow the bios from; not needed for files
+  const char *filename; // file the bios was loaded from; NULL for cards
+  FILE *out;  // info and diagnostics; stdout when NULL
+  FILE *err;  // warnings and errors; stderr when NULL
 
   unsigned short subven_id;
   unsigned short subsys_id;
@@ -82,11 +178,11 @@ struct nvbios
   unsigned char hierarchy_id;
   unsigned char major; // non-modifiable
   unsigned char minor; // non-modifiable
-  char build_date[9];
-  char mod_date[9];
-  char adapter_name[64];
-  char vendor_name[64];
-  char str[8][256];
+  struct rom_string build_date;
+  struct rom_string mod_date;
+  const char *adapter_name;
+  const char *vendor_name;
+  struct rom_string str[8];
   char version[2][20];
 
   unsigned short text_time;
@@ -114,8 +210,8 @@ struct nvbios
   unsigned short active_perf_entries;
   struct performance perf_lst[MAX_PERF_LVLS];
 
-  unsigned short pll_entries; // non-displayable, non-modifiable
-  struct pll pll_lst[16];     // non-displayable, non-modifiable
+  unsigned short pll_entries; // non-modifiable
+  struct pll *pll_lst;        // allocated by parse_bit_pll_table, released with free_bios
 
   struct sensor sensor_cfg;   // non-displayable, non-modifiable
 
@@ -126,14 +222,17 @@ struct nvbios
 
   /* Used to cache the NV4x pipe_cfg register */
   unsigned int pipe_cfg;     // non-displayable, non-modifiable
+
+  struct init_ir *init_ir;   // the decoded init scripts, see init.c; released with free_bios
 };
 
-void nv_read(struct nvbios *, char *, u_short);
-void nv_write(struct nvbios *bios, char *, u_short);
-void nv_read_segment(struct nvbios *bios, char *str, u_short offset, u_short len);
-void nv_write_segment(struct nvbios *bios, char *str, u_short offset, u_short len);
-void nv_read_masked_segment(struct nvbios *, char *, u_short, u_short, u_char);
-void nv_write_masked_segment(struct nvbios *, char *, u_short, u_short, u_char);
+void nv_read(struct nvbios *, struct rom_string *, u_short);
+void nv_read_segment(struct nvbios *, struct rom_string *, u_short, u_char);
+void nv_read_masked_segment(struct nvbios *, struct rom_string *, u_short, u_char, u_char);
+char *nv_string(struct nvbios *, const struct rom_string *, char *);
+void nv_write8(struct nvbios *, u_int, u_char);
+void nv_write16(struct nvbios *, u_int, u_short);
+void nv_write32(struct nvbios *, u_int, u_int);
 
 void bios_version_to_str(char *, int);
 int str_to_bios_version(char *);
@@ -151,21 +250,26 @@ void parse_bit_structure(struct nvbios *, u_int, char);
 
 u_int locate_segment(struct nvbios *, u_char *, u_short, u_short);
 u_int locate_masked_segment(struct nvbios *, u_char *, u_char *, u_short, u_short);
+u_int locate_masked_segments(struct nvbios *, u_char *, u_char *, u_short, u_short, u_int *, u_int);
 u_int get_rom_size(struct nvbios *);
+void index_bios(struct nvbios *);
+void checksum_bios(struct nvbios *, char);
+void update_checksum(struct nvbios *, char);
+void free_bios(struct nvbios *);
 int verify_bios(struct nvbios *);
 int read_bios(struct nvbios *, const char *);
 int write_bios(struct nvbios *, const char *);
 int parse_bios(struct nvbios *, char);
+int parse_tables(struct nvbios *, u_int);
 
 int load_bios_file(struct nvbios *, const char *);
 int load_bios_pramin(struct nvbios *);
 int load_bios_prom(struct nvbios *);
+int load_bios_sysfs(struct nvbios *);
 
 void print_bios_info(struct nvbios *);
 
 int set_speaker(struct nvbios *, char);
 int disable_print(struct nvbios *, char);
 
-int bit_init_script_table_get_next_entry(struct nvbios *, int);
-void parse_bit_init_script_table(struct nvbios *, int, int);
-void parse_bit_pll_table(struct nvbios *, u_short);
+void parse_bit_pll_table(struct nvbios *, u_short, char);
@@ -0,0 +1 @@
+#undef NHALE_BIG_ENDIAN
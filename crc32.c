@@ -50,6 +50,11 @@
 // Find a four-byte integer type for crc32_little() and crc32_big().
 #include <stdint.h>
 
+#if defined(__x86_64__) || defined(__i386__)
+  #include <immintrin.h>
+  #define NHALE_X86
+#endif
+
 static const unsigned long crc_table[8][256] =
 {
   {
@@ -504,7 +509,7 @@ unsigned int crc32_little(unsigned long crc, const unsigned char *buf, unsigned
 
     c = (uint32_t)crc;
     c = ~c;
-    while (len && ((int)buf & 3)) {
+    while (len && ((uintptr_t)buf & 3)) {
         c = crc_table[0][(c ^ *buf++) & 0xff] ^ (c >> 8);
         len--;
     }
@@ -541,7 +546,7 @@ unsigned int crc32_big(unsigned long crc, const unsigned char *buf, unsigned len
 
     c = REV((uint32_t)crc);
     c = ~c;
-    while (len && ((int)buf & 3)) {
+    while (len && ((uintptr_t)buf & 3)) {
         c = crc_table[4][(c >> 24) ^ *buf++] ^ (c << 8);
         len--;
     }
@@ -565,3 +570,261 @@ unsigned int crc32_big(unsigned long crc, const unsigned char *buf, unsigned len
     c = ~c;
     return (unsigned int)(REV(c));
 }
+
+#ifdef NHALE_X86
+// =========================================================================
+/* Carry-less multiplication folding as described in Intel's "Fast CRC Computation
+   for Generic Polynomials Using PCLMULQDQ Instruction" (Gopal et al., 2009).
+   The constants are the bit-reflected x^n mod P(x) values for the gzip polynomial.
+   crc is the raw shift register (not inverted), len must be at least 64 and a multiple of 16.
+   When sum is not NULL the bytes are also added up (psadbw) while they are in registers anyway.
+ */
+__attribute__((target("sse2,pclmul"), always_inline))
+static inline uint32_t crc32_pclmul_body(uint32_t crc, const unsigned char *buf, unsigned len, uint64_t *sum)
+{
+    static const uint64_t k1k2[2] __attribute__((aligned(16))) = { 0x0154442bd4ULL, 0x01c6e41596ULL };
+    static const uint64_t k3k4[2] __attribute__((aligned(16))) = { 0x01751997d0ULL, 0x00ccaa009eULL };
+    static const uint64_t k5k0[2] __attribute__((aligned(16))) = { 0x0163cd6124ULL, 0x0000000000ULL };
+    static const uint64_t poly[2] __attribute__((aligned(16))) = { 0x01db710641ULL, 0x01f7011641ULL };
+    const __m128i zero = _mm_setzero_si128();
+    __m128i x0, x1, x2, x3, x4, x5, x6, x7, x8, y5, y6, y7, y8, s = zero;
+
+    // Four 128 bit lanes
+    x1 = _mm_loadu_si128((const __m128i *)(buf + 0x00));
+    x2 = _mm_loadu_si128((const __m128i *)(buf + 0x10));
+    x3 = _mm_loadu_si128((const __m128i *)(buf + 0x20));
+    x4 = _mm_loadu_si128((const __m128i *)(buf + 0x30));
+    if (sum)
+        s = _mm_add_epi64(_mm_add_epi64(_mm_sad_epu8(x1, zero), _mm_sad_epu8(x2, zero)),
+                          _mm_add_epi64(_mm_sad_epu8(x3, zero), _mm_sad_epu8(x4, zero)));
+    x1 = _mm_xor_si128(x1, _mm_cvtsi32_si128(crc));
+    x0 = _mm_load_si128((const __m128i *)k1k2);
+    buf += 64;
+    len -= 64;
+
+    // Fold 64 bytes at a time
+    while (len >= 64) {
+        x5 = _mm_clmulepi64_si128(x1, x0, 0x00);
+        x6 = _mm_clmulepi64_si128(x2, x0, 0x00);
+        x7 = _mm_clmulepi64_si128(x3, x0, 0x00);
+        x8 = _mm_clmulepi64_si128(x4, x0, 0x00);
+        x1 = _mm_clmulepi64_si128(x1, x0, 0x11);
+        x2 = _mm_clmulepi64_si128(x2, x0, 0x11);
+        x3 = _mm_clmulepi64_si128(x3, x0, 0x11);
+        x4 = _mm_clmulepi64_si128(x4, x0, 0x11);
+        y5 = _mm_loadu_si128((const __m128i *)(buf + 0x00));
+        y6 = _mm_loadu_si128((const __m128i *)(buf + 0x10));
+        y7 = _mm_loadu_si128((const __m128i *)(buf + 0x20));
+        y8 = _mm_loadu_si128((const __m128i *)(buf + 0x30));
+        if (sum)
+            s = _mm_add_epi64(s, _mm_add_epi64(_mm_add_epi64(_mm_sad_epu8(y5, zero), _mm_sad_epu8(y6, zero)),
+                                               _mm_add_epi64(_mm_sad_epu8(y7, zero), _mm_sad_epu8(y8, zero))));
+        x1 = _mm_xor_si128(_mm_xor_si128(x1, x5), y5);
+        x2 = _mm_xor_si128(_mm_xor_si128(x2, x6), y6);
+        x3 = _mm_xor_si128(_mm_xor_si128(x3, x7), y7);
+        x4 = _mm_xor_si128(_mm_xor_si128(x4, x8), y8);
+        buf += 64;
+        len -= 64;
+    }
+
+    // Fold the four lanes into one
+    x0 = _mm_load_si128((const __m128i *)k3k4);
+    x5 = _mm_clmulepi64_si128(x1, x0, 0x00);
+    x1 = _mm_clmulepi64_si128(x1, x0, 0x11);
+    x1 = _mm_xor_si128(_mm_xor_si128(x1, x2), x5);
+    x5 = _mm_clmulepi64_si128(x1, x0, 0x00);
+    x1 = _mm_clmulepi64_si128(x1, x0, 0x11);
+    x1 = _mm_xor_si128(_mm_xor_si128(x1, x3), x5);
+    x5 = _mm_clmulepi64_si128(x1, x0, 0x00);
+    x1 = _mm_clmulepi64_si128(x1, x0, 0x11);
+    x1 = _mm_xor_si128(_mm_xor_si128(x1, x4), x5);
+
+    // Fold the remaining 16 byte blocks
+    while (len >= 16) {
+        x2 = _mm_loadu_si128((const __m128i *)buf);
+        if (sum)
+            s = _mm_add_epi64(s, _mm_sad_epu8(x2, zero));
+        x5 = _mm_clmulepi64_si128(x1, x0, 0x00);
+        x1 = _mm_clmulepi64_si128(x1, x0, 0x11);
+        x1 = _mm_xor_si128(_mm_xor_si128(x1, x2), x5);
+        buf += 16;
+        len -= 16;
+    }
+
+    // 128 bits to 64 bits
+    x2 = _mm_clmulepi64_si128(x1, x0, 0x10);
+    x3 = _mm_setr_epi32(~0, 0, ~0, 0);
+    x1 = _mm_srli_si128(x1, 8);
+    x1 = _mm_xor_si128(x1, x2);
+    x0 = _mm_loadl_epi64((const __m128i *)k5k0);
+    x2 = _mm_srli_si128(x1, 4);
+    x1 = _mm_and_si128(x1, x3);
+    x1 = _mm_clmulepi64_si128(x1, x0, 0x00);
+    x1 = _mm_xor_si128(x1, x2);
+
+    // Barrett reduction to 32 bits
+    x0 = _mm_load_si128((const __m128i *)poly);
+    x2 = _mm_and_si128(x1, x3);
+    x2 = _mm_clmulepi64_si128(x2, x0, 0x10);
+    x2 = _mm_and_si128(x2, x3);
+    x2 = _mm_clmulepi64_si128(x2, x0, 0x00);
+    x1 = _mm_xor_si128(x1, x2);
+
+    if (sum) {
+        uint64_t lanes[2];
+
+        _mm_storeu_si128((__m128i *)lanes, s);
+        *sum += lanes[0] + lanes[1];
+    }
+
+    return (uint32_t)_mm_cvtsi128_si32(_mm_srli_si128(x1, 4));
+}
+
+__attribute__((target("sse2,pclmul")))
+static uint32_t crc32_pclmul_fold(uint32_t crc, const unsigned char *buf, unsigned len)
+{
+    return crc32_pclmul_body(crc, buf, len, NULL);
+}
+
+__attribute__((target("sse2,pclmul")))
+static uint32_t crc32_pclmul_fold_sum(uint32_t crc, const unsigned char *buf, unsigned len, uint64_t *sum)
+{
+    return crc32_pclmul_body(crc, buf, len, sum);
+}
+#endif
+
+// =========================================================================
+/* Same result as crc32_little() but uses carry-less multiplication when the cpu
+   has it; the table is only used for the tail and on other cpus.
+ */
+unsigned int crc32_fast(unsigned long crc, const unsigned char *buf, unsigned len)
+{
+#ifdef NHALE_X86
+    if (len >= 64 && __builtin_cpu_supports("pclmul")) {
+        unsigned chunk = len & ~15U;
+
+        crc = ~crc32_pclmul_fold(~(uint32_t)crc, buf, chunk);
+        buf += chunk;
+        len -= chunk;
+    }
+#endif
+    return crc32_little(crc, buf, len);
+}
+
+// =========================================================================
+/* Byte sum and table crc over blocks small enough to still be in the L1 cache
+   when the crc runs over them.
+ */
+static unsigned long crc32_sum_blocks(unsigned long crc, const unsigned char *buf, unsigned len, uint64_t *sum,
+                                      unsigned int (*table_crc)(unsigned long, const unsigned char *, unsigned))
+{
+    unsigned block, i;
+
+    while (len) {
+        block = len < 4096 ? len : 4096;
+        for (i = 0; i < block; i++)
+            *sum += buf[i];
+        crc = table_crc(crc, buf, block);
+        buf += block;
+        len -= block;
+    }
+    return crc;
+}
+
+// =========================================================================
+/* crc32_fast() that also returns the 8 bit sum of the bytes in *sum while
+   reading the buffer only once.
+ */
+unsigned int crc32_sum8(unsigned long crc, const unsigned char *buf, unsigned len, unsigned char *sum)
+{
+    uint64_t s = 0;
+
+#ifdef NHALE_X86
+    if (len >= 64 && __builtin_cpu_supports("pclmul")) {
+        unsigned chunk = len & ~15U;
+
+        crc = ~crc32_pclmul_fold_sum(~(uint32_t)crc, buf, chunk, &s);
+        buf += chunk;
+        len -= chunk;
+    }
+#endif
+    crc = crc32_sum_blocks(crc, buf, len, &s, crc32_little);
+
+    *sum = (unsigned char)s;
+    return (unsigned int)crc;
+}
+
+// =========================================================================
+/* Same as crc32_sum8() for big endian hosts */
+unsigned int crc32_sum8_big(unsigned long crc, const unsigned char *buf, unsigned len, unsigned char *sum)
+{
+    uint64_t s = 0;
+
+    crc = crc32_sum_blocks(crc, buf, len, &s, crc32_big);
+
+    *sum = (unsigned char)s;
+    return (unsigned int)crc;
+}
+
+// =========================================================================
+/* Arithmetic modulo the crc polynomial as in crc32_combine() of later zlib
+   versions; polynomials are bit reversed with x^0 in the top bit.
+ */
+static const uint32_t x2n_table[32] = {
+    0x40000000, 0x20000000, 0x08000000, 0x00800000,
+    0x00008000, 0xedb88320, 0xb1e6b092, 0xa06a2517,
+    0xed627dae, 0x88d14467, 0xd7bbfe6a, 0xec447f11,
+    0x8e7ea170, 0x6427800e, 0x4d47bae0, 0x09fe548f,
+    0x83852d0f, 0x30362f1a, 0x7b5a9cc3, 0x31fec169,
+    0x9fec022a, 0x6c8dedc4, 0x15d6874d, 0x5fde7a4e,
+    0xbad90e37, 0x2e4e5eef, 0x4eaba214, 0xa8a472c0,
+    0x429a969e, 0x148d302a, 0xc40ba6d0, 0xc4e22c3c
+};
+
+/* a(x) * b(x) modulo p(x) */
+static uint32_t multmodp(uint32_t a, uint32_t b)
+{
+    uint32_t m = (uint32_t)1 << 31, p = 0;
+
+    for (;;) {
+        if (a & m) {
+            p ^= b;
+            if ((a & (m - 1)) == 0)
+                break;
+        }
+        m >>= 1;
+        b = b & 1 ? (b >> 1) ^ 0xedb88320 : b >> 1;
+    }
+    return p;
+}
+
+/* x^(n * 2^k) modulo p(x) */
+static uint32_t x2nmodp(unsigned n, unsigned k)
+{
+    uint32_t p = (uint32_t)1 << 31;
+
+    while (n) {
+        if (n & 1)
+            p = multmodp(x2n_table[k & 31], p);
+        n >>= 1;
+        k++;
+    }
+    return p;
+}
+
+// =========================================================================
+/* When n bytes at offset of a len byte buffer change by delta (old ^ new)
+   the crc of the buffer changes by crc32_patch(len, offset, delta, n); the
+   crc of the edited buffer is the old crc xor this value.
+ */
+unsigned int crc32_patch(unsigned len, unsigned offset, const unsigned char *delta, unsigned n)
+{
+    uint32_t c = 0;
+    unsigned i;
+
+    /* crc of the delta without pre and post conditioning, then shifted over
+       the bytes which follow it */
+    for (i = 0; i < n; i++)
+        c = crc_table[0][(c ^ delta[i]) & 0xff] ^ (c >> 8);
+    return multmodp(x2nmodp(len - offset - n, 3), c);
+}
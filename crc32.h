@@ -4,3 +4,7 @@
 
 unsigned int crc32_little(unsigned long, const unsigned char *, unsigned);
 unsigned int crc32_big(unsigned long, const unsigned char *, unsigned);
+unsigned int crc32_fast(unsigned long, const unsigned char *, unsigned);
+unsigned int crc32_sum8(unsigned long, const unsigned char *, unsigned, unsigned char *);
+unsigned int crc32_sum8_big(unsigned long, const unsigned char *, unsigned, unsigned char *);
+unsigned int crc32_patch(unsigned, unsigned, const unsigned char *, unsigned);
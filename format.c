@@ -0,0 +1,576 @@
+/*
+ * Copyright(C) 2010 Andrew Powell
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA 02111-1307, USA
+ */
+
+#include <stdarg.h>
+#include <stdio.h>
+#include <stdint.h>
+#include <string.h>
+#include <sys/types.h>
+#include "backend.h"
+#include "bios.h"
+#include "format.h"
+
+/* Structured output: every field print_bios_info shows, written through one small buffered writer as
+/    json   - one pretty printed object per bios (an array of them in batch mode)
+/    ndjson - one object per line
+/    csv    - one row per bios under a header line; the lists are flattened into fixed columns (perf0_nvclk, ...)
+/
+/  The same emit code produces all three and the csv header, so the columns can never go out of sync with the rows.
+/  Fields which do not apply to a bios are null in json and empty in csv, they are never left out.
+*/
+
+enum { WRITER_BUF_SIZE = 4096, WRITER_MAX_DEPTH = 8 };
+
+struct writer
+{
+  FILE *fp;
+  char format;
+  char header;         // csv: write the column names instead of the values
+  char blank;          // write every value as null; for the padding entries of the csv lists
+  u_char depth;
+  u_int nonempty;      // bit per depth: something has been written at that level
+  const char *prefix;  // csv: name of the list being written
+  int item;            // csv: index of the list entry being written
+  u_int len;
+  char buf[WRITER_BUF_SIZE];
+};
+
+static void w_flush(struct writer *w)
+{
+  if(w->len)
+    fwrite(w->buf, 1, w->len, w->fp);
+  w->len = 0;
+}
+
+static void w_putc(struct writer *w, char c)
+{
+  if(w->len == WRITER_BUF_SIZE)
+    w_flush(w);
+  w->buf[w->len++] = c;
+}
+
+static void w_printf(struct writer *w, const char *fmt, ...)
+{
+  va_list ap;
+  int n;
+
+  va_start(ap, fmt);
+  n = vsnprintf(w->buf + w->len, WRITER_BUF_SIZE - w->len, fmt, ap);
+  va_end(ap);
+
+  // Didn't fit; flush and try once more, nothing this file prints comes close to the buffer size
+  if(n >= 0 && (u_int)n >= WRITER_BUF_SIZE - w->len)
+  {
+    w_flush(w);
+    va_start(ap, fmt);
+    n = vsnprintf(w->buf, WRITER_BUF_SIZE, fmt, ap);
+    va_end(ap);
+  }
+
+  if(n > 0)
+    w->len += (u_int)n < WRITER_BUF_SIZE - w->len ? (u_int)n : WRITER_BUF_SIZE - w->len - 1;
+}
+
+static void w_newline(struct writer *w)
+{
+  u_int i;
+
+  if(w->format != FORMAT_JSON)
+    return;
+
+  w_putc(w, '\n');
+  for(i = 0; i < w->depth; i++)
+    w_printf(w, "  ");
+}
+
+// The separator and name of the next field; returns 0 if the value should not be written
+static int w_key(struct writer *w, const char *key)
+{
+  u_int bit = 1 << w->depth;
+
+  if(w->format == FORMAT_CSV)
+  {
+    if(w->nonempty & 1)
+      w_putc(w, ',');
+    w->nonempty |= 1;
+
+    if(!w->header)
+      return 1;
+
+    if(w->prefix)
+      w_printf(w, "%s%d_%s", w->prefix, w->item, key);
+    else
+      w_printf(w, "%s", key);
+    return 0;
+  }
+
+  if(w->nonempty & bit)
+    w_putc(w, ',');
+  w->nonempty |= bit;
+  w_newline(w);
+
+  if(key)
+    w_printf(w, w->format == FORMAT_JSON ? "\"%s\": " : "\"%s\":", key);
+  return 1;
+}
+
+static void w_null(struct writer *w)
+{
+  if(w->format != FORMAT_CSV)
+    w_printf(w, "null");
+}
+
+static void w_str(struct writer *w, const char *key, const char *value)
+{
+  const u_char *p;
+  int quote;
+
+  if(!w_key(w, key))
+    return;
+
+  if(!value || w->blank)
+  {
+    w_null(w);
+    return;
+  }
+
+  if(w->format == FORMAT_CSV)
+  {
+    quote = strpbrk(value, ",\"\r\n") != NULL;
+    if(quote)
+      w_putc(w, '"');
+    for(p = (const u_char *)value; *p; p++)
+    {
+      if(*p == '"')
+        w_putc(w, '"');
+      w_putc(w, *p);
+    }
+    if(quote)
+      w_putc(w, '"');
+    return;
+  }
+
+  // Bytes outside of ASCII are taken as latin-1 so the output is always valid UTF-8
+  w_putc(w, '"');
+  for(p = (const u_char *)value; *p; p++)
+  {
+    if(*p == '"' || *p == '\\')
+    {
+      w_putc(w, '\\');
+      w_putc(w, *p);
+    }
+    else if(*p < 0x20 || *p >= 0x7f)
+      w_printf(w, "\\u%04x", *p);
+    else
+      w_putc(w, *p);
+  }
+  w_putc(w, '"');
+}
+
+static void w_uint(struct writer *w, const char *key, u_int value)
+{
+  if(!w_key(w, key))
+    return;
+  if(w->blank)
+    w_null(w);
+  else
+    w_printf(w, "%u", value);
+}
+
+static void w_int(struct writer *w, const char *key, int value)
+{
+  if(!w_key(w, key))
+    return;
+  if(w->blank)
+    w_null(w);
+  else
+    w_printf(w, "%d", value);
+}
+
+static void w_bool(struct writer *w, const char *key, int value)
+{
+  if(!w_key(w, key))
+    return;
+  if(w->blank)
+    w_null(w);
+  else if(w->format == FORMAT_CSV)
+    w_printf(w, "%d", value ? 1 : 0);
+  else
+    w_printf(w, value ? "true" : "false");
+}
+
+// Ids, masks and sums are written in hex like in the text output, as strings so json readers keep the leading zeros
+static void w_hex(struct writer *w, const char *key, u_int value, int digits)
+{
+  char str[16];
+
+  snprintf(str, sizeof(str), "%0*X", digits, value);
+  w_str(w, key, str);
+}
+
+// Voltages are stored in multiples of 10mV
+static void w_volts(struct writer *w, const char *key, u_int value)
+{
+  if(!w_key(w, key))
+    return;
+  if(w->blank)
+    w_null(w);
+  else
+    w_printf(w, "%1.2f", (float)value / 100.0);
+}
+
+static void w_begin(struct writer *w, char c)
+{
+  if(w->format != FORMAT_CSV)
+  {
+    w_putc(w, c);
+    if(w->depth + 1 < WRITER_MAX_DEPTH)
+      w->depth++;
+    w->nonempty &= ~(1 << w->depth);
+  }
+}
+
+static void w_end(struct writer *w, char c)
+{
+  if(w->format != FORMAT_CSV)
+  {
+    int nonempty = w->nonempty & (1 << w->depth);
+
+    w->depth--;
+    if(nonempty)
+      w_newline(w);
+    w_putc(w, c);
+  }
+}
+
+static void w_begin_list(struct writer *w, const char *key)
+{
+  if(w->format == FORMAT_CSV)
+    w->prefix = key;
+  else
+  {
+    w_key(w, key);
+    w_begin(w, '[');
+  }
+}
+
+static void w_end_list(struct writer *w)
+{
+  w->prefix = NULL;
+  w->blank = 0;
+  w_end(w, ']');
+}
+
+// blank entries are only written to pad the csv columns
+static void w_begin_item(struct writer *w, int item, int blank)
+{
+  w->item = item;
+  w->blank = blank || w->header;
+  if(w->format != FORMAT_CSV)
+  {
+    w_key(w, NULL);
+    w_begin(w, '{');
+  }
+}
+
+static void w_end_item(struct writer *w)
+{
+  w_end(w, '}');
+}
+
+/* ---- the fields ---- */
+
+// A string from the rom without the line breaks some of them end with; NULL when it can't or need not be read
+static const char *rom_str(struct writer *w, struct nvbios *bios, const struct rom_string *str, char *buf, int present)
+{
+  u_int len;
+
+  if(w->header || !present)
+    return NULL;
+
+  nv_string(bios, str, buf);
+  for(len = strlen(buf); len && (buf[len-1] == '\r' || buf[len-1] == '\n' || buf[len-1] == ' '); len--);
+  buf[len] = 0;
+  return buf;
+}
+
+static const char *hierarchy_str(u_char hierarchy_id, char *buf)
+{
+  switch(hierarchy_id)
+  {
+    case 0:
+      return "None";
+    case 1:
+      return "Normal Board";
+    case 2:
+    case 3:
+    case 4:
+    case 5:
+      sprintf(buf, "Switch Port %u", hierarchy_id - 2);
+      return buf;
+    default:
+      sprintf(buf, "%X", hierarchy_id);
+      return buf;
+  }
+}
+
+static void emit_perf(struct writer *w, struct nvbios *bios)
+{
+  u_int i, num = w->format == FORMAT_CSV ? MAX_PERF_LVLS : bios->perf_entries;
+
+  w_begin_list(w, "perf");
+  for(i = 0; i < num; i++)
+  {
+    struct performance *perf = bios->perf_lst + i;
+    u_int nvclk = perf->nvclk, memclk = perf->memclk;
+
+    w_begin_item(w, i, i >= bios->perf_entries);
+
+    // Same scaling as the text output
+    if(bios->arch & NV3X)
+    {
+      nvclk = (nvclk / 100) & 0xFFFF;
+      memclk = (memclk / 50) & 0xFFFF;
+    }
+
+    w_uint(w, "level", i);
+    w_bool(w, "active", i < bios->active_perf_entries);
+    w_uint(w, "nvclk", nvclk);
+    if(bios->arch & NV5X)
+      w_uint(w, "shaderclk", perf->shaderclk);
+    else
+      w_str(w, "shaderclk", NULL);
+    w_uint(w, "memclk", memclk);
+    w_volts(w, "voltage", perf->voltage);
+    w_uint(w, "fanspeed", perf->fanspeed);
+    if(bios->arch & NV4X)
+      w_hex(w, "lock", perf->lock, 1);
+    else
+      w_str(w, "lock", NULL);
+
+    w_end_item(w);
+  }
+  w_end_list(w);
+}
+
+static void emit_volt(struct writer *w, struct nvbios *bios)
+{
+  u_int i, num = w->format == FORMAT_CSV ? MAX_VOLT_LVLS : bios->volt_entries;
+
+  if(bios->volt_entries && !w->header)
+    w_hex(w, "vid_mask", bios->volt_mask, 2);
+  else
+    w_str(w, "vid_mask", NULL);
+
+  w_begin_list(w, "volt");
+  for(i = 0; i < num; i++)
+  {
+    w_begin_item(w, i, i >= bios->volt_entries);
+    w_uint(w, "level", i);
+    w_bool(w, "active", i < bios->active_volt_entries);
+    w_volts(w, "voltage", bios->volt_lst[i].voltage);
+    w_hex(w, "vid", bios->volt_lst[i].VID, 2);
+    w_end_item(w);
+  }
+  w_end_list(w);
+}
+
+// The PLL limits have no fixed number of entries so they can't be csv columns
+static void emit_pll(struct writer *w, struct nvbios *bios)
+{
+  u_int i;
+
+  if(w->format == FORMAT_CSV)
+    return;
+
+  w_begin_list(w, "pll");
+  for(i = 0; i < bios->pll_entries; i++)
+  {
+    struct pll *pll = bios->pll_lst + i;
+
+    w_begin_item(w, i, 0);
+    w_hex(w, "register", pll->reg, 8);
+    w_uint(w, "vco1_min_freq", pll->VCO1.minFreq);
+    w_uint(w, "vco1_max_freq", pll->VCO1.maxFreq);
+    w_uint(w, "vco1_min_input_freq", pll->VCO1.minInputFreq);
+    w_uint(w, "vco1_max_input_freq", pll->VCO1.maxInputFreq);
+    w_uint(w, "vco1_min_n", pll->VCO1.minN);
+    w_uint(w, "vco1_max_n", pll->VCO1.maxN);
+    w_uint(w, "vco1_min_m", pll->VCO1.minM);
+    w_uint(w, "vco1_max_m", pll->VCO1.maxM);
+    w_uint(w, "vco2_min_freq", pll->VCO2.minFreq);
+    w_uint(w, "vco2_max_freq", pll->VCO2.maxFreq);
+    w_uint(w, "vco2_min_input_freq", pll->VCO2.minInputFreq);
+    w_uint(w, "vco2_max_input_freq", pll->VCO2.maxInputFreq);
+    w_uint(w, "vco2_min_n", pll->VCO2.minN);
+    w_uint(w, "vco2_max_n", pll->VCO2.maxN);
+    w_uint(w, "vco2_min_m", pll->VCO2.minM);
+    w_uint(w, "vco2_max_m", pll->VCO2.maxM);
+    w_uint(w, "max_log2p", pll->var1d);
+    w_uint(w, "log2p_bias", pll->var1e);
+    w_end_item(w);
+  }
+  w_end_list(w);
+}
+
+static void emit_threshold(struct writer *w, struct nvbios *bios, const char *key, int cap, int value)
+{
+  if(bios->caps & cap)
+    w_int(w, key, value);
+  else
+    w_str(w, key, NULL);
+}
+
+static void emit_bios(struct writer *w, struct nvbios *bios)
+{
+  static const char *str_keys[8] = { "sign_on", "version_str", "copyright", "oem", "vesa_vendor", "vesa_name", "vesa_revision", "release" };
+  int bit = bios->arch > NV3X;
+  char buf[256], source[32];
+  u_int i;
+
+  w->blank = w->header;
+
+  if(bios->filename)
+    w_str(w, "source", bios->filename);
+  else if(bios->card)
+  {
+    snprintf(source, sizeof(source), "%04x:%02x:%02x.%x", bios->card->domain, bios->card->bus, bios->card->device, bios->card->function);
+    w_str(w, "source", source);
+  }
+  else
+    w_str(w, "source", NULL);
+
+  w_str(w, "adapter", bios->adapter_name);
+  w_str(w, "vendor", "Nvidia");
+  w_str(w, "subvendor", bios->vendor_name);
+  w_uint(w, "rom_size", bios->rom_size);
+  w_hex(w, "checksum", bios->checksum, 2);
+  w_hex(w, "crc32", bios->crc, 8);
+  w_str(w, "version", w->header ? NULL : bios->version[0]);
+  w_str(w, "version2", bit && !w->header ? bios->version[1] : NULL);
+  w_hex(w, "device_id", bios->device_id, 4);
+  w_hex(w, "subvendor_id", bios->subven_id, 4);
+  w_hex(w, "subsystem_id", bios->subsys_id, 4);
+
+  if(bit)
+    w_hex(w, "board_id", bios->board_id, 4);
+  else
+    w_str(w, "board_id", NULL);
+
+  w_str(w, "hierarchy", bit && !w->header ? hierarchy_str(bios->hierarchy_id, buf) : NULL);
+  w_str(w, "build_date", rom_str(w, bios, &bios->build_date, buf, bit));
+  w_str(w, "mod_date", rom_str(w, bios, &bios->mod_date, buf, 1));
+
+  for(i = 0; i < 8; i++)
+    w_str(w, str_keys[i], rom_str(w, bios, &bios->str[i], buf, !i || bit));
+
+  if(bit)
+    w_uint(w, "text_time", bios->text_time);
+  else
+    w_str(w, "text_time", NULL);
+
+  if(!bit && !w->header)
+  {
+    snprintf(buf, sizeof(buf), "%x.%x", bios->major, bios->minor);
+    w_str(w, "bmp_version", buf);
+  }
+  else
+    w_str(w, "bmp_version", NULL);
+
+  emit_perf(w, bios);
+  emit_volt(w, bios);
+
+  w->blank = w->header;
+  emit_threshold(w, bios, "temp_correction", TEMP_CORRECTION, bios->temp_correction);
+  emit_threshold(w, bios, "fanboost_int_thld", FNBST_THLD_1, bios->fnbst_int_thld);
+  emit_threshold(w, bios, "fanboost_ext_thld", FNBST_THLD_2, bios->fnbst_ext_thld);
+  emit_threshold(w, bios, "throttle_int_thld", THRTL_THLD_1, bios->thrtl_int_thld);
+  emit_threshold(w, bios, "throttle_ext_thld", THRTL_THLD_2, bios->thrtl_ext_thld);
+  emit_threshold(w, bios, "critical_int_thld", CRTCL_THLD_1, bios->crtcl_int_thld);
+  emit_threshold(w, bios, "critical_ext_thld", CRTCL_THLD_2, bios->crtcl_ext_thld);
+
+  emit_pll(w, bios);
+}
+
+static void writer_init(struct writer *w, FILE *fp, int format)
+{
+  memset(w, 0, sizeof(struct writer) - WRITER_BUF_SIZE);
+  w->fp = fp;
+  w->format = format;
+}
+
+// One record for the bios on its out stream; the tables must have been parsed (print_bios_info does that)
+void print_bios_record(struct nvbios *bios)
+{
+  struct writer w;
+
+  writer_init(&w, bios->out ? bios->out : stdout, bios->format);
+
+  w_begin(&w, '{');
+  emit_bios(&w, bios);
+  w_end(&w, '}');
+  w_putc(&w, '\n');
+  w_flush(&w);
+}
+
+// Returns the FORMAT_* for a --format argument or -1
+int str_to_format(const char *str)
+{
+  static const char *names[] = { "text", "json", "ndjson", "csv" };
+  int i;
+
+  for(i = 0; i < 4; i++)
+    if(!strcmp(str, names[i]))
+      return i;
+  return -1;
+}
+
+/* Framing around the records: several json objects make an array, csv rows need the header.
+/  The json separator and end expect the records without their final line break.
+*/
+
+void print_records_begin(FILE *fp, int format, int many)
+{
+  struct nvbios bios;
+  struct writer w;
+
+  if(format == FORMAT_JSON && many)
+    fprintf(fp, "[\n");
+
+  if(format == FORMAT_CSV)
+  {
+    memset(&bios, 0, sizeof(struct nvbios));
+    writer_init(&w, fp, format);
+    w.header = 1;
+    emit_bios(&w, &bios);
+    w_putc(&w, '\n');
+    w_flush(&w);
+  }
+}
+
+void print_records_separator(FILE *fp, int format)
+{
+  if(format == FORMAT_JSON)
+    fprintf(fp, ",\n");
+}
+
+void print_records_end(FILE *fp, int format, int many)
+{
+  if(format == FORMAT_JSON && many)
+    fprintf(fp, "\n]\n");
+}
@@ -0,0 +1,70 @@
+/*
+ * Copyright(C) 2010 Andrew Powell
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA 02111-1307, USA
+ */
+
+/* Perfect hash tables for the PCI id lookups (hash and displace). ids.c generates the tables in ids.h and info.c
+/  looks the ids up in them. A key first picks a bucket, the seed stored for the bucket then picks the slot; the
+/  generator chose the seeds so that no two keys end up in the same slot.
+*/
+
+enum { ID_SLOT_EMPTY = 0xffffffff };
+
+struct id_slot
+{
+  unsigned int key;   // ID_SLOT_EMPTY for unused slots
+  unsigned int value;
+};
+
+struct id_table
+{
+  unsigned char bits;        // 1 << bits slots
+  unsigned char bucket_bits; // 1 << bucket_bits buckets
+  const unsigned short *seeds;
+  const struct id_slot *slots;
+};
+
+static inline unsigned int id_hash(unsigned int key, unsigned int seed)
+{
+  unsigned int x = key * 0x9E3779B1u + seed * 0x85EBCA77u;
+
+  x ^= x >> 15;
+  x *= 0x2C1B3C6Du;
+  x ^= x >> 12;
+  return x;
+}
+
+static inline unsigned int id_bucket(unsigned int key, unsigned int bucket_bits)
+{
+  return id_hash(key, 0) >> (32 - bucket_bits);
+}
+
+static inline unsigned int id_slot(unsigned int key, unsigned int seed, unsigned int bits)
+{
+  return id_hash(key, seed) & ((1u << bits) - 1);
+}
+
+// Returns 0 if the key is not in the table
+static inline int id_lookup(const struct id_table *table, unsigned int key, unsigned int *value)
+{
+  const struct id_slot *slot = table->slots + id_slot(key, table->seeds[id_bucket(key, table->bucket_bits)], table->bits);
+
+  if(slot->key != key)
+    return 0;
+
+  *value = slot->value;
+  return 1;
+}
@@ -0,0 +1,844 @@
+/* Generated by ids.c, do not edit */
+
+static const unsigned short card_names_seeds[256] =
+{
+  1, 3, 1, 6, 1, 4, 2, 1, 6, 1, 3, 5, 1, 8, 6, 1,
+  8, 1, 4, 2, 1, 3, 10, 3, 1, 1, 9, 4, 1, 2, 2, 2,
+  2, 2, 1, 5, 1, 7, 2, 15, 1, 2, 1, 8, 1, 1, 3, 2,
+  2, 5, 1, 3, 12, 1, 1, 2, 1, 1, 6, 1, 1, 1, 1, 4,
+  4, 6, 1, 2, 1, 1, 4, 1, 1, 5, 5, 1, 1, 3, 1, 3,
+  1, 2, 4, 1, 3, 1, 2, 1, 1, 3, 1, 12, 2, 4, 1, 1,
+  1, 1, 1, 2, 1, 2, 2, 1, 3, 1, 4, 8, 2, 4, 4, 3,
+  5, 1, 3, 3, 1, 1, 2, 2, 4, 1, 1, 1, 2, 6, 11, 1,
+  4, 1, 6, 6, 1, 3, 2, 4, 13, 4, 1, 1, 3, 1, 1, 3,
+  3, 1, 3, 1, 1, 4, 1, 10, 1, 3, 5, 2, 1, 5, 3, 10,
+  11, 1, 4, 3, 1, 2, 1, 1, 16, 1, 1, 13, 1, 2, 17, 2,
+  1, 2, 1, 6, 3, 1, 2, 1, 4, 1, 5, 1, 3, 1, 3, 1,
+  6, 12, 7, 1, 9, 11, 10, 8, 5, 2, 1, 1, 2, 2, 9, 3,
+  1, 9, 3, 8, 4, 1, 2, 7, 4, 4, 4, 4, 6, 5, 4, 1,
+  1, 1, 2, 4, 3, 1, 5, 1, 5, 2, 4, 2, 4, 2, 2, 1,
+  4, 4, 2, 13, 2, 1, 15, 6, 1, 1, 1, 23, 8, 1, 4, 2,
+};
+
+static const struct id_slot card_names_slots[1024] =
+{
+  { 0x40, 0xa1a }, { 0xffffffff, 0 }, { 0xffffffff, 0 }, { 0x244, 0xed7 },
+  { 0x53b, 0x182c }, { 0xffffffff, 0 }, { 0xffffffff, 0 }, { 0x7e1, 0x212f },
+  { 0x844, 0x2205 }, { 0x1d0, 0x1254 }, { 0xffffffff, 0 }, { 0x251, 0x4c6 },
+  { 0x423, 0x15f0 }, { 0x4c3, 0x13bc }, { 0x653, 0x1ecf }, { 0xffffffff, 0 },
+  { 0x200, 0x44e }, { 0xc1, 0xa34 }, { 0x3d2, 0x1742 }, { 0xffffffff, 0 },
+  { 0x98, 0xf41 }, { 0x6fd, 0x20e2 }, { 0xffffffff, 0 }, { 0x2f, 0x5f },
+  { 0x7e6, 0x21aa }, { 0xffffffff, 0 }, { 0x17b, 0x27f }, { 0x4ce, 0x13bc },
+  { 0xffffffff, 0 }, { 0xffffffff, 0 }, { 0xa75, 0x260c }, { 0x34e, 0x9e7 },
+  { 0xffffffff, 0 }, { 0x659, 0x1f62 }, { 0x608, 0x1a2c }, { 0x5e0, 0x186e },
+  { 0x194, 0x1409 }, { 0xffffffff, 0 }, { 0xffffffff, 0 }, { 0xffffffff, 0 },
+  { 0x5fd, 0x195f }, { 0x31c, 0x722 }, { 0xffffffff, 0 }, { 0x5f1, 0x18cc },
+  { 0x85d, 0x21f5 }, { 0x40a, 0x152c }, { 0x18d, 0x417 }, { 0xffffffff, 0 },
+  { 0x610, 0x1ad5 }, { 0xffffffff, 0 }, { 0x151, 0x17d }, { 0x401, 0x1472 },
+  { 0xffffffff, 0 }, { 0x90, 0xf41 }, { 0xffffffff, 0 }, { 0xfc, 0xc4c },
+  { 0x167, 0xdcb }, { 0xffffffff, 0 }, { 0x16e, 0xe39 }, { 0x1dc, 0x1367 },
+  { 0xa3f, 0x2555 }, { 0x533, 0x1809 }, { 0x17c, 0x2cf }, { 0xffffffff, 0 },
+  { 0x1a0, 0x145 }, { 0xffffffff, 0 }, { 0xffffffff, 0 }, { 0xffffffff, 0 },
+  { 0x3d0, 0x1704 }, { 0x302, 0x61d }, { 0x5fb, 0x18cc }, { 0x299, 0x107b },
+  { 0x605, 0x19a5 }, { 0xffffffff, 0 }, { 0x391, 0x1145 }, { 0xffffffff, 0 },
+  { 0x7ea, 0x21aa }, { 0x859, 0x21f5 }, { 0x840, 0x21e0 }, { 0xffffffff, 0 },
+  { 0x112, 0x117 }, { 0xffffffff, 0 }, { 0x86b, 0x239d }, { 0x1d8, 0x1309 },
+  { 0xffffffff, 0 }, { 0x5e1, 0x1887 }, { 0x600, 0x198a }, { 0x637, 0x1cd3 },
+  { 0x643, 0x1da1 }, { 0xffffffff, 0 }, { 0x18c, 0x3fe }, { 0x291, 0xfe4 },
+  { 0xffffffff, 0 }, { 0xffffffff, 0 }, { 0x6fc, 0x2024 }, { 0x42b, 0x1693 },
+  { 0xffffffff, 0 }, { 0xffffffff, 0 }, { 0x84f, 0x22fc }, { 0x1de, 0x1392 },
+  { 0x40b, 0x1543 }, { 0xa7f, 0x2686 }, { 0x32c, 0x863 }, { 0xffffffff, 0 },
+  { 0xffffffff, 0 }, { 0xffffffff, 0 }, { 0xffffffff, 0 }, { 0x7e4, 0x21aa },
+  { 0xffffffff, 0 }, { 0x18a, 0x3ce }, { 0x2a, 0x26 }, { 0x84b, 0x22a6 },
+  { 0x9e, 0xfc0 }, { 0x624, 0x1c0a }, { 0xffffffff, 0 }, { 0xffffffff, 0 },
+  { 0x32f, 0x893 }, { 0xffffffff, 0 }, { 0x639, 0x1c0a }, { 0x33f, 0x934 },
+  { 0xffffffff, 0 }, { 0x24a, 0xecc }, { 0xffffffff, 0 }, { 0xffffffff, 0 },
+  { 0xffffffff, 0 }, { 0x636, 0x1c0a }, { 0x60a, 0x1a5e }, { 0xf3, 0xbb0 },
+  { 0x6ec, 0x2075 }, { 0x324, 0x799 }, { 0x7ed, 0x21aa }, { 0x7eb, 0x21aa },
+  { 0x1d2, 0x1281 }, { 0xa6e, 0x25f8 }, { 0xffffffff, 0 }, { 0xa3c, 0x2530 },
+  { 0xa6a, 0x25d6 }, { 0xffffffff, 0 }, { 0x319, 0x6e2 }, { 0x644, 0x1dce },
+  { 0x28c, 0x604 }, { 0x29, 0x8d }, { 0x7ec, 0x21aa }, { 0x3dd, 0x1761 },
+  { 0x163, 0xd7f }, { 0x189, 0x3aa }, { 0x248, 0xecc }, { 0x325, 0x7b2 },
+  { 0xffffffff, 0 }, { 0x6e8, 0x202f }, { 0x34b, 0x9ab }, { 0x4c0, 0x13bc },
+  { 0x5f9, 0x194e }, { 0x169, 0xe0f }, { 0xf9, 0xa1a }, { 0x4c2, 0x13bc },
+  { 0xffffffff, 0 }, { 0xffffffff, 0 }, { 0x652, 0x1eb8 }, { 0xffffffff, 0 },
+  { 0x348, 0x9b7 }, { 0xffffffff, 0 }, { 0xffffffff, 0 }, { 0x61e, 0x1bdc },
+  { 0x633, 0x1d46 }, { 0xffffffff, 0 }, { 0x294, 0x1010 }, { 0x2e4, 0x1027 },
+  { 0x246, 0xecc }, { 0x2a0, 0xa0a }, { 0x31b, 0x709 }, { 0x183, 0x34c },
+  { 0x6fe, 0x2024 }, { 0x41, 0xa34 }, { 0x31f, 0x6e2 }, { 0xffffffff, 0 },
+  { 0x622, 0x1c15 }, { 0xffffffff, 0 }, { 0xffffffff, 0 }, { 0xffffffff, 0 },
+  { 0x162, 0xdaa }, { 0x321, 0x74f }, { 0xffffffff, 0 }, { 0x24f, 0xecc },
+  { 0xffffffff, 0 }, { 0x871, 0x2243 }, { 0xffffffff, 0 }, { 0x333, 0x8eb },
+  { 0x6c0, 0x2699 }, { 0x63d, 0x1c0a }, { 0xffffffff, 0 }, { 0xffffffff, 0 },
+  { 0xffffffff, 0 }, { 0x869, 0x2372 }, { 0xffffffff, 0 }, { 0xffffffff, 0 },
+  { 0x6e3, 0x15c4 }, { 0x14a, 0xccf }, { 0xa62, 0x2576 }, { 0xffffffff, 0 },
+  { 0x62a, 0x1ca2 }, { 0x17a, 0x2b3 }, { 0x428, 0x164e }, { 0x613, 0x1b03 },
+  { 0x280, 0x56b }, { 0xffffffff, 0 }, { 0x344, 0x993 }, { 0xa66, 0x25ae },
+  { 0xffffffff, 0 }, { 0x85f, 0x21f5 }, { 0x259, 0x523 }, { 0x5e7, 0x18f0 },
+  { 0xffffffff, 0 }, { 0xffffffff, 0 }, { 0x85b, 0x21f5 }, { 0x601, 0x19a5 },
+  { 0x6f5, 0x2024 }, { 0x390, 0x112f }, { 0x61c, 0x1baf }, { 0xffffffff, 0 },
+  { 0x856, 0x21f5 }, { 0xffffffff, 0 }, { 0x63a, 0x1d8a }, { 0x3d3, 0x1761 },
+  { 0x143, 0xccf }, { 0x24b, 0xecc }, { 0xffffffff, 0 }, { 0xffffffff, 0 },
+  { 0xffffffff, 0 }, { 0x221, 0xbb0 }, { 0xffffffff, 0 }, { 0xffffffff, 0 },
+  { 0x3dc, 0x1761 }, { 0x842, 0x21f5 }, { 0x40e, 0x1585 }, { 0xa60, 0x1fa4 },
+  { 0x193, 0x13f2 }, { 0x320, 0x738 }, { 0x48, 0xa74 }, { 0x862, 0x2346 },
+  { 0xffffffff, 0 }, { 0x6ff, 0x20f8 }, { 0xffffffff, 0 }, { 0x4c5, 0x13bc },
+  { 0xffffffff, 0 }, { 0xa63, 0x2589 }, { 0xffffffff, 0 }, { 0xa64, 0x240f },
+  { 0xffffffff, 0 }, { 0x7e5, 0x21b7 }, { 0x857, 0x21f5 }, { 0x295, 0x1027 },
+  { 0xffffffff, 0 }, { 0x314, 0x6ca }, { 0xffffffff, 0 }, { 0x7e2, 0x2158 },
+  { 0xffffffff, 0 }, { 0xffffffff, 0 }, { 0xffffffff, 0 }, { 0x252, 0x4df },
+  { 0xa23, 0x248c }, { 0x170, 0x1bc }, { 0xffffffff, 0 }, { 0xffffffff, 0 },
+  { 0xffffffff, 0 }, { 0x65f, 0x1fa4 }, { 0xffffffff, 0 }, { 0x874, 0x240f },
+  { 0xffffffff, 0 }, { 0x332, 0x8d3 }, { 0x60c, 0x1a8e }, { 0xffffffff, 0 },
+  { 0xffffffff, 0 }, { 0x309, 0x664 }, { 0x323, 0x781 }, { 0x84c, 0x22c9 },
+  { 0x253, 0x4f2 }, { 0x1db, 0x1350 }, { 0xffffffff, 0 }, { 0xffffffff, 0 },
+  { 0x141, 0xb9c }, { 0xffffffff, 0 }, { 0x531, 0x17d8 }, { 0xffffffff, 0 },
+  { 0xffffffff, 0 }, { 0x5e4, 0x18cc }, { 0x3d8, 0x1761 }, { 0x2e, 0x5f },
+  { 0xffffffff, 0 }, { 0x4c6, 0x13bc }, { 0x86a, 0x2372 }, { 0xffffffff, 0 },
+  { 0xffffffff, 0 }, { 0x1f0, 0x42f }, { 0x187, 0x37a }, { 0x85a, 0x21f5 },
+  { 0x631, 0x1d16 }, { 0x42c, 0x16aa }, { 0x91, 0xf4c }, { 0x650, 0x1e93 },
+  { 0x318, 0x6e2 }, { 0xffffffff, 0 }, { 0x5fe, 0x195f }, { 0xffffffff, 0 },
+  { 0x5e3, 0x18b5 }, { 0xffffffff, 0 }, { 0xa70, 0x260c }, { 0x308, 0x64f },
+  { 0x7ee, 0x21aa }, { 0x6fb, 0x20cd }, { 0x4cd, 0x13bc }, { 0xffffffff, 0 },
+  { 0x111, 0xfb }, { 0x93, 0xaa0 }, { 0x180, 0x2fe }, { 0xffffffff, 0 },
+  { 0xffffffff, 0 }, { 0xffffffff, 0 }, { 0xa21, 0x2469 }, { 0xa28, 0x249f },
+  { 0xa22, 0x2479 }, { 0x5e6, 0x18d9 }, { 0xffffffff, 0 }, { 0x611, 0x19bc },
+  { 0xffffffff, 0 }, { 0x201, 0x45f }, { 0x113, 0x12b }, { 0x86f, 0x23ce },
+  { 0xffffffff, 0 }, { 0x28, 0x10 }, { 0x60f, 0x1abd }, { 0xffffffff, 0 },
+  { 0x395, 0x1171 }, { 0x3d6, 0x178d }, { 0x858, 0x21f5 }, { 0xffffffff, 0 },
+  { 0xffffffff, 0 }, { 0xffffffff, 0 }, { 0x174, 0x21b }, { 0x317, 0x6be },
+  { 0x62c, 0x1c89 }, { 0x646, 0x1de5 }, { 0xffffffff, 0 }, { 0x16b, 0xe39 },
+  { 0x62b, 0x1cbb }, { 0xffffffff, 0 }, { 0x5f7, 0x18cc }, { 0xf8, 0xc09 },
+  { 0xf1, 0xb85 }, { 0xffffffff, 0 }, { 0xffffffff, 0 }, { 0xfe, 0xc8d },
+  { 0x4d, 0xac4 }, { 0x5f3, 0x18cc }, { 0x3da, 0x1761 }, { 0x424, 0x149e },
+  { 0xffffffff, 0 }, { 0x85c, 0x21f5 }, { 0xffffffff, 0 }, { 0x29c, 0x10c1 },
+  { 0x63c, 0x1c0a }, { 0x171, 0x1d3 }, { 0xffffffff, 0 }, { 0x95, 0xf79 },
+  { 0x62f, 0x1cea }, { 0x203, 0x49b }, { 0x298, 0x1062 }, { 0x211, 0xa34 },
+  { 0x30a, 0x679 }, { 0x60d, 0x19ff }, { 0xa30, 0x24f5 }, { 0xffffffff, 0 },
+  { 0x4c4, 0x13bc }, { 0x852, 0x21f5 }, { 0x6ed, 0x2024 }, { 0x422, 0x149e },
+  { 0xffffffff, 0 }, { 0xffffffff, 0 }, { 0xffffffff, 0 }, { 0x210, 0xe48 },
+  { 0xffffffff, 0 }, { 0x149, 0xd3e }, { 0x863, 0x235d }, { 0x603, 0x19d2 },
+  { 0xffffffff, 0 }, { 0x7ef, 0x21aa }, { 0xffffffff, 0 }, { 0xffffffff, 0 },
+  { 0x86d, 0x2243 }, { 0x47, 0xaa0 }, { 0x87d, 0x240f }, { 0xc9, 0xb05 },
+  { 0xffffffff, 0 }, { 0xa76, 0x240f }, { 0x241, 0xea2 }, { 0xa7e, 0x2673 },
+  { 0xffffffff, 0 }, { 0x212, 0xa48 }, { 0xffffffff, 0 }, { 0xffffffff, 0 },
+  { 0xffffffff, 0 }, { 0x31e, 0x6e2 }, { 0xffffffff, 0 }, { 0x164, 0xdcb },
+  { 0x628, 0x1c89 }, { 0x2c, 0x5f }, { 0x4cc, 0x13bc }, { 0x394, 0x1187 },
+  { 0xffffffff, 0 }, { 0x634, 0x1c0a }, { 0xffffffff, 0 }, { 0xffffffff, 0 },
+  { 0xa7d, 0x2663 }, { 0x656, 0x1f25 }, { 0xffffffff, 0 }, { 0x290, 0xfcd },
+  { 0x400, 0x145b }, { 0x410, 0x15ae }, { 0xffffffff, 0 }, { 0x250, 0x4ad },
+  { 0x178, 0x27f }, { 0xc2, 0xa48 }, { 0xffffffff, 0 }, { 0x64d, 0x1e72 },
+  { 0xffffffff, 0 }, { 0xffffffff, 0 }, { 0xffffffff, 0 }, { 0xffffffff, 0 },
+  { 0xffffffff, 0 }, { 0xffffffff, 0 }, { 0xffffffff, 0 }, { 0xffffffff, 0 },
+  { 0xffffffff, 0 }, { 0x101, 0xbc }, { 0x1d9, 0x1320 }, { 0x34c, 0x9cf },
+  { 0x5f2, 0x18cc }, { 0xffffffff, 0 }, { 0x615, 0x1b32 }, { 0x19d, 0x1431 },
+  { 0x64b, 0x1e43 }, { 0xffffffff, 0 }, { 0xffffffff, 0 }, { 0x168, 0xdf8 },
+  { 0xffffffff, 0 }, { 0xffffffff, 0 }, { 0xffffffff, 0 }, { 0x607, 0x1a15 },
+  { 0x408, 0x14fb }, { 0xffffffff, 0 }, { 0xffffffff, 0 }, { 0xffffffff, 0 },
+  { 0xffffffff, 0 }, { 0x3d1, 0x1723 }, { 0x645, 0x1dce }, { 0xffffffff, 0 },
+  { 0xffffffff, 0 }, { 0x6f1, 0x2024 }, { 0xffffffff, 0 }, { 0x626, 0x1c5d },
+  { 0x1d7, 0x12f2 }, { 0xffffffff, 0 }, { 0xffffffff, 0 }, { 0x5e5, 0x18cc },
+  { 0x245, 0xeee }, { 0x327, 0x7e1 }, { 0x44, 0xa74 }, { 0x640, 0x1da1 },
+  { 0x64e, 0x1e72 }, { 0xa6c, 0x25e7 }, { 0x4ca, 0x13bc }, { 0x630, 0x1d00 },
+  { 0xffffffff, 0 }, { 0xffffffff, 0 }, { 0x9c, 0xf41 }, { 0xffffffff, 0 },
+  { 0x65e, 0x1e72 }, { 0x5ea, 0x189e }, { 0xa00, 0x245c }, { 0x65b, 0x16aa },
+  { 0xffffffff, 0 }, { 0xa0, 0x38 }, { 0xffffffff, 0 }, { 0xffffffff, 0 },
+  { 0xffffffff, 0 }, { 0xffffffff, 0 }, { 0x4cb, 0x13bc }, { 0x328, 0x7f8 },
+  { 0xffffffff, 0 }, { 0xa35, 0x2519 }, { 0xffffffff, 0 }, { 0x153, 0x1a8 },
+  { 0x292, 0xffa }, { 0x188, 0x392 }, { 0x152, 0x191 }, { 0xffffffff, 0 },
+  { 0x288, 0x5d4 }, { 0x617, 0x1a2c }, { 0xffffffff, 0 }, { 0x65c, 0x1f8e },
+  { 0x165, 0xde2 }, { 0xa2d, 0x24de }, { 0x3d4, 0x1761 }, { 0x5f8, 0x1934 },
+  { 0xffffffff, 0 }, { 0x103, 0xd3 }, { 0xffffffff, 0 }, { 0x872, 0x23fa },
+  { 0x1d1, 0x126b }, { 0xffffffff, 0 }, { 0x6f7, 0x2024 }, { 0xffffffff, 0 },
+  { 0x6e6, 0x2010 }, { 0x60e, 0x1aa7 }, { 0xffffffff, 0 }, { 0xffffffff, 0 },
+  { 0x426, 0x161e }, { 0xffffffff, 0 }, { 0x29d, 0x10d6 }, { 0xffffffff, 0 },
+  { 0x61d, 0x1bc5 }, { 0x632, 0x1d2e }, { 0xffffffff, 0 }, { 0x24c, 0xecc },
+  { 0xffffffff, 0 }, { 0xffffffff, 0 }, { 0xa20, 0x1d46 }, { 0x63e, 0x1c0a },
+  { 0x4c9, 0x13bc }, { 0x4c8, 0x13bc }, { 0x62e, 0x1cd3 }, { 0xffffffff, 0 },
+  { 0xffffffff, 0 }, { 0xffffffff, 0 }, { 0xffffffff, 0 }, { 0x343, 0x97b },
+  { 0x6f0, 0x2024 }, { 0xffffffff, 0 }, { 0x5e9, 0x18cc }, { 0x243, 0xecc },
+  { 0x220, 0xe54 }, { 0xffffffff, 0 }, { 0x40c, 0x155a }, { 0xffffffff, 0 },
+  { 0xffffffff, 0 }, { 0x409, 0x1514 }, { 0x14e, 0xd6b }, { 0x6f4, 0x2024 },
+  { 0xffffffff, 0 }, { 0x7e9, 0x21aa }, { 0xffffffff, 0 }, { 0xffffffff, 0 },
+  { 0xffffffff, 0 }, { 0x6f2, 0x2024 }, { 0x84a, 0x2293 }, { 0xffffffff, 0 },
+  { 0xffffffff, 0 }, { 0xffffffff, 0 }, { 0x404, 0x149e }, { 0x301, 0x633 },
+  { 0x4c7, 0x13bc }, { 0x5fa, 0x18cc }, { 0xffffffff, 0 }, { 0x854, 0x21f5 },
+  { 0xffffffff, 0 }, { 0x42a, 0x167c }, { 0x1d4, 0x12ae }, { 0xf0, 0xb6b },
+  { 0xffffffff, 0 }, { 0x19e, 0x1446 }, { 0x867, 0x2372 }, { 0x192, 0x13c7 },
+  { 0x31a, 0x6f0 }, { 0xc0, 0xaa0 }, { 0xffffffff, 0 }, { 0x1dd, 0x137c },
+  { 0xffffffff, 0 }, { 0xffffffff, 0 }, { 0xffffffff, 0 }, { 0x6e2, 0x1fe4 },
+  { 0x6eb, 0x205e }, { 0x322, 0x76b }, { 0x160, 0xd7f }, { 0x249, 0xecc },
+  { 0x649, 0x1dfb }, { 0xffffffff, 0 }, { 0x635, 0x1d5c }, { 0xffffffff, 0 },
+  { 0xffffffff, 0 }, { 0x39c, 0x1214 }, { 0xffffffff, 0 }, { 0xffffffff, 0 },
+  { 0x289, 0x5ec }, { 0xffffffff, 0 }, { 0x215, 0xa8a }, { 0xffffffff, 0 },
+  { 0x625, 0x1c41 }, { 0x64f, 0x1e7d }, { 0x16c, 0xe39 }, { 0x218, 0xa74 },
+  { 0x347, 0x9b7 }, { 0x3d9, 0x1761 }, { 0xffffffff, 0 }, { 0xffffffff, 0 },
+  { 0x247, 0xf16 }, { 0xffffffff, 0 }, { 0xffffffff, 0 }, { 0xffffffff, 0 },
+  { 0x6e5, 0x1ff8 }, { 0x24d, 0xecc }, { 0xffffffff, 0 }, { 0xffffffff, 0 },
+  { 0x20, 0 }, { 0x638, 0x1d74 }, { 0xffffffff, 0 }, { 0xffffffff, 0 },
+  { 0x14d, 0xd57 }, { 0xffffffff, 0 }, { 0xffffffff, 0 }, { 0x281, 0x584 },
+  { 0xffffffff, 0 }, { 0x329, 0x818 }, { 0x654, 0x1ee6 }, { 0x31d, 0x6be },
+  { 0xffffffff, 0 }, { 0x5f5, 0x18cc }, { 0x606, 0x19ff }, { 0x7e8, 0x21aa },
+  { 0x3df, 0x1761 }, { 0x313, 0x6be }, { 0x49, 0xab6 }, { 0x2d, 0x77 },
+  { 0xffffffff, 0 }, { 0xffffffff, 0 }, { 0xffffffff, 0 }, { 0xffffffff, 0 },
+  { 0xffffffff, 0 }, { 0x144, 0xcdb }, { 0x17d, 0x2e8 }, { 0xffffffff, 0 },
+  { 0x39a, 0x11e4 }, { 0xa72, 0x260c }, { 0x87b, 0x243e }, { 0xffffffff, 0 },
+  { 0xffffffff, 0 }, { 0x5ec, 0x18cc }, { 0xffffffff, 0 }, { 0x627, 0x1c73 },
+  { 0xa3d, 0x2546 }, { 0x202, 0x47d }, { 0xa69, 0x25c1 }, { 0xa68, 0x25c1 },
+  { 0xffffffff, 0 }, { 0x405, 0x14b4 }, { 0xffffffff, 0 }, { 0xfa, 0xc1e },
+  { 0x392, 0x115b }, { 0xffffffff, 0 }, { 0x29f, 0x1100 }, { 0xff, 0xca2 },
+  { 0x161, 0xd8b }, { 0x94, 0xf41 }, { 0x6f6, 0x2024 }, { 0xa65, 0x248c },
+  { 0xffffffff, 0 }, { 0xffffffff, 0 }, { 0xffffffff, 0 }, { 0x197, 0x13c7 },
+  { 0x427, 0x1636 }, { 0x2e0, 0x1145 }, { 0xffffffff, 0 }, { 0xffffffff, 0 },
+  { 0x866, 0x2346 }, { 0x191, 0x13db }, { 0xffffffff, 0 }, { 0x3de, 0x1761 },
+  { 0xffffffff, 0 }, { 0x3d5, 0x176e }, { 0x190, 0x13c7 }, { 0x40d, 0x156f },
+  { 0x6e0, 0x1fb8 }, { 0x620, 0x1c0a }, { 0x850, 0x21f5 }, { 0x2e3, 0x123d },
+  { 0x6ea, 0x2047 }, { 0xffffffff, 0 }, { 0xffffffff, 0 }, { 0xffffffff, 0 },
+  { 0xffffffff, 0 }, { 0x312, 0x6a8 }, { 0x6fa, 0x20b7 }, { 0xa73, 0x25f8 },
+  { 0x848, 0x226b }, { 0x846, 0x2243 }, { 0xa29, 0x24b6 }, { 0xffffffff, 0 },
+  { 0x173, 0x201 }, { 0xffffffff, 0 }, { 0xffffffff, 0 }, { 0x64a, 0x1e2b },
+  { 0xffffffff, 0 }, { 0x172, 0x1ea }, { 0x420, 0x15c4 }, { 0x21d, 0xe48 },
+  { 0x609, 0x1a45 }, { 0xffffffff, 0 }, { 0xffffffff, 0 }, { 0x604, 0x19e8 },
+  { 0xf4, 0xbc4 }, { 0xffffffff, 0 }, { 0xffffffff, 0 }, { 0x228, 0xe81 },
+  { 0xffffffff, 0 }, { 0xffffffff, 0 }, { 0xffffffff, 0 }, { 0xffffffff, 0 },
+  { 0x150, 0x164 }, { 0x861, 0x2332 }, { 0x399, 0x11cb }, { 0x14b, 0xccf },
+  { 0x1df, 0x13a6 }, { 0xffffffff, 0 }, { 0x4e, 0xad9 }, { 0xffffffff, 0 },
+  { 0x876, 0x240f }, { 0xffffffff, 0 }, { 0xffffffff, 0 }, { 0xa2c, 0x24cd },
+  { 0xffffffff, 0 }, { 0xffffffff, 0 }, { 0xf5, 0xbda }, { 0x3db, 0x1761 },
+  { 0xffffffff, 0 }, { 0x5ed, 0x191a }, { 0xffffffff, 0 }, { 0x1d5, 0x12c5 },
+  { 0x642, 0x1db7 }, { 0x53f, 0x17fb }, { 0xffffffff, 0 }, { 0xffffffff, 0 },
+  { 0x85e, 0x21f5 }, { 0xffffffff, 0 }, { 0x40f, 0x1599 }, { 0x282, 0x5a0 },
+  { 0x39b, 0x11fb }, { 0xffffffff, 0 }, { 0xffffffff, 0 }, { 0xffffffff, 0 },
+  { 0x641, 0x16aa }, { 0xf6, 0xbf0 }, { 0x647, 0x1dfb }, { 0x147, 0xd28 },
+  { 0xa2a, 0x249f }, { 0x24e, 0xecc }, { 0x6ef, 0x2024 }, { 0x222, 0xe68 },
+  { 0xffffffff, 0 }, { 0x421, 0x15da }, { 0xf2, 0xb9c }, { 0xffffffff, 0 },
+  { 0xffffffff, 0 }, { 0x25a, 0x53b }, { 0xffffffff, 0 }, { 0x614, 0x1b1c },
+  { 0x618, 0x1b54 }, { 0x63f, 0x1c0a }, { 0x42d, 0x16c1 }, { 0x25b, 0x553 },
+  { 0x619, 0x1b6c }, { 0x9d, 0xfab }, { 0x655, 0x1efd }, { 0x1d6, 0x12db },
+  { 0xffffffff, 0 }, { 0x398, 0x11b4 }, { 0x530, 0x17b5 }, { 0x616, 0x1b49 },
+  { 0x849, 0x227f }, { 0x865, 0x231e }, { 0x16a, 0xe23 }, { 0x296, 0x103d },
+  { 0x46, 0xa8a }, { 0x7e3, 0x2181 }, { 0x300, 0x61d }, { 0x868, 0x2386 },
+  { 0x29e, 0x10eb }, { 0x32d, 0x87b }, { 0x6c4, 0x26b0 }, { 0x45, 0xa8a },
+  { 0x29a, 0x1095 }, { 0x7e0, 0x2106 }, { 0x648, 0x1e13 }, { 0xffffffff, 0 },
+  { 0x18b, 0x3e6 }, { 0x62d, 0x1cd3 }, { 0xffffffff, 0 }, { 0xffffffff, 0 },
+  { 0x2e2, 0x1171 }, { 0xffffffff, 0 }, { 0xffffffff, 0 }, { 0x86e, 0x2205 },
+  { 0xffffffff, 0 }, { 0xa78, 0x2635 }, { 0x855, 0x21f5 }, { 0xffffffff, 0 },
+  { 0xffffffff, 0 }, { 0xffffffff, 0 }, { 0x6f8, 0x208a }, { 0x2de, 0xf2d },
+  { 0xffffffff, 0 }, { 0xffffffff, 0 }, { 0xffffffff, 0 }, { 0x293, 0x1010 },
+  { 0x331, 0x8bd }, { 0xffffffff, 0 }, { 0x6e1, 0x1fce }, { 0xffffffff, 0 },
+  { 0x64c, 0x1e5a }, { 0x602, 0x19bc }, { 0xffffffff, 0 }, { 0x240, 0xe8e },
+  { 0xffffffff, 0 }, { 0xcc, 0xb21 }, { 0x851, 0x21f5 }, { 0xffffffff, 0 },
+  { 0xffffffff, 0 }, { 0x6cd, 0x26c7 }, { 0xffffffff, 0 }, { 0xffffffff, 0 },
+  { 0x92, 0xf63 }, { 0x2dd, 0xf2d }, { 0x258, 0x50b }, { 0xffffffff, 0 },
+  { 0x61f, 0x1bf3 }, { 0xffffffff, 0 }, { 0x87f, 0x244e }, { 0xffffffff, 0 },
+  { 0xffffffff, 0 }, { 0xffffffff, 0 }, { 0x110, 0xe1 }, { 0x21e, 0xe48 },
+  { 0xffffffff, 0 }, { 0x100, 0xa5 }, { 0x2b, 0x26 }, { 0x4cf, 0x13bc },
+  { 0x32a, 0x835 }, { 0x393, 0x1171 }, { 0xffffffff, 0 }, { 0x34f, 0x9fc },
+  { 0x53a, 0x182c }, { 0x148, 0xcdb }, { 0x177, 0x267 }, { 0x5f4, 0x18cc },
+  { 0xffffffff, 0 }, { 0x853, 0x21f5 }, { 0x179, 0x297 }, { 0x186, 0x366 },
+  { 0x87a, 0x241a }, { 0x39e, 0x1229 }, { 0x657, 0x1e72 }, { 0xffffffff, 0 },
+  { 0x6f9, 0x20a0 }, { 0x629, 0x1c0a }, { 0x5fc, 0x18cc }, { 0xffffffff, 0 },
+  { 0xffffffff, 0 }, { 0x316, 0x6be }, { 0xffffffff, 0 }, { 0x42, 0xa48 },
+  { 0x65d, 0x1e72 }, { 0x166, 0xdf8 }, { 0x864, 0x231e }, { 0xffffffff, 0 },
+  { 0xffffffff, 0 }, { 0xffffffff, 0 }, { 0x182, 0x318 }, { 0xffffffff, 0 },
+  { 0x145, 0xcf2 }, { 0xffffffff, 0 }, { 0x61a, 0x1b85 }, { 0x621, 0x19d2 },
+  { 0x185, 0x334 }, { 0x1d3, 0x1298 }, { 0xffffffff, 0 }, { 0x658, 0x1f4d },
+  { 0x407, 0x14e3 }, { 0x311, 0x68c }, { 0x99, 0xf91 }, { 0x181, 0x2fe },
+  { 0x61b, 0x1b9a }, { 0xffffffff, 0 }, { 0x146, 0xd08 }, { 0xffffffff, 0 },
+  { 0xffffffff, 0 }, { 0x6e9, 0x1ff8 }, { 0x16d, 0xe39 }, { 0x5eb, 0x1903 },
+  { 0x286, 0x5bb }, { 0xa74, 0x2620 }, { 0xffffffff, 0 }, { 0xffffffff, 0 },
+  { 0xffffffff, 0 }, { 0x5e2, 0x189e }, { 0xffffffff, 0 }, { 0x86c, 0x23ac },
+  { 0xffffffff, 0 }, { 0xa34, 0x2502 }, { 0x429, 0x1665 }, { 0xffffffff, 0 },
+  { 0xffffffff, 0 }, { 0xffffffff, 0 }, { 0x5ff, 0x1974 }, { 0x53e, 0x184e },
+  { 0xffffffff, 0 }, { 0x6e4, 0x149e }, { 0x334, 0x907 }, { 0xffffffff, 0 },
+  { 0xffffffff, 0 }, { 0xffffffff, 0 }, { 0x19a, 0x1422 }, { 0x4c1, 0x13bc },
+  { 0xffffffff, 0 }, { 0xc3, 0xa74 }, { 0xce, 0xb56 }, { 0x870, 0x23e5 },
+  { 0x330, 0x8a1 }, { 0xa6f, 0x240f }, { 0xffffffff, 0 }, { 0x860, 0x231e },
+  { 0xffffffff, 0 }, { 0x612, 0x1aec }, { 0x14f, 0xbb0 }, { 0xffffffff, 0 },
+  { 0x1da, 0x1339 }, { 0xffffffff, 0 }, { 0xffffffff, 0 }, { 0x14c, 0xd57 },
+  { 0xffffffff, 0 }, { 0xffffffff, 0 }, { 0xa7c, 0x264d }, { 0x297, 0x1048 },
+  { 0x5e8, 0x18cc }, { 0xffffffff, 0 }, { 0x338, 0x91f }, { 0xffffffff, 0 },
+  { 0xfd, 0xc72 }, { 0xffffffff, 0 }, { 0xffffffff, 0 }, { 0xffffffff, 0 },
+  { 0xffffffff, 0 }, { 0x5ef, 0x18cc }, { 0xffffffff, 0 }, { 0x6e7, 0x2024 },
+  { 0xffffffff, 0 }, { 0x5f0, 0x18cc }, { 0x425, 0x1606 }, { 0xffffffff, 0 },
+  { 0x3d7, 0x1761 }, { 0x7e7, 0x21aa }, { 0x5ee, 0x18cc }, { 0x532, 0x17fb },
+  { 0x873, 0x23fa }, { 0xffffffff, 0 }, { 0x142, 0xbc4 }, { 0x402, 0x1472 },
+  { 0x176, 0x24b }, { 0xffffffff, 0 }, { 0xa10, 0x245c }, { 0x87e, 0x244e },
+  { 0x2e1, 0x115b }, { 0xffffffff, 0 }, { 0xffffffff, 0 }, { 0xcd, 0xb39 },
+  { 0xffffffff, 0 }, { 0xffffffff, 0 }, { 0x349, 0x9ab }, { 0xffffffff, 0 },
+  { 0xffffffff, 0 }, { 0xffffffff, 0 }, { 0x175, 0x233 }, { 0xffffffff, 0 },
+  { 0x242, 0xeb8 }, { 0x847, 0x2257 }, { 0x140, 0xcb9 }, { 0x651, 0x1ea2 },
+  { 0x623, 0x1c2b }, { 0x397, 0x119d }, { 0x341, 0x949 }, { 0x342, 0x965 },
+  { 0xffffffff, 0 }, { 0xffffffff, 0 }, { 0xfb, 0xc35 }, { 0x42e, 0x16d7 },
+  { 0xa2b, 0x24b6 }, { 0x845, 0x221c }, { 0x60b, 0x1a76 }, { 0x6f3, 0x2024 },
+  { 0xffffffff, 0 }, { 0x84d, 0x22e5 }, { 0x38b, 0x1118 }, { 0x403, 0x1488 },
+  { 0xa61, 0x2566 }, { 0xffffffff, 0 }, { 0xffffffff, 0 }, { 0x406, 0x14cc },
+  { 0x43, 0xa5e }, { 0xffffffff, 0 }, { 0x42f, 0x16ee }, { 0xffffffff, 0 },
+  { 0xffffffff, 0 }, { 0x32b, 0x84f }, { 0xffffffff, 0 }, { 0x345, 0x9ab },
+  { 0xc8, 0xaee }, { 0xffffffff, 0 }, { 0xa67, 0x2479 }, { 0xffffffff, 0 },
+  { 0xffffffff, 0 }, { 0x65a, 0x1f77 }, { 0x63b, 0x1c0a }, { 0x326, 0x7cb },
+  { 0xffffffff, 0 }, { 0x6ee, 0x2024 }, { 0x5f6, 0x18cc }, { 0x29b, 0x10ab },
+};
+
+static const struct id_table card_names = { 10, 8, card_names_seeds, card_names_slots };
+
+static const unsigned short subvendor_names_seeds[16] =
+{
+  3, 2, 7, 1, 2, 1, 3, 8, 1, 1, 2, 3, 3, 3, 1, 16,
+};
+
+static const struct id_slot subvendor_names_slots[64] =
+{
+  { 0xffffffff, 0 }, { 0x19da, 0x27bc }, { 0xffffffff, 0 }, { 0xffffffff, 0 },
+  { 0x1509, 0x2745 }, { 0xffffffff, 0 }, { 0x1458, 0x275e }, { 0x1682, 0x27b2 },
+  { 0xffffffff, 0 }, { 0xffffffff, 0 }, { 0xffffffff, 0 }, { 0x196d, 0x2711 },
+  { 0x10b0, 0x274d }, { 0xffffffff, 0 }, { 0x1631, 0x2756 }, { 0xffffffff, 0 },
+  { 0xffffffff, 0 }, { 0x3842, 0x2738 }, { 0xffffffff, 0 }, { 0x1462, 0x2772 },
+  { 0x196e, 0x277d }, { 0x144d, 0x2797 }, { 0x10de, 0x2776 }, { 0xffffffff, 0 },
+  { 0x174d, 0x27bc }, { 0x1acc, 0x2781 }, { 0x1558, 0x2776 }, { 0x7377, 0x2718 },
+  { 0x1554, 0x278f }, { 0xffffffff, 0 }, { 0x1043, 0x26fe }, { 0xffffffff, 0 },
+  { 0xffffffff, 0 }, { 0x103c, 0x2767 }, { 0x1a46, 0x27b6 }, { 0x1179, 0x27aa },
+  { 0x1028, 0x272a }, { 0x1025, 0x26e3 }, { 0xffffffff, 0 }, { 0x1048, 0x2733 },
+  { 0x104d, 0x27a5 }, { 0xffffffff, 0 }, { 0x174b, 0x27bc }, { 0xffffffff, 0 },
+  { 0xffffffff, 0 }, { 0xffffffff, 0 }, { 0x161f, 0x26ee }, { 0xffffffff, 0 },
+  { 0x106b, 0x26f8 }, { 0, 0x27c2 }, { 0xffffffff, 0 }, { 0xffffffff, 0 },
+  { 0x105b, 0x273d }, { 0x107d, 0x276a }, { 0xffffffff, 0 }, { 0xffffffff, 0 },
+  { 0x1102, 0x2721 }, { 0xffffffff, 0 }, { 0x1019, 0x272f }, { 0xffffffff, 0 },
+  { 0x270f, 0x2707 }, { 0x19f1, 0x2703 }, { 0x14c0, 0x26e8 }, { 0x147b, 0x26de },
+};
+
+static const struct id_table subvendor_names = { 6, 4, subvendor_names_seeds, subvendor_names_slots };
+
+static const unsigned short arch_ids_seeds[8] =
+{
+  1, 8, 2, 4, 6, 1, 1, 2,
+};
+
+static const struct id_slot arch_ids_slots[32] =
+{
+  { 0x42c, 0x800000 }, { 0xf1, 0x400 }, { 0xffffffff, 0 }, { 0xffffffff, 0 },
+  { 0xf3, 0x400 }, { 0x2e3, 0x4000 }, { 0xf8, 0x80 }, { 0xf2, 0x400 },
+  { 0xffffffff, 0 }, { 0xffffffff, 0 }, { 0x2e4, 0x4000 }, { 0xffffffff, 0 },
+  { 0xffffffff, 0 }, { 0xffffffff, 0 }, { 0xfc, 0x10 }, { 0xfa, 0x40 },
+  { 0xfd, 0x10 }, { 0xffffffff, 0 }, { 0xff, 0x10 }, { 0x2e1, 0x8000 },
+  { 0xfb, 0x80 }, { 0xffffffff, 0 }, { 0xffffffff, 0 }, { 0xf6, 0x200 },
+  { 0xf9, 0x100 }, { 0xf4, 0x400 }, { 0xf5, 0x2000 }, { 0xf0, 0x100 },
+  { 0xffffffff, 0 }, { 0x2e2, 0x8000 }, { 0xfe, 0x80 }, { 0x2e0, 0x8000 },
+};
+
+static const struct id_table arch_ids = { 5, 3, arch_ids_seeds, arch_ids_slots };
+
+static const unsigned short arch_ranges_seeds[32] =
+{
+  2, 1, 1, 1, 1, 1, 1, 1, 1, 2, 1, 1, 1, 1, 3, 1,
+  4, 1, 2, 2, 1, 1, 1, 1, 1, 1, 1, 2, 2, 3, 2, 2,
+};
+
+static const struct id_slot arch_ranges_slots[128] =
+{
+  { 0x40, 0x100 }, { 0xffffffff, 0 }, { 0xffffffff, 0 }, { 0x190, 0x40000 },
+  { 0xffffffff, 0 }, { 0xffffffff, 0 }, { 0x840, 0x100000 }, { 0xffffffff, 0 },
+  { 0xffffffff, 0 }, { 0x1d0, 0x1000 }, { 0x110, 0x2 }, { 0xffffffff, 0 },
+  { 0xffffffff, 0 }, { 0xffffffff, 0 }, { 0xa20, 0x1000000 }, { 0xffffffff, 0 },
+  { 0x200, 0x8 }, { 0xffffffff, 0 }, { 0xffffffff, 0 }, { 0xffffffff, 0 },
+  { 0xffffffff, 0 }, { 0x7e0, 0x10000 }, { 0xffffffff, 0 }, { 0x220, 0x800 },
+  { 0x6f0, 0x100000 }, { 0xffffffff, 0 }, { 0xffffffff, 0 }, { 0x300, 0x20 },
+  { 0x330, 0x80 }, { 0xc0, 0x200 }, { 0xffffffff, 0 }, { 0x860, 0x100000 },
+  { 0x120, 0x100 }, { 0xffffffff, 0 }, { 0xffffffff, 0 }, { 0x290, 0x4000 },
+  { 0xffffffff, 0 }, { 0x1f0, 0x4 }, { 0x6c0, 0x2000000 }, { 0xffffffff, 0 },
+  { 0xffffffff, 0 }, { 0xffffffff, 0 }, { 0x230, 0x100 }, { 0x650, 0x800000 },
+  { 0xffffffff, 0 }, { 0xffffffff, 0 }, { 0x530, 0x10000 }, { 0x170, 0x4 },
+  { 0xffffffff, 0 }, { 0xffffffff, 0 }, { 0xffffffff, 0 }, { 0x240, 0x10000 },
+  { 0xa70, 0x1000000 }, { 0x90, 0x2000 }, { 0xffffffff, 0 }, { 0xffffffff, 0 },
+  { 0x5e0, 0x1000000 }, { 0x5f0, 0x1000000 }, { 0x140, 0x400 }, { 0x310, 0x40 },
+  { 0xffffffff, 0 }, { 0xffffffff, 0 }, { 0x410, 0x200000 }, { 0x250, 0x10 },
+  { 0x1a0, 0x2 }, { 0xa60, 0x1000000 }, { 0x6b0, 0x1000000 }, { 0x100, 0x2 },
+  { 0xffffffff, 0 }, { 0xffffffff, 0 }, { 0x340, 0x40 }, { 0x610, 0x200000 },
+  { 0xa10, 0x1000000 }, { 0xffffffff, 0 }, { 0xffffffff, 0 }, { 0xffffffff, 0 },
+  { 0x150, 0x2 }, { 0x180, 0x4 }, { 0xffffffff, 0 }, { 0x390, 0x8000 },
+  { 0xffffffff, 0 }, { 0xffffffff, 0 }, { 0x3d0, 0x10000 }, { 0x640, 0x800000 },
+  { 0xffffffff, 0 }, { 0x850, 0x100000 }, { 0x620, 0x400000 }, { 0x630, 0x400000 },
+  { 0xffffffff, 0 }, { 0x4c0, 0x20000 }, { 0xffffffff, 0 }, { 0xffffffff, 0 },
+  { 0xffffffff, 0 }, { 0x160, 0x800 }, { 0xa00, 0x1000000 }, { 0xffffffff, 0 },
+  { 0x400, 0x80000 }, { 0xffffffff, 0 }, { 0xffffffff, 0 }, { 0x20, 0x1 },
+  { 0xffffffff, 0 }, { 0xffffffff, 0 }, { 0x380, 0x8000 }, { 0xffffffff, 0 },
+  { 0xffffffff, 0 }, { 0x130, 0x100 }, { 0xffffffff, 0 }, { 0xffffffff, 0 },
+  { 0xffffffff, 0 }, { 0x320, 0x20 }, { 0xa30, 0x1000000 }, { 0x6e0, 0x100000 },
+  { 0xffffffff, 0 }, { 0xffffffff, 0 }, { 0xffffffff, 0 }, { 0xffffffff, 0 },
+  { 0x6a0, 0x1000000 }, { 0xffffffff, 0 }, { 0x600, 0x200000 }, { 0x420, 0x100000 },
+  { 0xffffffff, 0 }, { 0xffffffff, 0 }, { 0x280, 0x10 }, { 0x210, 0x100 },
+  { 0x870, 0x100000 }, { 0xffffffff, 0 }, { 0xffffffff, 0 }, { 0xffffffff, 0 },
+};
+
+static const struct id_table arch_ranges = { 7, 5, arch_ranges_seeds, arch_ranges_slots };
+
+static const char id_names[] =
+  "Nvidia Riva TnT\0"
+  "Nvidia Riva TnT 2 Pro\0"
+  "Nvidia Riva TnT 2\0"
+  "Nvidia Riva TnT 2 Aladdin (Integrated)\0"
+  "Nvidia Riva TnT 2 VANTA\0"
+  "Nvidia Riva TnT 2 M64\0"
+  "Nvidia Riva TnT 2 Ultra\0"
+  "Nvidia Geforce 256 SDR\0"
+  "Nvidia Geforce 256 DDR\0"
+  "Nvidia Quadro\0"
+  "Nvidia Geforce 2 MX/MX400\0"
+  "Nvidia Geforce 2 MX 100/200\0"
+  "Nvidia Geforce 2 GO\0"
+  "Nvidia Quadro 2 MXR/EX/GO\0"
+  "Nvidia Geforce 2 MX integrated\0"
+  "Nvidia Geforce 2 GTS/PRO\0"
+  "Nvidia Geforce 2 Ti\0"
+  "Nvidia Geforce 2 Ultra\0"
+  "Nvidia Quadro 2 Pro\0"
+  "Nvidia Geforce 4 MX460\0"
+  "Nvidia Geforce 4 MX440\0"
+  "Nvidia Geforce 4 MX420\0"
+  "Nvidia Geforce 4 MX440 SE\0"
+  "Nvidia Geforce 4 440 Go\0"
+  "Nvidia Geforce 4 420 Go\0"
+  "Nvidia Geforce 4 420 Go 32M\0"
+  "Nvidia Geforce 4 460 Go\0"
+  "Nvidia Quadro 4 550 XGL\0"
+  "Nvidia Geforce 4 440 Go 64M\0"
+  "Nvidia Quadro 4 200/400 NVS\0"
+  "Nvidia Quadro 4 500 GoGL\0"
+  "Nvidia Geforce 410 Go\0"
+  "Nvidia Geforce 4 MX440 8X\0"
+  "Nvidia Geforce 4 MX440SE 8X\0"
+  "Nvidia Geforce 4 MX4000\0"
+  "Nvidia Geforce 4 MX420 8X\0"
+  "Nvidia Geforce 4 Go\0"
+  "Nvidia Geforce 4 488 Go\0"
+  "Nvidia Quadro 4 580 XGL\0"
+  "Nvidia GeForce4 MX with AGP8X (MAC)\0"
+  "Nvidia Quadro 4 280 NVS\0"
+  "Nvidia Quadro 4 380 XGL\0"
+  "Nvidia Quadro NVS 50 PCI\0"
+  "Nvidia Geforce 4 448 Go\0"
+  "Nvidia Geforce 4 MX integrated\0"
+  "Nvidia Geforce 3\0"
+  "Nvidia Geforce 3 Titanium 200\0"
+  "Nvidia Geforce 3 Titanium 500\0"
+  "Nvidia Quadro DCC\0"
+  "Nvidia Geforce 4 Ti 4600\0"
+  "Nvidia Geforce 4 Ti 4400\0"
+  "Nvidia GeForce4 Ti\0"
+  "Nvidia Geforce 4 Ti 4200\0"
+  "Nvidia Quadro 4 900 XGL\0"
+  "Nvidia Quadro 4 750 XGL\0"
+  "Nvidia Quadro 4 600 XGL\0"
+  "Nvidia Quadro 4 700 XGL\0"
+  "Nvidia Geforce 4 Ti 4800\0"
+  "Nvidia Geforce 4 Ti 4200 8X\0"
+  "Nvidia Geforce 4 Ti 4800SE\0"
+  "Nvidia Geforce 4 4000 GO\0"
+  "Nvidia Quadro 4 980 XGL\0"
+  "Nvidia Quadro 4 780 XGL\0"
+  "Nvidia Quadro 4 700 GoGL\0"
+  "Nvidia GeforceFX 5800\0"
+  "Nvidia GeforceFX 5800 Ultra\0"
+  "Nvidia QuadroFX 2000\0"
+  "Nvidia QuadroFX 1000\0"
+  "Nvidia ICE FX 2000\0"
+  "Nvidia GeforceFX 5600 Ultra\0"
+  "Nvidia GeforceFX 5600\0"
+  "Nvidia NV31\0"
+  "Nvidia GeforceFX 5600XT\0"
+  "Nvidia NV31GL\0"
+  "Nvidia GeforceFX Go 5600\0"
+  "Nvidia GeforceFX Go 5650\0"
+  "Nvidia QuadroFX Go700\0"
+  "Nvidia GeForce FX 5200\0"
+  "Nvidia GeforceFX 5200 Ultra\0"
+  "Nvidia GeforceFX 5200\0"
+  "Nvidia GeforceFX 5200LE\0"
+  "Nvidia GeforceFX Go 5200\0"
+  "Nvidia GeforceFX Go 5250\0"
+  "Nvidia GeforceFX 5500\0"
+  "Nvidia GeForce FX 5100\0"
+  "Nvidia GeForceFX Go5200 32M/64M\0"
+  "Nvidia GeForce FX 5200 (Mac)\0"
+  "Nvidia Quadro NVS 280 PCI\0"
+  "Nvidia QuadroFX 500\0"
+  "Nvidia GeforceFX Go5300\0"
+  "Nvidia GeforceFX Go5100\0"
+  "Nvidia NV34GL\0"
+  "Nvidia GeforceFX 5900 Ultra\0"
+  "Nvidia GeforceFX 5900\0"
+  "Nvidia GeforceFX 5900XT\0"
+  "Nvidia GeforceFX 5950 Ultra\0"
+  "Nvidia GeforceFX 5900ZT\0"
+  "Nvidia QuadroFX 3000\0"
+  "Nvidia GeforceFX 700\0"
+  "Nvidia GeforceFX 5700 Ultra\0"
+  "Nvidia GeforceFX 5700\0"
+  "Nvidia GeforceFX 5700LE\0"
+  "Nvidia GeforceFX 5700VE\0"
+  "Nvidia NV36\0"
+  "Nvidia GeforceFX Go5700\0"
+  "Nvidia Quadro FX Go1000\0"
+  "Nvidia QuadroFX 1100\0"
+  "Nvidia NV36GL\0"
+  "Nvidia Xbox GPU\0"
+  "Nvidia Geforce 6800 Ultra\0"
+  "Nvidia Geforce 6800\0"
+  "Nvidia Geforce 6800LE\0"
+  "Nvidia Geforce 6800XE\0"
+  "Nvidia Geforce 6800XT\0"
+  "Nvidia Geforce 6800GT\0"
+  "Nvidia Geforce 6800GS\0"
+  "Nvidia NV40GL\0"
+  "Nvidia QuadroFX 4400\0"
+  "Nvidia QuadroFX 4000\0"
+  "Nvidia Geforce Go 6800\0"
+  "Nvidia Geforce Go 6800Ultra\0"
+  "Nvidia QuadroFX Go 1400\0"
+  "Nvidia QuadroFX 3350/4000SDI\0"
+  "Nvidia QuadroFX 1400\0"
+  "Nvidia Geforce 6800/Ultra\0"
+  "Nvidia Geforce 6600/GT\0"
+  "Nvidia Geforce 6600\0"
+  "Nvidia Geforce 6200\0"
+  "Nvidia Geforce 6600LE\0"
+  "Nvidia Geforce 7800GS\0"
+  "Nvidia Geforce 6800GS/XT\0"
+  "Nvidia QuadroFX 3400\0"
+  "Nvidia GeforcePCX 5750\0"
+  "Nvidia GeforcePCX 5900\0"
+  "Nvidia GeforcePCX 5300 / Quadro FX330\0"
+  "Nvidia Quadro NVS280/FX330\0"
+  "Nvidia QuadroFX 1300\0"
+  "Nvidia GeforcePCX 4300\0"
+  "Nvidia Geforce 6600GT\0"
+  "Nvidia NV43\0"
+  "Nvidia Geforce Go 6600\0"
+  "Nvidia Geforce 6610XL\0"
+  "Nvidia GeForce Go 6600TE/6200TE\0"
+  "Nvidia Geforce 6700XL\0"
+  "Nvidia Geforce Go 6600GT\0"
+  "Nvidia QuadroFX 550\0"
+  "Nvidia QuadroFX 540\0"
+  "Nvidia NV44\0"
+  "Nvidia Geforce 6200 TurboCache\0"
+  "Nvidia Geforce 6200SE TurboCache\0"
+  "Nvidia Geforce Go 6200\0"
+  "Nvidia Quadro NVS 285\0"
+  "Nvidia Geforce Go 6400\0"
+  "Nvidia Geforce 6250\0"
+  "Nvidia Geforce 7100GS\0"
+  "Nvidia NV44GLM\0"
+  "Nvidia NV48\0"
+  "Nvidia Unknown NV44\0"
+  "Nvidia Geforce 6200 A-LE\0"
+  "Nvidia NV44M\0"
+  "Nvidia Geforce 6150\0"
+  "Nvidia Geforce 6150LE\0"
+  "Nvidia Geforce 6100\0"
+  "Nvidia C51\0"
+  "Nvidia Geforce Go 6150\0"
+  "Nvidia Quadro NVS 210S / Geforce 6150LE\0"
+  "Nvidia Geforce Go 6100\0"
+  "Nvidia Unknown NV4x\0"
+  "Nvidia G70\0"
+  "Nvidia Geforce 7800GTX\0"
+  "Nvidia Geforce 7800GT\0"
+  "Nvidia GeForce 7800 SLI\0"
+  "Nvidia Geforce Go 7800GTX\0"
+  "Nvidia QuadroFX 4500\0"
+  "Nvidia G70GL\0"
+  "Nvidia Geforce 7900GTX\0"
+  "Nvidia Geforce 7900GT\0"
+  "Nvidia Geforce 7900GS\0"
+  "Nvidia Geforce 7950GX2\0"
+  "Nvidia Geforce 7950GT\0"
+  "Nvidia G71\0"
+  "Nvidia Geforce Go 7950GTX\0"
+  "Nvidia Geforce Go 7900GS\0"
+  "Nvidia Geforce Go 7900GTX\0"
+  "Nvidia QuadroFX 2500M\0"
+  "Nvidia QuadroFX 1500M\0"
+  "Nvidia QuadroFX 5500\0"
+  "Nvidia QuadroFX 3500\0"
+  "Nvidia QuadroFX 1500\0"
+  "Nvidia QuadroFX 4500 X2\0"
+  "Nvidia GeForce 7650 GS\0"
+  "Nvidia Geforce 7650GS\0"
+  "Nvidia Geforce 7600GT\0"
+  "Nvidia Geforce 7600GS\0"
+  "Nvidia Geforce 7300GT\0"
+  "Nvidia Geforce 7600LE\0"
+  "Nvidia Geforce Go 7700\0"
+  "Nvidia Geforce Go 7600\0"
+  "Nvidia Geforce Go 7600GT\0"
+  "Nvidia Quadro NVS 300M\0"
+  "Nvidia Geforce Go 7900SE\0"
+  "Nvidia QuadroFX 550M\0"
+  "Nvidia QuadroFX 560\0"
+  "Nvidia GeForce 7900 GS\0"
+  "Nvidia GeForce 7350 LE\0"
+  "Nvidia Geforce 7300LE\0"
+  "Nvidia GeForce 7550 LE\0"
+  "Nvidia Geforce 7300SE\0"
+  "Nvidia GeForce Go 7350\0"
+  "Nvidia Entry Graphics\0"
+  "Nvidia GeForce Go 7200\0"
+  "Nvidia Geforce Go 7300\0"
+  "Nvidia Geforce Go 7400\0"
+  "Nvidia Geforce Go 7400GS\0"
+  "Nvidia Quadro NVS 110M\0"
+  "Nvidia Quadro NVS 120M\0"
+  "Nvidia QuadroFX 350M\0"
+  "Nvidia Geforce 7500LE\0"
+  "Nvidia QuadroFX 350\0"
+  "Nvidia Geforce 7300GS\0"
+  "Nvidia G78\0"
+  "Nvidia Geforce 8800\0"
+  "Nvidia Geforce 8800GTX\0"
+  "Nvidia Geforce 8800GTS\0"
+  "Nvidia Geforce 8800Ultra\0"
+  "Nvidia G80-875\0"
+  "Nvidia QuadroFX 5600\0"
+  "Nvidia QuadroFX 4600\0"
+  "Nvidia Geforce 8600GTS\0"
+  "Nvidia Geforce 8600GT\0"
+  "Nvidia Geforce 8600GS\0"
+  "Nvidia Geforce 8400GS\0"
+  "Nvidia Geforce 9500M GS\0"
+  "Nvidia Geforce NB9P-GE\0"
+  "Nvidia Geforce 8600M GT\0"
+  "Nvidia Geforce 8600M GTS\0"
+  "Nvidia Geforce 8700M GT\0"
+  "Nvidia Quadro NVS 370M\0"
+  "Nvidia Quadro NVS 320M\0"
+  "Nvidia QuadroFX 570M\0"
+  "Nvidia QuadroFX 1600M\0"
+  "Nvidia QuadroFX 570\0"
+  "Nvidia QuadroFX 1700\0"
+  "Nvidia GeForce GT 330\0"
+  "Nvidia Geforce 8400SE\0"
+  "Nvidia Geforce 8500GT\0"
+  "Nvidia Geforce 8300GS\0"
+  "Nvidia Geforce 8600M GS\0"
+  "Nvidia Geforce 8400M GT\0"
+  "Nvidia Geforce 8400M GS\0"
+  "Nvidia Geforce 8400M G\0"
+  "Nvidia Quadro NVS 140M\0"
+  "Nvidia Quadro NVS 130M\0"
+  "Nvidia Quadro NVS 135M\0"
+  "Nvidia GeForce 9400 GT\0"
+  "Nvidia Quadro FX 360M\0"
+  "Nvidia Geforce 9300M G\0"
+  "Nvidia Quadro NVS 290\0"
+  "Nvidia Geforce 6100 nForce 430\0"
+  "Nvidia Geforce 6100 nForce 405\0"
+  "Nvidia Geforce 6100 nForce 400\0"
+  "Nvidia MCP61\0"
+  "Nvidia Geforce 6100 nForce 420\0"
+  "Nvidia GeForce 7025 /Nvidia nForce 630a\0"
+  "Nvidia GeForce 7190M / nForce 650M\0"
+  "Nvidia GeForce 7150M / nForce 630M\0"
+  "Nvidia MCP67M\0"
+  "Nvidia GeForce 7000M / nForce 610M\0"
+  "Nvidia Geforce 7050PV nForce 630a\0"
+  "Nvidia Geforce 7025 nForce 630a\0"
+  "Nvidia GeForce GT200-400\0"
+  "Nvidia GeForce GTX 280\0"
+  "Nvidia GeForce GTX 260\0"
+  "Nvidia GeForce GTX 285\0"
+  "Nvidia GT200\0"
+  "Nvidia GeForce GTX 275\0"
+  "Nvidia Tesla C1060\0"
+  "Nvidia GeForce GTX 295\0"
+  "Nvidia Quadroplex 2200 D2\0"
+  "Nvidia Quadroplex 2200 S4\0"
+  "Nvidia Quadro CX\0"
+  "Nvidia QuadroFX 5800\0"
+  "Nvidia Quadro FX 3800\0"
+  "Nvidia Geforce 8800GTS 512\0"
+  "Nvidia GeForce 9800 GT\0"
+  "Nvidia Geforce 8800GT\0"
+  "Nvidia GeForce GT 230\0"
+  "Nvidia Geforce 9800GX2\0"
+  "Nvidia Geforce 8800GS\0"
+  "Nvidia GeForce GTS 240\0"
+  "Nvidia GeForce 9800M GTX\0"
+  "Nvidia Geforce 8800M GTS\0"
+  "Nvidia GeForce GTX 280M\0"
+  "Nvidia GeForce 9800M GT\0"
+  "Nvidia Geforce 8800M GTX\0"
+  "Nvidia GeForce 9850 X\0"
+  "Nvidia GeForce GTX 285M\0"
+  "Nvidia Geforce 9600GSO\0"
+  "Nvidia Geforce 9800GTX\0"
+  "Nvidia GeForce 9800 GTX+\0"
+  "Nvidia Geforce 9800GT\0"
+  "Nvidia GeForce GTS 250\0"
+  "Nvidia G92\0"
+  "Nvidia GeForce GTX 260M\0"
+  "Nvidia Quadro FX 4700 X2\0"
+  "Nvidia QuadroFX 3700\0"
+  "Nvidia Quadro VX 200\0"
+  "Nvidia QuadroFX 3600M\0"
+  "Nvidia Quadro FX 2800M\0"
+  "Nvidia Quadro FX 3700M\0"
+  "Nvidia Quadro FX 3800M\0"
+  "Nvidia G94\0"
+  "Nvidia Geforce 9600GT\0"
+  "Nvidia Geforce 9600GS\0"
+  "Nvidia GeForce 9600 GSO 512\0"
+  "Nvidia GeForce GT 130\0"
+  "Nvidia GeForce GT 140\0"
+  "Nvidia GeForce 9800M GTS\0"
+  "Nvidia GeForce 9700M GTS\0"
+  "Nvidia GeForce 9800M GS\0"
+  "Nvidia GeForce 9600 GT\0"
+  "Nvidia GeForce 9800 S\0"
+  "Nvidia GeForce 9700 S\0"
+  "Nvidia GeForce GTS 160M\0"
+  "Nvidia GeForce GTS 150M\0"
+  "Nvidia GeForce GT 220\0"
+  "Nvidia GeForce 9600 GSO\0"
+  "Nvidia Quadro FX 1800\0"
+  "Nvidia Quadro FX 2700M\0"
+  "Nvidia Geforce 9500GT\0"
+  "Nvidia GeForce 8400 GS\0"
+  "Nvidia GeForce 9500 GS\0"
+  "Nvidia GeForce GT 120\0"
+  "Nvidia Geforce 9600M GT\0"
+  "Nvidia Geforce 9600M GS\0"
+  "Nvidia GeForce 9700M GT\0"
+  "Nvidia Geforce 9500M G\0"
+  "Nvidia GeForce 9650M GT\0"
+  "Nvidia G96\0"
+  "Nvidia GeForce 9600 S\0"
+  "Nvidia G96-825\0"
+  "Nvidia GeForce G 110M\0"
+  "Nvidia GeForce GT 130M\0"
+  "Nvidia GeForce GT 120M\0"
+  "Nvidia GeForce GT 220M\0"
+  "Nvidia GeForce 9500 GS / GeForce 9600 S\0"
+  "Nvidia GeForce 9500 GT / GeForce 9650 S\0"
+  "Nvidia Quadro FX 380\0"
+  "Nvidia Quadro FX 580\0"
+  "Nvidia Quadro FX 1700M\0"
+  "Nvidia Quadro FX 770M\0"
+  "Nvidia GeForce G210\0"
+  "Nvidia Geforce 9300GE\0"
+  "Nvidia Geforce 9300GS\0"
+  "Nvidia Geforce 8400\0"
+  "Nvidia Geforce 9300M GS\0"
+  "Nvidia Geforce G100\0"
+  "Nvidia G98\0"
+  "Nvidia Geforce 9200M GS\0"
+  "Nvidia Quadro NVS 150M\0"
+  "Nvidia Quadro NVS 160M\0"
+  "Nvidia Geforce G105M\0"
+  "Nvidia Quadro NVS 420\0"
+  "Nvidia QuadroFX 370 LP\0"
+  "Nvidia Quadro NVS 450\0"
+  "Nvidia QuadroFX 370M\0"
+  "Nvidia Quadro NVS 295\0"
+  "Nvidia G98-GL\0"
+  "Nvidia GeForce 7150 / NVIDIA nForce 630i\0"
+  "Nvidia GeForce 7100 / NVIDIA nForce 630i\0"
+  "Nvidia GeForce 7050 / NVIDIA nForce 630i\0"
+  "Nvidia GeForce 7050 / NVIDIA nForce 610i\0"
+  "Nvidia MCP73\0"
+  "Nvidia GeForce 7050 / NVIDIA nForce 620i\0"
+  "Nvidia GeForce 8200M\0"
+  "Nvidia MCP77/78\0"
+  "Nvidia GeForce 9100M G\0"
+  "Nvidia GeForce 8200M G / GeForce 8200M\0"
+  "Nvidia GeForce 9200\0"
+  "Nvidia GeForce 9100\0"
+  "Nvidia GeForce 8300\0"
+  "Nvidia GeForce 8200\0"
+  "Nvidia nForce 730a\0"
+  "Nvidia GeForce 8200 / GeForce 9200\0"
+  "Nvidia nForce 980a/780a SLI\0"
+  "Nvidia nForce 750a SLI\0"
+  "Nvidia GeForce 8100 / nForce 720a\0"
+  "Nvidia Geforce 9300\0"
+  "Nvidia Geforce 9400\0"
+  "Nvidia GeForce 9400M G\0"
+  "Nvidia Geforce 9400M\0"
+  "Nvidia GeForce 9400\0"
+  "Nvidia nForce 760i SLI\0"
+  "Nvidia MCP7A-U\0"
+  "Nvidia GeForce 9300 / nForce 730i\0"
+  "Nvidia GeForce 8200M G\0"
+  "Nvidia GeForce 9400M\0"
+  "Nvidia GeForce G102M\0"
+  "Nvidia ION\0"
+  "Nvidia Quadro FX 470 / GeForce 9400\0"
+  "Nvidia MCP7A-GL\0"
+  "Nvidia ION LE\0"
+  "Nvidia GT212\0"
+  "Nvidia D10M2-20\0"
+  "Nvidia GeForce 315\0"
+  "Nvidia GeForce 210\0"
+  "Nvidia GeForce GT 230M\0"
+  "Nvidia GeForce GT 330M\0"
+  "Nvidia NVS 5100M\0"
+  "Nvidia GeForce GT 320M\0"
+  "Nvidia GT216\0"
+  "Nvidia GeForce GT 240M\0"
+  "Nvidia GeForce GT 325M\0"
+  "Nvidia Quadro FX 880M\0"
+  "Nvidia N10P-ES\0"
+  "Nvidia GT216-INT\0"
+  "Nvidia NVS 2100\0"
+  "Nvidia GeForce 205\0"
+  "Nvidia GeForce 310 / NVIDIA NVS 3100\0"
+  "Nvidia GeForce 310\0"
+  "Nvidia GeForce G105M\0"
+  "Nvidia NVS 2100M\0"
+  "Nvidia NVS 3100M\0"
+  "Nvidia GeForce 305M\0"
+  "Nvidia GeForce 310M\0"
+  "Nvidia GeForce G210M\0"
+  "Nvidia Quadro FX 380 LP\0"
+  "Nvidia Quadro FX 380M\0"
+  "Nvidia GT218-ES\0"
+  "Nvidia GT218-INT-S\0"
+  "Nvidia GT218-INT-B\0"
+  "Nvidia GeForce GTX 480\0"
+  "Nvidia GeForce GTX 465\0"
+  "Nvidia GeForce GTX 470\0"
+  "Abit\0"
+  "Acer\0"
+  "Ahtec\0"
+  "Alienware\0"
+  "Apple\0"
+  "Asus\0"
+  "Bfg\0"
+  "Chaintech\0"
+  "Club3D\0"
+  "Colorful\0"
+  "Creative\0"
+  "Dell\0"
+  "Ecs\0"
+  "Elsa\0"
+  "Evga\0"
+  "Foxconn\0"
+  "Fujitsu\0"
+  "Gainward\0"
+  "Gateway\0"
+  "Gigabyte\0"
+  "Hp\0"
+  "Leadtek\0"
+  "Msi\0"
+  "Nvidia\0"
+  "Pny\0"
+  "Point of View\0"
+  "Prolink\0"
+  "Sanyo/Samsung\0"
+  "Sony\0"
+  "Toshiba\0"
+  "Xfx\0"
+  "Zepto\0"
+  "Zotac\0"
+  "None\0"
+;
@@ -1,6 +1,6 @@
 unsigned int nv_read_pmc(int);
-void get_card_name(int, char *);
+const char *get_card_name(int);
 int get_gpu_arch(short);
-short get_gpu_architecture(void);
-short get_gpu_revision(void);
-void get_subvendor_name(short, char *);
+short get_gpu_architecture(NVCard *);
+short get_gpu_revision(NVCard *);
+const char *get_subvendor_name(short);
@@ -0,0 +1,614 @@
+/*
+ * Copyright(C) 2010 Andrew Powell
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA 02111-1307, USA
+ */
+
+#include <stdio.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/types.h>
+#include "backend.h"
+#include "bios.h"
+#include "init.h"
+
+/* Init scripts: the byte code the card runs at boot to program its registers.
+/
+/  Every opcode is described by the layout of its operands: the width (1, 2 or 4 bytes) of every fixed operand and,
+/  for the opcodes followed by a list, the width of every field of an entry and which fixed operand holds the number
+/  of entries.  The length of an instruction follows from that, so the decoder never has to give up on an opcode it
+/  knows nothing more about.  The layouts are the ones used by nouveau.
+/
+/  parse_init_scripts decodes every script of the init script table (and every script reached through
+/  INIT_SUB_DIRECT) once into struct init_ir: the instructions in execution order with all their operands in one
+/  array, so the users never have to go back to the raw bytes.
+*/
+
+enum
+{
+  OP_END = 0x1,        // the script ends here
+  OP_JUMP = 0x2,       // continue at the first operand
+  OP_SUB_DIRECT = 0x4, // call the script at the first operand
+  OP_RAMCFG = 0x8      // the entries repeat for every memory configuration; without a count operand there is one set
+};
+
+static const struct init_opcode
+{
+  const char *name;
+  const char *args;   // width in bytes of every fixed operand
+  const char *entry;  // width of every field of an entry; NULL if there is no list
+  u_char count;       // the fixed operand (counting from 1) with the number of entries; 0 if the number is fixed
+  u_char flags;
+} init_opcodes[256] =
+{
+  [0x32] = { "INIT_IO_RESTRICT_PROG", "211114", "4", 5, 0 },
+  [0x33] = { "INIT_REPEAT", "1", NULL, 0, 0 },
+  [0x34] = { "INIT_IO_RESTRICT_PLL", "2111114", "2", 6, 0 },
+  [0x36] = { "INIT_END_REPEAT", "", NULL, 0, 0 },
+  [0x37] = { "INIT_COPY", "411211", NULL, 0, 0 },
+  [0x38] = { "INIT_NOT", "", NULL, 0, 0 },
+  [0x39] = { "INIT_IO_FLAG_CONDITION", "1", NULL, 0, 0 },
+  [0x3a] = { "INIT_GENERIC_CONDITION", "11", NULL, 0, 0 },
+  [0x3b] = { "INIT_IO_MASK_OR", "1", NULL, 0, 0 },
+  [0x3c] = { "INIT_IO_OR", "1", NULL, 0, 0 },
+  [0x47] = { "INIT_ANDN_REG", "44", NULL, 0, 0 },
+  [0x48] = { "INIT_OR_REG", "44", NULL, 0, 0 },
+  [0x49] = { "INIT_INDEX_ADDRESS_LATCHED", "44441", "11", 5, 0 },
+  [0x4a] = { "INIT_IO_RESTRICT_PLL2", "211114", "4", 5, 0 },
+  [0x4b] = { "INIT_PLL2", "44", NULL, 0, 0 },
+  [0x4c] = { "INIT_I2C_BYTE", "111", "111", 3, 0 },
+  [0x4d] = { "INIT_ZM_I2C_BYTE", "111", "11", 3, 0 },
+  [0x4e] = { "INIT_ZM_I2C", "111", "1", 3, 0 },
+  [0x4f] = { "INIT_TMDS", "1111", NULL, 0, 0 },
+  [0x50] = { "INIT_ZM_TMDS_GROUP", "11", "11", 2, 0 },
+  [0x51] = { "INIT_CR_INDEX_ADDRESS_LATCHED", "1111", "1", 4, 0 },
+  [0x52] = { "INIT_CR", "111", NULL, 0, 0 },
+  [0x53] = { "INIT_ZM_CR", "11", NULL, 0, 0 },
+  [0x54] = { "INIT_ZM_CR_GROUP", "1", "11", 1, 0 },
+  [0x56] = { "INIT_CONDITION_TIME", "11", NULL, 0, 0 },
+  [0x57] = { "INIT_LTIME", "2", NULL, 0, 0 },
+  [0x58] = { "INIT_ZM_REG_SEQUENCE", "41", "4", 2, 0 },
+  [0x59] = { "INIT_PLL_INDIRECT", "42", NULL, 0, 0 },
+  [0x5a] = { "INIT_ZM_REG_INDIRECT", "42", NULL, 0, 0 },
+  [0x5b] = { "INIT_SUB_DIRECT", "2", NULL, 0, OP_SUB_DIRECT },
+  [0x5c] = { "INIT_JUMP", "2", NULL, 0, OP_JUMP },
+  [0x5e] = { "INIT_I2C_IF", "11111", NULL, 0, 0 },
+  [0x5f] = { "INIT_COPY_NV_REG", "414444", NULL, 0, 0 },
+  [0x62] = { "INIT_ZM_INDEX_IO", "211", NULL, 0, 0 },
+  [0x63] = { "INIT_COMPUTE_MEM", "", NULL, 0, 0 },
+  [0x65] = { "INIT_RESET", "444", NULL, 0, 0 },
+  [0x66] = { "INIT_CONFIGURE_MEM", "", NULL, 0, 0 },
+  [0x67] = { "INIT_CONFIGURE_CLK", "", NULL, 0, 0 },
+  [0x68] = { "INIT_CONFIGURE_PREINIT", "", NULL, 0, 0 },
+  [0x69] = { "INIT_IO", "211", NULL, 0, 0 },
+  [0x6b] = { "INIT_SUB", "1", NULL, 0, 0 },
+  [0x6d] = { "INIT_RAM_CONDITION", "11", NULL, 0, 0 },
+  [0x6e] = { "INIT_NV_REG", "444", NULL, 0, 0 },
+  [0x6f] = { "INIT_MACRO", "1", NULL, 0, 0 },
+  [0x71] = { "INIT_DONE", "", NULL, 0, OP_END },
+  [0x72] = { "INIT_RESUME", "", NULL, 0, 0 },
+  [0x73] = { "INIT_STRAP_CONDITION", "44", NULL, 0, 0 },
+  [0x74] = { "INIT_TIME", "2", NULL, 0, 0 },
+  [0x75] = { "INIT_CONDITION", "1", NULL, 0, 0 },
+  [0x76] = { "INIT_IO_CONDITION", "1", NULL, 0, 0 },
+  [0x77] = { "INIT_ZM_REG16", "42", NULL, 0, 0 },
+  [0x78] = { "INIT_INDEX_IO", "2111", NULL, 0, 0 },
+  [0x79] = { "INIT_PLL", "42", NULL, 0, 0 },
+  [0x7a] = { "INIT_ZM_REG", "44", NULL, 0, 0 },
+  [0x87] = { "INIT_RAM_RESTRICT_PLL", "1", "4", 0, OP_RAMCFG },
+  [0x8c] = { "INIT_RESERVED", "", NULL, 0, 0 },
+  [0x8d] = { "INIT_RESERVED", "", NULL, 0, 0 },
+  [0x8e] = { "INIT_GPIO", "", NULL, 0, 0 },
+  [0x8f] = { "INIT_RAM_RESTRICT_ZM_REG_GROUP", "411", "4", 3, OP_RAMCFG },
+  [0x90] = { "INIT_COPY_ZM_REG", "44", NULL, 0, 0 },
+  [0x91] = { "INIT_ZM_REG_GROUP", "41", "4", 2, 0 },
+  [0x92] = { "INIT_RESERVED", "", NULL, 0, 0 },
+  [0x96] = { "INIT_XLAT", "4111441", NULL, 0, 0 },
+  [0x97] = { "INIT_ZM_MASK_ADD", "444", NULL, 0, 0 },
+  [0x98] = { "INIT_AUXCH", "41", "11", 2, 0 },
+  [0x99] = { "INIT_ZM_AUXCH", "41", "1", 2, 0 },
+  [0x9a] = { "INIT_I2C_LONG_IF", "111111", NULL, 0, 0 },
+  [0xa9] = { "INIT_GPIO_NE", "1", "1", 1, 0 },
+  [0xaa] = { "INIT_RESERVED", "111", NULL, 0, 0 }
+};
+
+// Little endian regardless of the host
+static u_int init_read(const u_char *rom, u_int offset, u_int width)
+{
+  u_int value = 0;
+
+  while(width--)
+    value = value << 8 | rom[offset+width];
+  return value;
+}
+
+static u_int layout_len(const char *layout)
+{
+  u_int len = 0;
+
+  while(*layout)
+    len += *layout++ - '0';
+  return len;
+}
+
+const char *init_op_name(u_char op)
+{
+  return init_opcodes[op].name ? init_opcodes[op].name : "unknown";
+}
+
+// Length of the instruction at offset and its number of entries; 0 for unknown opcodes and instructions which run
+// past the end of the rom
+static u_int decode_len(struct nvbios *bios, u_int offset, u_int *num_entries)
+{
+  const struct init_opcode *op;
+  u_int i, pos, len, count = 0;
+
+  if(offset >= bios->rom_size || !(op = init_opcodes + bios->rom[offset])->name)
+    return 0;
+
+  len = 1 + layout_len(op->args);
+  if(len > bios->rom_size - offset)
+    return 0;
+
+  if(op->entry)
+  {
+    if(op->count)
+    {
+      for(i = 0, pos = offset + 1; i + 1 < op->count; i++)
+        pos += op->args[i] - '0';
+      count = init_read(bios->rom, pos, op->args[op->count-1] - '0');
+    }
+
+    // Without the 'M' BIT entry there is no telling how long these are
+    if(op->flags & OP_RAMCFG)
+    {
+      if(!bios->tables.ram_cfgs)
+        return 0;
+      count = (op->count ? count : 1) * bios->tables.ram_cfgs;
+    }
+
+    len += count * layout_len(op->entry);
+    if(len > bios->rom_size - offset)
+      return 0;
+  }
+
+  *num_entries = count;
+  return len;
+}
+
+// Length of the instruction at offset in bytes; 0 if it can't be decoded
+u_int init_op_len(struct nvbios *bios, u_int offset)
+{
+  u_int num_entries;
+  return decode_len(bios, offset, &num_entries);
+}
+
+/* ---- decoding into struct init_ir ---- */
+
+struct ir_builder
+{
+  struct nvbios *bios;
+  struct init_ir *ir;
+  u_int max_scripts;
+  u_int max_insns;
+  u_int max_args;
+};
+
+// Make room for n more elements of size in an array with *num used and *max allocated
+int init_reserve(void **array, u_int *max, u_int num, u_int n, size_t size)
+{
+  u_int new_max;
+  void *p;
+
+  if(num + n <= *max)
+    return 1;
+
+  for(new_max = *max ? *max : 64; new_max < num + n; new_max *= 2);
+  if(!(p = realloc(*array, new_max * size)))
+    return 0;
+
+  *array = p;
+  *max = new_max;
+  return 1;
+}
+
+static int add_script(struct ir_builder *b, u_int offset, u_short flags)
+{
+  struct init_ir *ir = b->ir;
+  struct init_script *script;
+
+  if(ir->num_scripts == INIT_MAX_SCRIPTS)
+    return 1;
+
+  if(!init_reserve((void **)&ir->scripts, &b->max_scripts, ir->num_scripts, 1, sizeof(struct init_script)))
+    return 0;
+
+  script = ir->scripts + ir->num_scripts++;
+  memset(script, 0, sizeof(struct init_script));
+  script->offset = offset;
+  script->flags = flags;
+  return 1;
+}
+
+// The INIT_SUB_DIRECT targets are decoded after the table scripts, once per target
+static int add_sub_script(struct ir_builder *b, u_int offset)
+{
+  u_int i;
+
+  for(i = 0; i < b->ir->num_scripts; i++)
+    if(b->ir->scripts[i].offset == offset)
+      return 1;
+  return add_script(b, offset, INIT_SCRIPT_SUB);
+}
+
+static int decode_insn(struct ir_builder *b, u_int offset, u_int len, u_int num_entries)
+{
+  const struct init_opcode *op = init_opcodes + b->bios->rom[offset];
+  const u_char *rom = b->bios->rom;
+  struct init_ir *ir = b->ir;
+  struct init_insn *insn;
+  u_int i, j, pos = offset + 1, num_args = strlen(op->args), entry_args = op->entry ? strlen(op->entry) : 0;
+
+  if(!init_reserve((void **)&ir->insns, &b->max_insns, ir->num_insns, 1, sizeof(struct init_insn)) ||
+     !init_reserve((void **)&ir->args, &b->max_args, ir->num_args, num_args + num_entries * entry_args, sizeof(u_int)))
+    return 0;
+
+  insn = ir->insns + ir->num_insns++;
+  insn->offset = offset;
+  insn->len = len;
+  insn->op = rom[offset];
+  insn->num_args = num_args;
+  insn->num_entries = num_entries;
+  insn->args = ir->num_args;
+
+  for(i = 0; i < num_args; pos += op->args[i++] - '0')
+    ir->args[ir->num_args++] = init_read(rom, pos, op->args[i] - '0');
+
+  for(j = 0; j < num_entries; j++)
+    for(i = 0; i < entry_args; pos += op->entry[i++] - '0')
+      ir->args[ir->num_args++] = init_read(rom, pos, op->entry[i] - '0');
+
+  return 1;
+}
+
+// Decode one script up to INIT_DONE, an opcode which can't be decoded or a jump backwards (which would loop)
+static int decode_script(struct ir_builder *b, u_int n)
+{
+  struct init_ir *ir = b->ir;
+  u_int offset = ir->scripts[n].offset, len, num_entries, target = 0;
+  u_char flags;
+
+  ir->scripts[n].first = ir->num_insns;
+
+  for(;;)
+  {
+    if(!(len = decode_len(b->bios, offset, &num_entries)))
+    {
+      ir->scripts[n].flags |= INIT_SCRIPT_TRUNCATED;
+      ir->truncated++;
+      break;
+    }
+
+    if(!decode_insn(b, offset, len, num_entries))
+      return 0;
+    ir->scripts[n].num_insns++;
+
+    flags = init_opcodes[b->bios->rom[offset]].flags;
+    if(flags & OP_END)
+    {
+      ir->scripts[n].flags |= INIT_SCRIPT_DONE;
+      break;
+    }
+
+    if(flags & (OP_JUMP | OP_SUB_DIRECT))
+      target = ir->args[ir->insns[ir->num_insns-1].args];
+
+    if(flags & OP_SUB_DIRECT && !add_sub_script(b, target))
+      return 0;
+
+    if(flags & OP_JUMP)
+    {
+      if(target <= offset)
+        break;
+      offset = target;
+    }
+    else
+      offset += len;
+  }
+
+  return 1;
+}
+
+static u_short init_pointer(struct nvbios *bios, u_int index)
+{
+  u_int offset = bios->tables.init + index * 2;
+
+  if(index * 2 + 2 > bios->tables.init_len || offset + 2 > bios->rom_size)
+    return 0;
+  return init_read(bios->rom, offset, 2);
+}
+
+// For pipeline modding purposes we cache 0x1540 and for PLL generation the PLLs, as set by INIT_ZM_REG in the first script
+static void cache_registers(struct nvbios *bios, const struct init_ir *ir)
+{
+  const struct init_insn *insn;
+  u_int i;
+
+  if(!ir->num_scripts)
+    return;
+
+  for(i = 0; i < ir->scripts[0].num_insns; i++)
+  {
+    insn = ir->insns + ir->scripts[0].first + i;
+    if(insn->op != 0x7a)
+      continue;
+
+    switch(ir->args[insn->args])
+    {
+      case 0x1540:
+        bios->pipe_cfg = ir->args[insn->args+1];
+        break;
+      case 0x4000:
+        bios->nvpll = ir->args[insn->args+1];
+        break;
+      case 0x4020:
+        bios->mpll = ir->args[insn->args+1];
+        break;
+    }
+  }
+}
+
+// Decode the init scripts once; the result stays with the bios until free_bios.  NULL if there are none or on errors.
+const struct init_ir *parse_init_scripts(struct nvbios *bios)
+{
+  struct ir_builder b;
+  u_int i, table, offset;
+
+  if(bios->init_ir || !bios->tables.init)
+    return bios->init_ir;
+
+  memset(&b, 0, sizeof(struct ir_builder));
+  b.bios = bios;
+  if(!(b.ir = calloc(1, sizeof(struct init_ir))))
+    return NULL;
+
+  // The 'I' entry: init script table, macro index table, macro table, condition table, io condition table, io flag condition table
+  table = init_pointer(bios, 0);
+  b.ir->macro_index_table = init_pointer(bios, 1);
+  b.ir->macro_table = init_pointer(bios, 2);
+  b.ir->condition_table = init_pointer(bios, 3);
+  b.ir->io_condition_table = init_pointer(bios, 4);
+  b.ir->io_flag_condition_table = init_pointer(bios, 5);
+
+  // The script table is a list of pointers ending with 0
+  for(i = 0; table && i < INIT_MAX_SCRIPTS && table + i * 2 + 2 <= bios->rom_size; i++)
+  {
+    if(!(offset = init_read(bios->rom, table + i * 2, 2)))
+      break;
+    if(!add_script(&b, offset, 0))
+      break;
+  }
+  b.ir->num_table_scripts = b.ir->num_scripts;
+
+  // New INIT_SUB_DIRECT targets are added to the end while this runs
+  for(i = 0; i < b.ir->num_scripts; i++)
+    if(!decode_script(&b, i))
+      break;
+
+  if(i < b.ir->num_scripts)
+  {
+    fprintf(bios->err ? bios->err : stderr, "Error: Out of memory while decoding the init scripts\n");
+    bios->init_ir = b.ir;
+    free_init_ir(bios);
+    return NULL;
+  }
+
+  bios->init_ir = b.ir;
+  cache_registers(bios, b.ir);
+  return b.ir;
+}
+
+void free_init_ir(struct nvbios *bios)
+{
+  struct init_ir *ir = bios->init_ir;
+
+  if(!ir)
+    return;
+
+  free(ir->scripts);
+  free(ir->insns);
+  free(ir->args);
+  free(ir->reg_writes);
+  free(ir);
+  bios->init_ir = NULL;
+}
+
+/* ---- register write index ---- */
+
+struct index_builder
+{
+  struct init_ir *ir;
+  u_int max_writes;
+  u_short script;
+  u_char ram_cfgs;
+  const struct init_insn *insn;
+};
+
+static int add_reg_write(struct index_builder *b, u_int entry, u_int reg, u_int value, u_int mask)
+{
+  struct init_reg_write *w;
+
+  if(!init_reserve((void **)&b->ir->reg_writes, &b->max_writes, b->ir->num_reg_writes, 1, sizeof(struct init_reg_write)))
+    return 0;
+
+  w = b->ir->reg_writes + b->ir->num_reg_writes++;
+  w->reg = reg;
+  w->value = value;
+  w->mask = mask;
+  w->script = b->script;
+  w->offset = b->insn->offset;
+  w->entry = entry;
+  w->op = b->insn->op;
+  return 1;
+}
+
+// The writes of one instruction to the registers in the MMIO space.  The conditional opcodes add one write for every
+// value they choose from (INIT_RAM_RESTRICT_ZM_REG_GROUP one per memory configuration, the IO_RESTRICT ones one per
+// strap), the PLL opcodes the clock instead of the register contents.  INIT_ZM_MASK_ADD, the copies and the indirect
+// writes depend on values which are not in the rom and are left out.
+static int index_insn(struct index_builder *b)
+{
+  const struct init_insn *insn = b->insn;
+  const u_int *args = b->ir->args + insn->args, *entries = args + insn->num_args;
+  u_int i, ret = 1;
+
+  switch(insn->op)
+  {
+    case 0x7a: // INIT_ZM_REG
+    case 0x77: // INIT_ZM_REG16
+      return add_reg_write(b, 0, args[0], args[1], 0xffffffff);
+    case 0x6e: // INIT_NV_REG: reg = (reg & mask) | data
+      return add_reg_write(b, 0, args[0], args[2], ~args[1]);
+    case 0x47: // INIT_ANDN_REG
+      return add_reg_write(b, 0, args[0], 0, args[1]);
+    case 0x48: // INIT_OR_REG
+      return add_reg_write(b, 0, args[0], args[1], args[1]);
+    case 0x79: // INIT_PLL, in 10 kHz
+      return add_reg_write(b, 0, args[0], args[1] * 10, 0);
+    case 0x4b: // INIT_PLL2
+      return add_reg_write(b, 0, args[0], args[1], 0);
+    case 0x58: // INIT_ZM_REG_SEQUENCE: consecutive registers
+      for(i = 0; ret && i < insn->num_entries; i++)
+        ret = add_reg_write(b, i, args[0] + i * 4, entries[i], 0xffffffff);
+      return ret;
+    case 0x91: // INIT_ZM_REG_GROUP: the same register over and over
+      for(i = 0; ret && i < insn->num_entries; i++)
+        ret = add_reg_write(b, i, args[0], entries[i], 0xffffffff);
+      return ret;
+    case 0x8f: // INIT_RAM_RESTRICT_ZM_REG_GROUP: one value per memory configuration for every register
+      for(i = 0; ret && i < insn->num_entries; i++)
+        ret = add_reg_write(b, i, args[0] + i / b->ram_cfgs * args[1], entries[i], 0xffffffff);
+      return ret;
+    case 0x32: // INIT_IO_RESTRICT_PROG
+      for(i = 0; ret && i < insn->num_entries; i++)
+        ret = add_reg_write(b, i, args[5], entries[i], 0xffffffff);
+      return ret;
+    case 0x34: // INIT_IO_RESTRICT_PLL, in 10 kHz
+      for(i = 0; ret && i < insn->num_entries; i++)
+        ret = add_reg_write(b, i, args[6], entries[i] * 10, 0);
+      return ret;
+    case 0x4a: // INIT_IO_RESTRICT_PLL2
+      for(i = 0; ret && i < insn->num_entries; i++)
+        ret = add_reg_write(b, i, args[5], entries[i], 0);
+      return ret;
+  }
+  return 1;
+}
+
+// By register, then in the order the card runs into them
+static int compare_reg_writes(const void *p1, const void *p2)
+{
+  const struct init_reg_write *a = p1, *b = p2;
+
+  if(a->reg != b->reg)
+    return a->reg < b->reg ? -1 : 1;
+  if(a->script != b->script)
+    return a->script - b->script;
+  if(a->offset != b->offset)
+    return a->offset - b->offset;
+  return a->entry - b->entry;
+}
+
+// Gather every register write of every script in one pass over the decoded instructions and sort them by register, so
+// questions like "what does this rom write to 0x4020" are a binary search.  Built once and kept with the init IR.
+const struct init_ir *index_reg_writes(struct nvbios *bios)
+{
+  struct index_builder b;
+  struct init_ir *ir;
+  u_int i, j;
+
+  if(!(ir = (struct init_ir *)parse_init_scripts(bios)) || ir->reg_writes)
+    return ir;
+
+  memset(&b, 0, sizeof(struct index_builder));
+  b.ir = ir;
+  b.ram_cfgs = bios->tables.ram_cfgs;
+
+  for(i = 0; i < ir->num_scripts; i++)
+  {
+    b.script = i;
+    for(j = 0; j < ir->scripts[i].num_insns; j++)
+    {
+      b.insn = ir->insns + ir->scripts[i].first + j;
+      if(!index_insn(&b))
+      {
+        fprintf(bios->err ? bios->err : stderr, "Error: Out of memory while indexing the init scripts\n");
+        free(ir->reg_writes);
+        ir->reg_writes = NULL;
+        ir->num_reg_writes = 0;
+        return NULL;
+      }
+    }
+  }
+
+  if(ir->num_reg_writes)
+    qsort(ir->reg_writes, ir->num_reg_writes, sizeof(struct init_reg_write), compare_reg_writes);
+  return ir;
+}
+
+// Index of the first write to a register after reg (or to reg itself if equal is set)
+static u_int search_reg_writes(const struct init_ir *ir, u_int reg, int equal)
+{
+  u_int lo = 0, hi = ir->num_reg_writes;
+
+  while(lo < hi)
+  {
+    u_int mid = lo + (hi - lo) / 2;
+
+    if(ir->reg_writes[mid].reg < reg || (!equal && ir->reg_writes[mid].reg == reg))
+      lo = mid + 1;
+    else
+      hi = mid;
+  }
+  return lo;
+}
+
+// The writes to reg in execution order; *first is left alone when there are none
+u_int find_reg_writes(const struct init_ir *ir, u_int reg, const struct init_reg_write **first)
+{
+  u_int lo = search_reg_writes(ir, reg, 1), hi = search_reg_writes(ir, reg, 0);
+
+  if(hi > lo)
+    *first = ir->reg_writes + lo;
+  return hi - lo;
+}
+
+// --reg: one line per write to find_reg_addr (with the value find_reg_value if find_reg is 2)
+void print_reg_writes(struct nvbios *bios)
+{
+  const struct init_reg_write *w;
+  const struct init_ir *ir;
+  FILE *out = bios->out ? bios->out : stdout;
+  u_int i, n;
+
+  if(!(ir = index_reg_writes(bios)))
+    return;
+
+  n = find_reg_writes(ir, bios->find_reg_addr, &w);
+  for(i = 0; i < n; i++, w++)
+    if(bios->find_reg != 2 || w->value == bios->find_reg_value)
+      fprintf(out, "%08X = %08X mask %08X  script %u at %04X %s\n", w->reg, w->value, w->mask, w->script, w->offset, init_op_name(w->op));
+}
@@ -0,0 +1,92 @@
+/*
+ * Copyright(C) 2010 Andrew Powell
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA 02111-1307, USA
+ */
+
+/* The init scripts of a BIT rom decoded into a compact instruction array, see init.c */
+
+enum
+{
+  INIT_OP_DONE = 0x71,
+
+  INIT_MAX_SCRIPTS = 256
+};
+
+struct init_insn
+{
+  unsigned short offset;    // of the opcode in the rom
+  unsigned short len;       // in bytes, operands included
+  unsigned char op;
+  unsigned char num_args;   // fixed operands, they come first in init_ir.args
+  unsigned short num_entries;
+  unsigned int args;        // index of the first operand in init_ir.args; every entry adds strlen(entry layout) more
+};
+
+enum { INIT_SCRIPT_DONE = 0x1, INIT_SCRIPT_TRUNCATED = 0x2, INIT_SCRIPT_SUB = 0x4 };
+
+struct init_script
+{
+  unsigned short offset;
+  unsigned short flags;     // INIT_SCRIPT_*: ended by INIT_OP_DONE or cut short at an unknown opcode / the end of the rom,
+                            // and whether the script is only reached through INIT_SUB_DIRECT
+  unsigned int first;       // index of the first instruction
+  unsigned int num_insns;
+};
+
+struct init_reg_write
+{
+  unsigned int reg;
+  unsigned int value;
+  unsigned int mask;        // the bits of reg which end up as in value; 0 for the PLL opcodes, whose value is a clock in kHz
+  unsigned short script;    // index in init_ir.scripts
+  unsigned short offset;    // of the instruction in the rom
+  unsigned short entry;     // which of the writes of the instruction, in execution order
+  unsigned char op;
+};
+
+struct init_ir
+{
+  unsigned short condition_table;     // from the 'I' BIT entry; 0 if there is none
+  unsigned short io_condition_table;
+  unsigned short io_flag_condition_table;
+  unsigned short macro_index_table;
+  unsigned short macro_table;
+
+  unsigned int num_scripts;
+  unsigned int num_table_scripts;     // the scripts listed in the init script table come first, then the INIT_SUB_DIRECT targets
+  struct init_script *scripts;
+
+  unsigned int num_insns;
+  struct init_insn *insns;
+
+  unsigned int num_args;
+  unsigned int *args;
+
+  unsigned int truncated;             // number of scripts with INIT_SCRIPT_TRUNCATED
+
+  unsigned int num_reg_writes;
+  struct init_reg_write *reg_writes;  // sorted by register; NULL until index_reg_writes
+};
+
+int init_reserve(void **, unsigned int *, unsigned int, unsigned int, size_t);
+const char *init_op_name(unsigned char);
+unsigned int init_op_len(struct nvbios *, unsigned int);
+const struct init_ir *parse_init_scripts(struct nvbios *);
+void free_init_ir(struct nvbios *);
+
+const struct init_ir *index_reg_writes(struct nvbios *);
+unsigned int find_reg_writes(const struct init_ir *, unsigned int, const struct init_reg_write **);
+void print_reg_writes(struct nvbios *);
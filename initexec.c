@@ -0,0 +1,551 @@
+/*
+ * Copyright(C) 2010 Andrew Powell
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA 02111-1307, USA
+ */
+
+#include <stdio.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/types.h>
+#include "backend.h"
+#include "bios.h"
+#include "init.h"
+#include "initexec.h"
+
+/* The init scripts run the way the card runs them at boot (following nouveau), only the registers live in a hash
+/  table.  Conditions clear the execute flag and everything up to INIT_RESUME (or the toggle of INIT_NOT) is passed
+/  over, INIT_REPEAT runs its body again, INIT_SUB and INIT_SUB_DIRECT call the other scripts and INIT_MACRO writes its
+/  entries of the macro table.
+/
+/  The registers outside the MMIO space (the CRTC and VGA IO ports, I2C and AUX channels, GPIOs, TMDS) are not
+/  simulated: those instructions are recorded and skipped, and the conditions on them are taken as met.  Registers
+/  which were never written read as 0.  Jumps are taken when the scripts are decoded, whether the execute flag is set
+/  or not.
+*/
+
+enum
+{
+  INIT_EXEC_MAX_DEPTH = 16,       // of INIT_SUB and INIT_SUB_DIRECT calls
+  INIT_EXEC_MAX_INSNS = 1 << 22   // nested INIT_REPEAT loops grow quickly
+};
+
+enum { EXEC_ERROR = 0, EXEC_NEXT, EXEC_DONE };
+
+struct exec_ctx
+{
+  struct nvbios *bios;
+  const struct init_ir *ir;
+  struct init_exec *e;
+  int execute;
+  u_int depth;
+};
+
+/* ---- register file ---- */
+
+static u_int reg_slot(const struct init_exec *e, u_int reg)
+{
+  return (reg * 0x9e3779b1u) >> (32 - __builtin_ctz(e->size));
+}
+
+static struct init_reg_value *find_reg(const struct init_exec *e, u_int reg)
+{
+  u_int i;
+
+  if(!e->size)
+    return NULL;
+
+  for(i = reg_slot(e, reg); e->used[i]; i = (i + 1) & (e->size - 1))
+    if(e->regs[i].reg == reg)
+      return e->regs + i;
+  return NULL;
+}
+
+static int grow_regs(struct init_exec *e)
+{
+  struct init_exec old = *e;
+  u_int i, j;
+
+  e->size = old.size ? old.size * 2 : 256;
+  e->regs = malloc(e->size * sizeof(struct init_reg_value));
+  e->used = calloc(e->size, 1);
+  if(!e->regs || !e->used)
+  {
+    free(e->regs);
+    free(e->used);
+    e->size = old.size;
+    e->regs = old.regs;
+    e->used = old.used;
+    return 0;
+  }
+
+  for(i = 0; i < old.size; i++)
+  {
+    if(!old.used[i])
+      continue;
+    for(j = reg_slot(e, old.regs[i].reg); e->used[j]; j = (j + 1) & (e->size - 1));
+    e->regs[j] = old.regs[i];
+    e->used[j] = 1;
+  }
+
+  free(old.regs);
+  free(old.used);
+  return 1;
+}
+
+int set_init_reg(struct init_exec *e, u_int reg, u_int value)
+{
+  struct init_reg_value *r;
+  u_int i;
+
+  if(!(r = find_reg(e, reg)))
+  {
+    // At most half full
+    if(e->num_regs * 2 >= e->size && !grow_regs(e))
+      return 0;
+
+    for(i = reg_slot(e, reg); e->used[i]; i = (i + 1) & (e->size - 1));
+    e->used[i] = 1;
+    e->num_regs++;
+    r = e->regs + i;
+    r->reg = reg;
+  }
+
+  r->value = value;
+  return 1;
+}
+
+// *known tells if reg was written or preset; NULL if that doesn't matter
+u_int get_init_reg(const struct init_exec *e, u_int reg, int *known)
+{
+  const struct init_reg_value *r = find_reg(e, reg);
+
+  if(known)
+    *known = r != NULL;
+  return r ? r->value : 0;
+}
+
+static u_int rd32(struct exec_ctx *c, u_int reg)
+{
+  int known;
+  u_int value = get_init_reg(c->e, reg, &known);
+
+  if(!known)
+    c->e->unknown_reads++;
+  return value;
+}
+
+static int wr32(struct exec_ctx *c, u_int reg, u_int value)
+{
+  return set_init_reg(c->e, reg, value);
+}
+
+// The bits in mask keep their value
+static int mask32(struct exec_ctx *c, u_int reg, u_int mask, u_int value)
+{
+  return wr32(c, reg, (rd32(c, reg) & mask) | value);
+}
+
+/* ---- helpers ---- */
+
+static int rom32(struct nvbios *bios, u_int offset, u_int *value)
+{
+  if(offset + 4 > bios->rom_size)
+    return 0;
+  *value = bios->rom[offset] | bios->rom[offset+1] << 8 | bios->rom[offset+2] << 16 | (u_int)bios->rom[offset+3] << 24;
+  return 1;
+}
+
+static int record_nop(struct exec_ctx *c, const struct init_insn *insn)
+{
+  struct init_exec *e = c->e;
+
+  if(!init_reserve((void **)&e->nops, &e->max_nops, e->num_nops, 1, sizeof(u_int)))
+    return 0;
+  e->nops[e->num_nops++] = insn - c->ir->insns;
+  return 1;
+}
+
+static int record_pll(struct exec_ctx *c, const struct init_insn *insn, u_int reg, u_int khz)
+{
+  struct init_exec *e = c->e;
+  struct init_pll_clock *pll;
+
+  if(!init_reserve((void **)&e->plls, &e->max_plls, e->num_plls, 1, sizeof(struct init_pll_clock)))
+    return 0;
+  pll = e->plls + e->num_plls++;
+  pll->reg = reg;
+  pll->khz = khz;
+  pll->offset = insn->offset;
+  return 1;
+}
+
+// An entry of the condition table: (register & mask) == value
+static int condition_met(struct exec_ctx *c, u_int cond)
+{
+  u_int offset = c->ir->condition_table + cond * 12, reg, mask, value;
+
+  if(!c->ir->condition_table || !rom32(c->bios, offset, &reg) || !rom32(c->bios, offset + 4, &mask) || !rom32(c->bios, offset + 8, &value))
+    return 1;
+  return (rd32(c, reg) & mask) == value;
+}
+
+// The memory configuration from the strap; -1 if there is no such configuration
+static int ram_restrict(struct exec_ctx *c)
+{
+  struct nvbios *bios = c->bios;
+  u_int strap = (rd32(c, 0x101000) & 0x3c) >> 2, cfg = 0;
+
+  if(bios->tables.ram_restrict && bios->tables.ram_restrict + strap < bios->rom_size)
+    cfg = bios->rom[bios->tables.ram_restrict + strap];
+  return cfg < bios->tables.ram_cfgs ? (int)cfg : -1;
+}
+
+// A negative shift is to the left
+static u_int shift32(u_int value, u_char shift)
+{
+  u_int n = shift & 0x80 ? 0x100 - shift : shift;
+
+  if(n > 31)
+    return 0;
+  return shift & 0x80 ? value << n : value >> n;
+}
+
+static int macro(struct exec_ctx *c, u_int index)
+{
+  struct nvbios *bios = c->bios;
+  u_int offset = c->ir->macro_index_table + index * 2, i, first, count, reg, value;
+
+  if(!c->ir->macro_index_table || !c->ir->macro_table || offset + 2 > bios->rom_size)
+    return 1;
+
+  first = bios->rom[offset];
+  count = bios->rom[offset+1];
+  for(i = 0; i < count; i++)
+  {
+    offset = c->ir->macro_table + (first + i) * 8;
+    if(!rom32(bios, offset, &reg) || !rom32(bios, offset + 4, &value))
+      break;
+    if(!wr32(c, reg, value))
+      return 0;
+  }
+  return 1;
+}
+
+/* ---- interpreter ---- */
+
+static int run_script(struct exec_ctx *, u_int);
+
+// The INIT_END_REPEAT which belongs to the INIT_REPEAT at i; end if there is none
+static u_int repeat_end(const struct init_ir *ir, u_int i, u_int end)
+{
+  u_int nested = 0;
+
+  for(i++; i < end; i++)
+  {
+    if(ir->insns[i].op == 0x33)
+      nested++;
+    else if(ir->insns[i].op == 0x36 && !nested--)
+      break;
+  }
+  return i;
+}
+
+static int sub_script(const struct init_ir *ir, u_int offset)
+{
+  u_int i;
+
+  for(i = 0; i < ir->num_scripts; i++)
+    if(ir->scripts[i].offset == offset)
+      return i;
+  return -1;
+}
+
+static int run_insn(struct exec_ctx *c, const struct init_insn *insn)
+{
+  const u_int *args = c->ir->args + insn->args, *entries = args + insn->num_args;
+  u_int i, value;
+  int cfg, n, ret = 1;
+
+  switch(insn->op)
+  {
+    // Conditions
+    case 0x75: // INIT_CONDITION
+      if(!condition_met(c, args[0]))
+        c->execute = 0;
+      return 1;
+    case 0x56: // INIT_CONDITION_TIME: the card waits up to retries * 4 * 20 ms for it
+      if(!condition_met(c, args[0]))
+      {
+        c->e->delay += args[1] * 4 * 20000;
+        c->execute = 0;
+      }
+      return 1;
+    case 0x6d: // INIT_RAM_CONDITION
+      if((rd32(c, 0x100000) & args[0]) != args[1])
+        c->execute = 0;
+      return 1;
+    case 0x73: // INIT_STRAP_CONDITION
+      if((rd32(c, 0x101000) & args[0]) != args[1])
+        c->execute = 0;
+      return 1;
+
+    // Register writes
+    case 0x7a: // INIT_ZM_REG
+    case 0x77: // INIT_ZM_REG16
+      return wr32(c, args[0], args[1]);
+    case 0x6e: // INIT_NV_REG
+      return mask32(c, args[0], args[1], args[2]);
+    case 0x47: // INIT_ANDN_REG
+      return mask32(c, args[0], ~args[1], 0);
+    case 0x48: // INIT_OR_REG
+      return mask32(c, args[0], 0xffffffff, args[1]);
+    case 0x97: // INIT_ZM_MASK_ADD
+      value = rd32(c, args[0]);
+      return wr32(c, args[0], (value & args[1]) | ((value + args[2]) & ~args[1]));
+    case 0x58: // INIT_ZM_REG_SEQUENCE
+      for(i = 0; ret && i < insn->num_entries; i++)
+        ret = wr32(c, args[0] + i * 4, entries[i]);
+      return ret;
+    case 0x91: // INIT_ZM_REG_GROUP
+      for(i = 0; ret && i < insn->num_entries; i++)
+        ret = wr32(c, args[0], entries[i]);
+      return ret;
+    case 0x8f: // INIT_RAM_RESTRICT_ZM_REG_GROUP
+      if((cfg = ram_restrict(c)) < 0)
+        return record_nop(c, insn);
+      for(i = 0; ret && i < args[2]; i++)
+        ret = wr32(c, args[0] + i * args[1], entries[i * c->bios->tables.ram_cfgs + cfg]);
+      return ret;
+    case 0x90: // INIT_COPY_ZM_REG
+      return wr32(c, args[1], rd32(c, args[0]));
+    case 0x5f: // INIT_COPY_NV_REG
+      value = shift32(rd32(c, args[0]), args[1]);
+      return mask32(c, args[4], args[5], (value & args[2]) ^ args[3]);
+    case 0x49: // INIT_INDEX_ADDRESS_LATCHED: every entry is an address and the data to write there
+      for(i = 0; ret && i < insn->num_entries; i++)
+        ret = wr32(c, args[1], entries[i*2+1]) && mask32(c, args[0], args[2], args[3] | entries[i*2]);
+      return ret;
+    case 0x5a: // INIT_ZM_REG_INDIRECT
+      if(!rom32(c->bios, args[1], &value))
+        return record_nop(c, insn);
+      return wr32(c, args[0], value);
+    case 0x65: // INIT_RESET
+      return wr32(c, args[0], args[1]) && wr32(c, args[0], args[2]);
+    case 0x6f: // INIT_MACRO
+      return macro(c, args[0]);
+
+    // Clocks
+    case 0x79: // INIT_PLL, in 10 kHz
+      return record_pll(c, insn, args[0], args[1] * 10);
+    case 0x4b: // INIT_PLL2
+      return record_pll(c, insn, args[0], args[1]);
+    case 0x59: // INIT_PLL_INDIRECT
+      if(args[1] + 2 > c->bios->rom_size)
+        return record_nop(c, insn);
+      return record_pll(c, insn, args[0], (c->bios->rom[args[1]] | c->bios->rom[args[1]+1] << 8) * 10);
+
+    case 0x74: // INIT_TIME, in us
+      c->e->delay += args[0];
+      return 1;
+    case 0x57: // INIT_LTIME, in ms
+      c->e->delay += args[0] * 1000;
+      return 1;
+
+    // Calls
+    case 0x6b: // INIT_SUB
+      if(args[0] >= c->ir->num_table_scripts)
+        return record_nop(c, insn);
+      return run_script(c, args[0]);
+    case 0x5b: // INIT_SUB_DIRECT
+      if((n = sub_script(c->ir, args[0])) < 0)
+        return record_nop(c, insn);
+      return run_script(c, n);
+
+    case 0x5c: // INIT_JUMP, already taken
+    case 0x8c: // INIT_RESERVED
+    case 0x8d:
+    case 0x92:
+    case 0xaa:
+      return 1;
+  }
+
+  return record_nop(c, insn);
+}
+
+static int run_range(struct exec_ctx *c, u_int first, u_int end)
+{
+  const struct init_insn *insn;
+  u_int i, k, n, count;
+  int ret;
+
+  for(i = first; i < end; i++)
+  {
+    insn = c->ir->insns + i;
+
+    if(++c->e->num_insns > INIT_EXEC_MAX_INSNS)
+    {
+      c->e->flags |= INIT_EXEC_TOO_LONG;
+      return EXEC_DONE;
+    }
+
+    // Control flow, whether the execute flag is set or not
+    switch(insn->op)
+    {
+      case INIT_OP_DONE:
+        return EXEC_DONE;
+      case 0x38: // INIT_NOT
+        c->execute = !c->execute;
+        continue;
+      case 0x72: // INIT_RESUME
+        c->execute = 1;
+        continue;
+      case 0x36: // INIT_END_REPEAT without INIT_REPEAT
+        continue;
+      case 0x33: // INIT_REPEAT: the body runs count times; like nouveau a count of 0 falls through the body once
+        k = repeat_end(c->ir, i, end);
+        count = c->ir->args[insn->args] ? c->ir->args[insn->args] : 1;
+        for(n = 0; n < count; n++)
+          if((ret = run_range(c, i + 1, k)) != EXEC_NEXT)
+            return ret;
+        i = k;
+        continue;
+    }
+
+    if(!c->execute)
+    {
+      c->e->num_skipped++;
+      continue;
+    }
+
+    if(!run_insn(c, insn))
+      return EXEC_ERROR;
+  }
+
+  return EXEC_NEXT;
+}
+
+// INIT_DONE ends only the script it is in
+static int run_script(struct exec_ctx *c, u_int n)
+{
+  const struct init_script *script = c->ir->scripts + n;
+  int ret;
+
+  if(c->depth == INIT_EXEC_MAX_DEPTH)
+  {
+    c->e->flags |= INIT_EXEC_TOO_DEEP;
+    return 1;
+  }
+
+  c->depth++;
+  ret = run_range(c, script->first, script->first + script->num_insns);
+  c->depth--;
+
+  return ret != EXEC_ERROR;
+}
+
+static int compare_reg_values(const void *p1, const void *p2)
+{
+  const struct init_reg_value *a = p1, *b = p2;
+
+  return a->reg < b->reg ? -1 : a->reg > b->reg;
+}
+
+// Run the scripts of the init script table in order, like the card does at boot, and leave the registers in
+// e->snapshot.  Returns 0 if the scripts can't be decoded or on errors.
+int run_init_scripts(struct nvbios *bios, struct init_exec *e)
+{
+  struct exec_ctx c;
+  u_int i, n;
+
+  memset(&c, 0, sizeof(struct exec_ctx));
+  c.bios = bios;
+  c.e = e;
+  if(!(c.ir = parse_init_scripts(bios)))
+    return 0;
+
+  for(i = 0; i < c.ir->num_table_scripts; i++)
+  {
+    c.execute = 1;
+    if(!run_script(&c, i))
+    {
+      fprintf(bios->err ? bios->err : stderr, "Error: Out of memory while running the init scripts\n");
+      return 0;
+    }
+  }
+
+  free(e->snapshot);
+  e->snapshot = NULL;
+  e->num_snapshot = 0;
+  if(!e->num_regs)
+    return 1;
+  if(!(e->snapshot = malloc(e->num_regs * sizeof(struct init_reg_value))))
+    return 0;
+
+  for(i = 0, n = 0; i < e->size; i++)
+    if(e->used[i])
+      e->snapshot[n++] = e->regs[i];
+  qsort(e->snapshot, n, sizeof(struct init_reg_value), compare_reg_values);
+  e->num_snapshot = n;
+
+  return 1;
+}
+
+void free_init_exec(struct init_exec *e)
+{
+  free(e->regs);
+  free(e->used);
+  free(e->nops);
+  free(e->plls);
+  free(e->snapshot);
+  memset(e, 0, sizeof(struct init_exec));
+}
+
+// --run-init: the registers after boot; with --reg only find_reg_addr (if it has find_reg_value)
+void print_init_exec(struct nvbios *bios)
+{
+  struct init_exec e;
+  FILE *out = bios->out ? bios->out : stdout;
+  u_int i, value;
+  int known;
+
+  memset(&e, 0, sizeof(struct init_exec));
+  if(!run_init_scripts(bios, &e))
+  {
+    free_init_exec(&e);
+    return;
+  }
+
+  if(bios->find_reg)
+  {
+    value = get_init_reg(&e, bios->find_reg_addr, &known);
+    if(known && (bios->find_reg != 2 || value == bios->find_reg_value))
+      fprintf(out, "Register %08X : %08X\n", bios->find_reg_addr, value);
+    free_init_exec(&e);
+    return;
+  }
+
+  fprintf(out, "\nInit instructions : %u run, %u skipped, %u not simulated\n", e.num_insns, e.num_skipped, e.num_nops);
+  fprintf(out, "Init delays       : %u us\n", e.delay);
+  if(e.flags)
+    fprintf(out, "Warning: The init scripts were cut short, they %s\n", e.flags & INIT_EXEC_TOO_DEEP ? "nest too deep" : "run too long");
+  for(i = 0; i < e.num_plls; i++)
+    fprintf(out, "PLL %08X      : %u kHz\n", e.plls[i].reg, e.plls[i].khz);
+  for(i = 0; i < e.num_snapshot; i++)
+    fprintf(out, "Register %08X : %08X\n", e.snapshot[i].reg, e.snapshot[i].value);
+
+  free_init_exec(&e);
+}
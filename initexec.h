@@ -0,0 +1,64 @@
+/*
+ * Copyright(C) 2010 Andrew Powell
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA 02111-1307, USA
+ */
+
+/* Running the init scripts against a register file in memory instead of a card, see initexec.c */
+
+enum { INIT_EXEC_TOO_DEEP = 0x1, INIT_EXEC_TOO_LONG = 0x2 };
+
+struct init_reg_value
+{
+  unsigned int reg;
+  unsigned int value;
+};
+
+struct init_pll_clock
+{
+  unsigned int reg;
+  unsigned int khz;
+  unsigned short offset;           // of the instruction
+};
+
+// Start from a zeroed struct; registers can be preset with set_init_reg (straps, the memory configuration, ...)
+struct init_exec
+{
+  unsigned int size;               // of the register file, a power of 2
+  unsigned int num_regs;
+  struct init_reg_value *regs;     // open addressing on the register
+  unsigned char *used;
+
+  unsigned int num_insns;          // instructions run
+  unsigned int num_skipped;        // instructions passed over because a condition failed
+  unsigned int num_nops;
+  unsigned int max_nops;
+  unsigned int *nops;              // instructions which can't be simulated (I2C, CRTC, VGA IO, ...) as indices in init_ir.insns
+  unsigned int num_plls;
+  unsigned int max_plls;
+  struct init_pll_clock *plls;     // the clocks the PLL opcodes program; the coefficients are up to the card
+  unsigned int unknown_reads;      // conditions on registers which were neither written nor preset
+  unsigned int delay;              // in us, INIT_TIME and INIT_LTIME
+  unsigned int flags;              // INIT_EXEC_*: the run was cut short
+
+  unsigned int num_snapshot;
+  struct init_reg_value *snapshot; // the register file sorted by register once run_init_scripts returns
+};
+
+int set_init_reg(struct init_exec *, unsigned int, unsigned int);
+unsigned int get_init_reg(const struct init_exec *, unsigned int, int *);
+int run_init_scripts(struct nvbios *, struct init_exec *);
+void free_init_exec(struct init_exec *);
+void print_init_exec(struct nvbios *);
@@ -23,7 +23,10 @@
 
 #include "backend.h"
 #include "back_linux.h"
+#include "back_sim.h"
 #include "bios.h"
+#include "batch.h"
+#include "format.h"
 
 //hacker.c/developer.c to trace test byte ptr's and call's?
 
@@ -45,8 +48,6 @@
 //TODO: Move the script.c here
 //TODO: MAKE THE GUI ALREADY!
 
-NVCard *nv_card;
-
 void usage(void)
 {
   printf("\nnhale v0.1\n");
@@ -55,28 +56,55 @@ void usage(void)
   printf("Options:\n");
   printf("   --list\t\t\tList all detected nvidia cards and their\n\t\t\t\tindices.\n");
   printf("   -l, --load <filename>\tLoad input file.\n");
+  printf("   -a, --all\t\t\tRead every detected card in parallel; with -s\n\t\t\t\tthe images are saved in the given directory\n\t\t\t\tand named after the PCI location\n\t\t\t\t(domain:bus:dev.fn).\n");
+  printf("   -b, --batch <dir|list>\tPrint the rom information of every file in a\n\t\t\t\tdirectory or list (one file per line, - for\n\t\t\t\tstdin) using one worker per core.\n");
   printf("   -s, --save <filename>\tSave output file.\n");
   printf("   -i, --index <num>\t\tUse card at this index for all operations.\n\t\t\t\tFind indices with --list.\n");
+  printf("   -m, --mmap-save\t\tWrite the output file through a shared memory\n\t\t\t\tmapping instead of write().\n");
   printf("   -n, --no-checksum\t\tDo not correct checksum on file save.\n");
   printf("   -p, --info\t\t\tPrint the rom information.\n");
+  printf("   --format <fmt>\t\tFormat of the rom information: text (default),\n\t\t\t\tjson, ndjson or csv.  Diagnostics go to stderr\n\t\t\t\tin all but text.\n");
+  printf("   --reg <reg>[=<value>]\tPrint the writes of the init scripts to this\n\t\t\t\tregister (hex) instead of the rom information;\n\t\t\t\tonly those of value when given.\n");
+  printf("   --run-init\t\t\tRun the init scripts against simulated registers\n\t\t\t\tand print the registers they leave behind;\n\t\t\t\tonly the one given with --reg.\n");
   printf("   -r, --ram\t\t\tAttempt to shadow bios from Video Ram (PRAMIN)\n\t\t\t\tbefore PROM.\n");
+  printf("   --sysfs <dir>\t\tLook for cards in this directory instead of\n\t\t\t\t/sys.\n");
+  printf("   --sim <dir>\t\t\tUse a simulated card serving the files pmc,\n\t\t\t\tpdisplay, pramin and prom in this directory.\n");
+  printf("   --sim-latency <ns>\t\tTime every simulated register read takes.\n");
+  printf("   --sim-flip-rate <p>\t\tProbability that a simulated PROM read returns\n\t\t\t\ta byte with one flipped bit.\n");
   printf("   -f, --force\t\t\tForce bios writing to unsupported architectures\n");
   printf("   -v, --verbose\t\tPrint verbose information.\n");
   printf("   -h, --help\t\t\tPrint this usage information.\n\n");
 }
 
+static void release_cards(NVCard *card_list, unsigned int num_cards, int simulated)
+{
+  if(simulated)
+  {
+    if(num_cards)
+      sim_close_card(card_list);
+    free(card_list);
+  }
+  else
+    free_devices(card_list, num_cards);
+}
+
 int main(int argc, char **argv)
 {
-  int c;
+  int c, ret;
   unsigned int i;
-  NVCard card_list[MAX_CARDS];
+  NVCard *card_list = NULL;
   struct nvbios bios;
-  char *infile = NULL, *outfile = NULL;
+  char *end;
+  char *infile = NULL, *outfile = NULL, *batchsrc = NULL, *simdir = NULL;
+  const char *sysfs_root = "/sys";
+  unsigned int sim_latency = 0;
+  double sim_flip_rate = 0;
   unsigned int card_index = 0;
   unsigned char card_index_flag = 0;
   unsigned int num_cards = 0;
   static int list_flag = 0;
   int print_info = 0;
+  int all_flag = 0;
   int option_index = 0;  // getopt_long stores the option index here
 
   if(argc == 1)
@@ -87,22 +115,34 @@ int main(int argc, char **argv)
 
   memset(&bios, 0, sizeof(struct nvbios));  //FIXME?
 
+  enum { OPT_SIM = 0x100, OPT_SIM_LATENCY, OPT_SIM_FLIP_RATE, OPT_SYSFS, OPT_FORMAT, OPT_REG, OPT_RUN_INIT };
+
   static struct option long_options[] =
   {
     {"list",        no_argument,       &list_flag, 1},
     {"load",        required_argument, 0, 'l'},
+    {"all",         no_argument,       0, 'a'},
+    {"batch",       required_argument, 0, 'b'},
     {"save",        required_argument, 0, 's'},
     {"index",       required_argument, 0, 'i'},
+    {"mmap-save",   no_argument,       0, 'm'},
     {"no-checksum", no_argument,       0, 'n'},
     {"info"       , no_argument,       0, 'p'},
+    {"format"     , required_argument, 0, OPT_FORMAT},
+    {"reg"        , required_argument, 0, OPT_REG},
+    {"run-init"   , no_argument,       0, OPT_RUN_INIT},
     {"ram"        , no_argument,       0, 'r'},
     {"force"      , no_argument,       0, 'f'},
     {"verbose"    , no_argument,       0, 'v'},
+    {"sysfs",         required_argument, 0, OPT_SYSFS},
+    {"sim",           required_argument, 0, OPT_SIM},
+    {"sim-latency",   required_argument, 0, OPT_SIM_LATENCY},
+    {"sim-flip-rate", required_argument, 0, OPT_SIM_FLIP_RATE},
     {"help"       , no_argument,       0, 'h'},
     {0, 0, 0, 0}
   };
 
-  while((c = getopt_long (argc, argv, "nprfvhl:s:i:", long_options, &option_index)) != -1)
+  while((c = getopt_long (argc, argv, "anmprfvhl:s:i:b:", long_options, &option_index)) != -1)
   {
     switch(c)
     {
@@ -114,16 +154,53 @@ int main(int argc, char **argv)
       case 's':
         outfile = strdup(optarg);
         break;
+      case 'a':
+        all_flag = 1;
+        break;
+      case 'b':
+        batchsrc = strdup(optarg);
+        break;
       case 'i':
         card_index = atoi(optarg);
         card_index_flag = 1;
         break;
+      case 'm':
+        bios.mmap_output = 1;
+        break;
       case 'n':
         bios.no_correct_checksum = 1;
         break;
       case 'p':
         print_info = 1;
         break;
+      case OPT_FORMAT:
+        if((ret = str_to_format(optarg)) < 0)
+        {
+          printf("Error: Unknown format %s\n", optarg);
+          return -1;
+        }
+        bios.format = ret;
+        break;
+      case OPT_REG:
+        bios.find_reg_addr = strtoul(optarg, &end, 16);
+        if(end != optarg && *end == '=')
+        {
+          bios.find_reg_value = strtoul(optarg = end + 1, &end, 16);
+          bios.find_reg = 2;
+        }
+        else
+          bios.find_reg = 1;
+        if(end == optarg || *end)
+        {
+          printf("Error: Invalid register %s\n", optarg);
+          return -1;
+        }
+        print_info = 1;
+        break;
+      case OPT_RUN_INIT:
+        bios.run_init = 1;
+        print_info = 1;
+        break;
       case 'r':
         bios.pramin_priority = 1;
         break;
@@ -136,6 +213,18 @@ int main(int argc, char **argv)
       case 'h':
         usage();
         break;
+      case OPT_SYSFS:
+        sysfs_root = strdup(optarg);
+        break;
+      case OPT_SIM:
+        simdir = strdup(optarg);
+        break;
+      case OPT_SIM_LATENCY:
+        sim_latency = atoi(optarg);
+        break;
+      case OPT_SIM_FLIP_RATE:
+        sim_flip_rate = atof(optarg);
+        break;
       default:
         usage();
         return -1;
@@ -148,7 +237,33 @@ int main(int argc, char **argv)
     return -1;
   }
 
-  num_cards = probe_devices(card_list);
+  if((bios.find_reg || bios.run_init) && bios.format != FORMAT_TEXT)
+  {
+    printf("Error: --reg and --run-init only print text\n");
+    return -1;
+  }
+
+  // Batch mode only works on files so there is no need to look for cards
+  if(batchsrc)
+    return run_batch(batchsrc, &bios) ? -1 : 0;
+
+  if(all_flag && infile)
+  {
+    printf("Error: --all reads the cards, it can not be combined with --load\n");
+    return -1;
+  }
+
+  if(simdir)
+  {
+    if(!(card_list = calloc(1, sizeof(NVCard))) || !(num_cards = sim_open_card(card_list, simdir, sim_latency, sim_flip_rate)))
+    {
+      printf("Error: Unable to set up the simulated card in %s\n", simdir);
+      return -1;
+    }
+  }
+  else
+    num_cards = probe_devices(&card_list, sysfs_root);
+
   if(!infile)
   {
     switch(num_cards)
@@ -164,7 +279,7 @@ int main(int argc, char **argv)
       default:
         if(!card_index_flag)
         {
-          if(!list_flag)
+          if(!list_flag && !all_flag)
           {
             printf("There are multiple Nvidia cards detected on this machine.\n");
             printf("Please use -i or --index to specify which card to use for operations\n");
@@ -181,37 +296,55 @@ int main(int argc, char **argv)
 
   if(list_flag)
   {
-    printf("\nIndex\t\tDevice ID\tAdapter Name\n");
+    printf("\nIndex\t\tPCI\t\tDevice ID\tAdapter Name\n");
     for(i = 0; i < num_cards; i++)
     {
-      printf("%02d\t\t%04X\t\t%s\n", i, card_list[i].device_id, card_list[i].adapter_name);
+      printf("%02d\t\t%02x:%02x.%x\t\t%04X\t\t%s\n", i, card_list[i].bus, card_list[i].device, card_list[i].function, card_list[i].device_id, card_list[i].adapter_name);
     }
     printf("\n");
   }
 
   // Nothing left to do
   if(!outfile && !print_info)
+  {
+    release_cards(card_list, num_cards, simdir != NULL);
     return 0;
+  }
 
-  if(!infile)
+  if(all_flag)
   {
-    nv_card = card_list + card_index;
-    if(!map_mem(nv_card->dev_name))
-      return -1;
+    ret = run_cards(card_list, num_cards, &bios, outfile, print_info);
+    release_cards(card_list, num_cards, simdir != NULL);
+    return ret ? -1 : 0;
   }
 
-  if(read_bios(&bios, infile))
+  // The loaders map the registers of the card when they need them; through sysfs they are not needed at all
+  if(!infile)
+    bios.card = card_list + card_index;
+
+  ret = 0;
+  if(!read_bios(&bios, infile))
+  {
+    if(!infile)
+      ret = -1;
+  }
+  else
   {
     if(print_info)
+    {
+      print_records_begin(stdout, bios.format, 0);
       print_bios_info(&bios);
+    }
 
     if(outfile)
       if(!write_bios(&bios, outfile))
-        printf("Error: Unable to dump the rom image\n");
+        fprintf(bios.format != FORMAT_TEXT ? stderr : stdout, "Error: Unable to dump the rom image\n");
   }
+  free_bios(&bios);
 
-  if(!infile)
-    unmap_mem();
+  if(!infile && bios.card->mapped)
+    NV_UNMAP_MEM(bios.card);
+  release_cards(card_list, num_cards, simdir != NULL);
 
-  return 0;
+  return ret;
 }
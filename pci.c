@@ -0,0 +1,117 @@
+/*
+ * Copyright(C) 2010 Andrew Powell
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA 02111-1307, USA
+ */
+
+// PCI enumeration through sysfs.  The config header of every device is read once when scanning,
+// after that all checks are done on the cached copy.  The sysfs root can be changed so the code can run against a fake tree.
+
+#include <dirent.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "backend.h"
+#include "pci.h"
+
+static int pci_filter(const struct dirent *entry)
+{
+  return entry->d_name[0] != '.';
+}
+
+// Read the config header of every device under <root>/bus/pci/devices; returns the number of devices or -1 if the directory can't be read
+int pci_scan(const char *root, struct pci_device **list)
+{
+  struct dirent **entries;
+  struct pci_device *devs;
+  unsigned int domain, bus, device, function;
+  char path[512];
+  FILE *fp;
+  int i, n, num_devs = 0;
+
+  *list = NULL;
+
+  snprintf(path, sizeof(path), "%s/bus/pci/devices", root);
+  if((n = scandir(path, &entries, pci_filter, alphasort)) < 0)
+    return -1;
+
+  if(!(devs = calloc(n ? n : 1, sizeof(struct pci_device))))
+    n = 0;
+
+  for(i = 0; i < n; i++)
+  {
+    struct pci_device *dev = devs + num_devs;
+
+    if(sscanf(entries[i]->d_name, "%x:%x:%x.%x", &domain, &bus, &device, &function) == 4 && strlen(entries[i]->d_name) < sizeof(dev->name))
+    {
+      snprintf(path, sizeof(path), "%s/bus/pci/devices/%s/config", root, entries[i]->d_name);
+      if((fp = fopen(path, "rb")))
+      {
+        if(fread(dev->config, 1, PCI_CONFIG_HEADER_SIZE, fp) == PCI_CONFIG_HEADER_SIZE)
+        {
+          strcpy(dev->name, entries[i]->d_name);
+          dev->domain = domain;
+          dev->bus = bus;
+          dev->device = device;
+          dev->function = function;
+          num_devs++;
+        }
+        fclose(fp);
+      }
+    }
+    free(entries[i]);
+  }
+  free(entries);
+
+  *list = devs;
+  return num_devs;
+}
+
+// The config space is little endian
+unsigned short pci_config_word(const struct pci_device *dev, unsigned int offset)
+{
+  return dev->config[offset] | dev->config[offset+1] << 8;
+}
+
+uint32_t pci_config_long(const struct pci_device *dev, unsigned int offset)
+{
+  return pci_config_word(dev, offset) | (uint32_t)pci_config_word(dev, offset + 2) << 16;
+}
+
+/* Physical start address of a BAR, from the sysfs resource file and else from the config header.
+/  The header holds the bus address which is the same on most machines.
+*/
+unsigned long long pci_resource_start(const char *root, const struct pci_device *dev, int bar)
+{
+  unsigned long long start = 0, end, flags;
+  char path[512];
+  FILE *fp;
+  int i;
+
+  snprintf(path, sizeof(path), "%s/bus/pci/devices/%s/resource", root, dev->name);
+  if((fp = fopen(path, "r")))
+  {
+    for(i = 0; i <= bar; i++)
+      if(fscanf(fp, "%llx %llx %llx", &start, &end, &flags) != 3)
+        break;
+    fclose(fp);
+
+    if(i > bar)
+      return start;
+  }
+
+  return pci_config_long(dev, PCI_BASE_ADDRESS_0 + 4 * bar) & ~0xfULL;
+}
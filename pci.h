@@ -0,0 +1,30 @@
+/*
+ * Copyright(C) 2010 Andrew Powell
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA 02111-1307, USA
+ */
+
+struct pci_device
+{
+  char name[16]; // domain:bus:device.function as used in sysfs
+  unsigned short domain;
+  unsigned char bus, device, function;
+  unsigned char config[PCI_CONFIG_HEADER_SIZE]; // cached copy of the config header
+};
+
+int pci_scan(const char *, struct pci_device **);
+unsigned short pci_config_word(const struct pci_device *, unsigned int);
+uint32_t pci_config_long(const struct pci_device *, unsigned int);
+unsigned long long pci_resource_start(const char *, const struct pci_device *, int);
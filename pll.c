@@ -0,0 +1,477 @@
+/*
+ * Copyright(C) 2010 Andrew Powell
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA 02111-1307, USA
+ */
+
+#include <pthread.h>
+#include <stdio.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/types.h>
+#include "backend.h"
+#include "bios.h"
+#include "pll.h"
+
+/* The PLLs of the NV4x and later cards multiply the crystal in one or two stages and divide the result by a power of 2:
+/
+/    vco1 = refclk * N1 / M1,  vco2 = vco1 * N2 / M2,  clock = vco2 >> log2P
+/
+/  Every stage has limits on its input (refclk / M1, vco1 / M2), on its output and on N and M, and log2P goes up to
+/  var1d of the 'C' table entry (var1e is the bias the register wants on top, it doesn't change the clock).  A PLL
+/  without VCO2 limits has one stage.
+/
+/  solve_pll never tries a coefficient the limits rule out: log2P has to put the target inside the last VCO (or leave
+/  the edge of its range closer than the best clock so far), M1 follows from the input limits, N1 from the VCO1 range,
+/  M2 from the VCO2 input limits and N2 is computed, not searched.  pll_clock_list goes through the same ranges once
+/  for every log2P and keeps the best coefficients for every kHz, so checking a clock is a binary search.
+*/
+
+enum { PLL_MAX_CLOCKS = 1 << 22 }; // kHz steps covered by one clock list
+enum { PLL_MAX_LOG2P = 31 };        // var1d is a rom byte; larger shifts make no clock and overflow the 64 bit math
+enum { PLL_MAX_COEF = 255 };        // N and M are bytes in the registers and in struct pll_coefs
+
+struct pll_key
+{
+  struct vco VCO1;
+  struct vco VCO2;
+  u_int refclk;
+  u_int max_log2p;
+};
+
+struct pll_cache
+{
+  struct pll_key key;
+  struct pll_clocks clocks;
+  struct pll_cache *next;
+};
+
+static struct pll_cache *pll_cache;
+static pthread_mutex_t pll_cache_lock = PTHREAD_MUTEX_INITIALIZER;
+
+const struct pll *find_pll(const struct nvbios *bios, u_int reg)
+{
+  u_int i;
+
+  for(i = 0; i < bios->pll_entries; i++)
+    if(bios->pll_lst[i].reg == reg)
+      return bios->pll_lst + i;
+  return NULL;
+}
+
+static uint64_t div_up(uint64_t a, uint64_t b)
+{
+  return (a + b - 1) / b;
+}
+
+/* Intersect [lo, hi] with the limits of the table (0 means no limit) and with what fits in the bytes of struct
+/  pll_coefs; the limit is still applied when the table has none, so the ranges never go past PLL_MAX_COEF.
+*/
+static int clamp_range(uint64_t lo, uint64_t hi, u_int min, u_int max, u_int *lo_out, u_int *hi_out)
+{
+  if(lo < min)
+    lo = min;
+  if(lo < 1)
+    lo = 1;
+  if(max && hi > max)
+    hi = max;
+  if(hi > PLL_MAX_COEF)
+    hi = PLL_MAX_COEF;
+
+  *lo_out = lo <= hi ? lo : 1;
+  *hi_out = lo <= hi ? hi : 0;
+  return lo <= hi;
+}
+
+// The M which keep in / M inside the input limits of a VCO; in is given as num / den kHz
+static int m_range(const struct vco *vco, uint64_t num, uint64_t den, u_int *lo, u_int *hi)
+{
+  return clamp_range(vco->maxInputFreq ? div_up(num, den * vco->maxInputFreq) : 1,
+                     vco->minInputFreq ? num / (den * vco->minInputFreq) : PLL_MAX_COEF, vco->minM, vco->maxM, lo, hi);
+}
+
+// The N which keep in * N inside the output range of a VCO
+static int n_range(const struct vco *vco, uint64_t num, uint64_t den, u_int *lo, u_int *hi)
+{
+  return clamp_range(div_up((uint64_t)vco->minFreq * den, num),
+                     vco->maxFreq ? (uint64_t)vco->maxFreq * den / num : PLL_MAX_COEF, vco->minN, vco->maxN, lo, hi);
+}
+
+static int single_stage(const struct pll *pll)
+{
+  return !pll->VCO2.maxFreq;
+}
+
+static u_int max_log2p(const struct pll *pll)
+{
+  return pll->var1d < PLL_MAX_LOG2P ? pll->var1d : PLL_MAX_LOG2P;
+}
+
+// The clock in Hz
+static uint64_t pll_hz(u_int refclk, u_int n1, u_int m1, u_int n2, u_int m2, u_int log2p)
+{
+  return (uint64_t)refclk * 1000 * n1 * n2 / ((uint64_t)m1 * m2 << log2p);
+}
+
+// The clock the coefficients make in kHz; 0 if the limits don't allow them
+u_int pll_clock(const struct pll *pll, u_int refclk, const struct pll_coefs *coefs)
+{
+  u_int lo, hi;
+
+  if(!coefs->m1 || !coefs->m2 || coefs->log2p > max_log2p(pll))
+    return 0;
+  if(!m_range(&pll->VCO1, refclk, 1, &lo, &hi) || coefs->m1 < lo || coefs->m1 > hi)
+    return 0;
+  if(!n_range(&pll->VCO1, refclk, coefs->m1, &lo, &hi) || coefs->n1 < lo || coefs->n1 > hi)
+    return 0;
+
+  if(!single_stage(pll))
+  {
+    if(!m_range(&pll->VCO2, (uint64_t)refclk * coefs->n1, coefs->m1, &lo, &hi) || coefs->m2 < lo || coefs->m2 > hi)
+      return 0;
+    if(!n_range(&pll->VCO2, (uint64_t)refclk * coefs->n1, (uint64_t)coefs->m1 * coefs->m2, &lo, &hi) || coefs->n2 < lo || coefs->n2 > hi)
+      return 0;
+  }
+  else if(coefs->n2 != 1 || coefs->m2 != 1)
+    return 0;
+
+  return (pll_hz(refclk, coefs->n1, coefs->m1, coefs->n2, coefs->m2, coefs->log2p) + 500) / 1000;
+}
+
+/* ---- one clock ---- */
+
+struct pll_search
+{
+  const struct pll *pll;
+  u_int refclk;
+  uint64_t target;       // Hz
+  uint64_t best_err;
+  struct pll_coefs best;
+};
+
+static void try_coefs(struct pll_search *s, u_int n1, u_int m1, u_int n2, u_int m2, u_int log2p)
+{
+  uint64_t hz = pll_hz(s->refclk, n1, m1, n2, m2, log2p), err = hz > s->target ? hz - s->target : s->target - hz;
+
+  if(err < s->best_err)
+  {
+    s->best_err = err;
+    s->best.n1 = n1;
+    s->best.m1 = m1;
+    s->best.n2 = n2;
+    s->best.m2 = m2;
+    s->best.log2p = log2p;
+  }
+}
+
+// The N closest to num / den within [lo, hi]
+static u_int nearest_n(uint64_t num, uint64_t den, u_int lo, u_int hi)
+{
+  uint64_t n = (num + den / 2) / den;
+
+  return n < lo ? lo : n > hi ? hi : n;
+}
+
+// The N2 which brings VCO2 (num / den * N2 kHz) closest to vco; 0 if none keeps it inside its range.  This runs for
+// every N1, M1 and M2, so the range is checked with multiplications and only divided out at its edges.
+static u_int vco2_n(const struct vco *vco2, uint64_t num, uint64_t den, uint64_t vco)
+{
+  uint64_t n = nearest_n(vco * den, num, vco2->minN ? vco2->minN : 1, vco2->maxN ? vco2->maxN : PLL_MAX_COEF);
+
+  if(num * n < vco2->minFreq * den)
+    n = div_up(vco2->minFreq * den, num);
+  else if(vco2->maxFreq && num * n > vco2->maxFreq * den)
+    n = vco2->maxFreq * den / num;
+
+  if(!n || n > PLL_MAX_COEF || n < vco2->minN || (vco2->maxN && n > vco2->maxN) || num * n < vco2->minFreq * den || (vco2->maxFreq && num * n > vco2->maxFreq * den))
+    return 0;
+  return n;
+}
+
+// One pass over the log2P: first the ones which put khz inside the last VCO, then (with clamp set) those which can't
+// reach khz but whose edge of the range is still closer than the best clock so far
+static void search_pll(struct pll_search *s, u_int khz, int clamp)
+{
+  const struct pll *pll = s->pll;
+  const struct vco *last = single_stage(pll) ? &pll->VCO1 : &pll->VCO2;
+  u_int log2p, m1, n1, m2, n2, m1_lo, m1_hi, n1_lo, n1_hi, m2_lo, m2_hi;
+  uint64_t vco, edge;
+
+  if(!m_range(&pll->VCO1, s->refclk, 1, &m1_lo, &m1_hi))
+    return;
+
+  for(log2p = 0; log2p <= max_log2p(pll) && s->best_err; log2p++)
+  {
+    // The last VCO runs at the clock times 2^log2P
+    vco = (uint64_t)khz << log2p;
+    if(vco < last->minFreq || (last->maxFreq && vco > last->maxFreq))
+    {
+      vco = vco < last->minFreq ? last->minFreq : last->maxFreq;
+      edge = (vco * 1000) >> log2p;
+      if(!clamp || (edge > s->target ? edge - s->target : s->target - edge) >= s->best_err)
+        continue;
+    }
+    else if(clamp)
+      continue;
+
+    for(m1 = m1_lo; m1 <= m1_hi && s->best_err; m1++)
+    {
+      if(!n_range(&pll->VCO1, s->refclk, m1, &n1_lo, &n1_hi))
+        continue;
+
+      if(single_stage(pll))
+      {
+        try_coefs(s, nearest_n(vco * m1, s->refclk, n1_lo, n1_hi), m1, 1, 1, log2p);
+        continue;
+      }
+
+      for(n1 = n1_lo; n1 <= n1_hi && s->best_err; n1++)
+      {
+        if(!m_range(&pll->VCO2, (uint64_t)s->refclk * n1, m1, &m2_lo, &m2_hi))
+          continue;
+
+        for(m2 = m2_lo; m2 <= m2_hi && s->best_err; m2++)
+          if((n2 = vco2_n(&pll->VCO2, (uint64_t)s->refclk * n1, (uint64_t)m1 * m2, vco)))
+            try_coefs(s, n1, m1, n2, m2, log2p);
+      }
+    }
+  }
+}
+
+// The best coefficients for khz; returns the clock they make in kHz or 0 if the limits allow none at all
+u_int solve_pll(const struct pll *pll, u_int refclk, u_int khz, struct pll_coefs *coefs)
+{
+  struct pll_search s;
+
+  memset(&s, 0, sizeof(struct pll_search));
+  s.pll = pll;
+  s.refclk = refclk;
+  s.target = (uint64_t)khz * 1000;
+  s.best_err = UINT64_MAX;
+
+  if(!khz)
+    return 0;
+
+  search_pll(&s, khz, 0);
+  search_pll(&s, khz, 1);
+  if(s.best_err == UINT64_MAX)
+    return 0;
+
+  *coefs = s.best;
+  return pll_clock(pll, refclk, coefs);
+}
+
+/* ---- all clocks ---- */
+
+struct pll_table
+{
+  u_int lo;              // kHz of the first slot
+  u_int size;
+  u_short *err;          // Hz between the slot and the best coefficients so far; 0xffff if there are none
+  struct pll_coefs *coefs;
+  u_int refclk;
+};
+
+static void add_clock(struct pll_table *t, u_int n1, u_int m1, u_int n2, u_int m2, u_int log2p)
+{
+  uint64_t hz = pll_hz(t->refclk, n1, m1, n2, m2, log2p);
+  u_int khz = (hz + 500) / 1000, err = hz > (uint64_t)khz * 1000 ? hz - (uint64_t)khz * 1000 : (uint64_t)khz * 1000 - hz;
+  struct pll_coefs *c;
+
+  if(khz < t->lo || khz - t->lo >= t->size || err >= t->err[khz - t->lo])
+    return;
+
+  t->err[khz - t->lo] = err;
+  c = t->coefs + (khz - t->lo);
+  c->n1 = n1;
+  c->m1 = m1;
+  c->n2 = n2;
+  c->m2 = m2;
+  c->log2p = log2p;
+}
+
+// Try every combination the limits allow; the slots keep the one closest to their kHz
+static void enumerate_clocks(const struct pll *pll, struct pll_table *t)
+{
+  u_int log2p, m1, n1, m2, n2, m1_lo, m1_hi, n1_lo, n1_hi, m2_lo, m2_hi, n2_lo, n2_hi;
+
+  if(!m_range(&pll->VCO1, t->refclk, 1, &m1_lo, &m1_hi))
+    return;
+
+  for(m1 = m1_lo; m1 <= m1_hi; m1++)
+  {
+    if(!n_range(&pll->VCO1, t->refclk, m1, &n1_lo, &n1_hi))
+      continue;
+
+    for(n1 = n1_lo; n1 <= n1_hi; n1++)
+    {
+      if(single_stage(pll))
+      {
+        for(log2p = 0; log2p <= max_log2p(pll); log2p++)
+          add_clock(t, n1, m1, 1, 1, log2p);
+        continue;
+      }
+
+      if(!m_range(&pll->VCO2, (uint64_t)t->refclk * n1, m1, &m2_lo, &m2_hi))
+        continue;
+
+      for(m2 = m2_lo; m2 <= m2_hi; m2++)
+      {
+        if(!n_range(&pll->VCO2, (uint64_t)t->refclk * n1, (uint64_t)m1 * m2, &n2_lo, &n2_hi))
+          continue;
+        for(n2 = n2_lo; n2 <= n2_hi; n2++)
+          for(log2p = 0; log2p <= max_log2p(pll); log2p++)
+            add_clock(t, n1, m1, n2, m2, log2p);
+      }
+    }
+  }
+}
+
+static int build_clock_list(const struct pll *pll, u_int refclk, struct pll_clocks *clocks)
+{
+  const struct vco *last = single_stage(pll) ? &pll->VCO1 : &pll->VCO2;
+  struct pll_table t;
+  u_int i, n;
+
+  memset(clocks, 0, sizeof(struct pll_clocks));
+  if(!last->maxFreq || pll->var1d > PLL_MAX_LOG2P)
+    return 0;
+
+  memset(&t, 0, sizeof(struct pll_table));
+  t.refclk = refclk;
+  t.lo = last->minFreq >> pll->var1d;
+  t.size = last->maxFreq - t.lo + 1;
+  if(t.size > PLL_MAX_CLOCKS)
+    return 0;
+
+  t.err = malloc(t.size * sizeof(u_short));
+  t.coefs = malloc(t.size * sizeof(struct pll_coefs));
+  if(!t.err || !t.coefs)
+  {
+    free(t.err);
+    free(t.coefs);
+    return 0;
+  }
+  memset(t.err, 0xff, t.size * sizeof(u_short));
+
+  enumerate_clocks(pll, &t);
+
+  for(i = 0, n = 0; i < t.size; i++)
+    n += t.err[i] != 0xffff;
+
+  clocks->khz = malloc(n * sizeof(u_int));
+  clocks->coefs = malloc(n * sizeof(struct pll_coefs));
+  if(n && (!clocks->khz || !clocks->coefs))
+  {
+    free(clocks->khz);
+    free(clocks->coefs);
+    free(t.err);
+    free(t.coefs);
+    return 0;
+  }
+
+  for(i = 0, n = 0; i < t.size; i++)
+  {
+    if(t.err[i] == 0xffff)
+      continue;
+    clocks->khz[n] = t.lo + i;
+    clocks->coefs[n++] = t.coefs[i];
+  }
+  clocks->num_clocks = n;
+
+  free(t.err);
+  free(t.coefs);
+  return 1;
+}
+
+// Every clock the PLL can make.  Cards of a family share their limits, so the lists are built once per set of limits
+// and kept until free_pll_clocks; NULL if the limits cover too wide a range or on errors.
+const struct pll_clocks *pll_clock_list(const struct pll *pll, u_int refclk)
+{
+  struct pll_key key;
+  struct pll_cache *c;
+
+  memset(&key, 0, sizeof(struct pll_key));
+  key.VCO1 = pll->VCO1;
+  key.VCO2 = pll->VCO2;
+  key.refclk = refclk;
+  key.max_log2p = pll->var1d;
+
+  pthread_mutex_lock(&pll_cache_lock);
+  for(c = pll_cache; c; c = c->next)
+    if(!memcmp(&c->key, &key, sizeof(struct pll_key)))
+      break;
+
+  if(!c && (c = malloc(sizeof(struct pll_cache))))
+  {
+    if(build_clock_list(pll, refclk, &c->clocks))
+    {
+      c->key = key;
+      c->next = pll_cache;
+      pll_cache = c;
+    }
+    else
+    {
+      free(c);
+      c = NULL;
+    }
+  }
+  pthread_mutex_unlock(&pll_cache_lock);
+
+  return c ? &c->clocks : NULL;
+}
+
+// The listed clock closest to khz and its coefficients; 0 if the list is empty
+u_int nearest_pll_clock(const struct pll_clocks *clocks, u_int khz, struct pll_coefs *coefs)
+{
+  u_int lo = 0, hi = clocks->num_clocks;
+
+  if(!hi)
+    return 0;
+
+  while(lo < hi)
+  {
+    u_int mid = lo + (hi - lo) / 2;
+
+    if(clocks->khz[mid] < khz)
+      lo = mid + 1;
+    else
+      hi = mid;
+  }
+
+  // khz lies between lo - 1 and lo
+  if(lo == clocks->num_clocks || (lo && khz - clocks->khz[lo-1] <= clocks->khz[lo] - khz))
+    lo--;
+
+  if(coefs)
+    *coefs = clocks->coefs[lo];
+  return clocks->khz[lo];
+}
+
+void free_pll_clocks(void)
+{
+  struct pll_cache *c;
+
+  pthread_mutex_lock(&pll_cache_lock);
+  while((c = pll_cache))
+  {
+    pll_cache = c->next;
+    free(c->clocks.khz);
+    free(c->clocks.coefs);
+    free(c);
+  }
+  pthread_mutex_unlock(&pll_cache_lock);
+}
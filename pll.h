@@ -0,0 +1,43 @@
+/*
+ * Copyright(C) 2010 Andrew Powell
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA 02111-1307, USA
+ */
+
+/* PLL coefficients for the limits of the BIT 'C' table, see pll.c */
+
+enum { PLL_REFCLK = 27000 }; // kHz, the crystal of the NV4x and later cards
+
+struct pll_coefs
+{
+  unsigned char n1, m1;
+  unsigned char n2, m2;     // 1 and 1 for the PLLs with only one VCO
+  unsigned char log2p;
+};
+
+// Every clock a PLL can make, sorted; built once per set of limits by pll_clock_list
+struct pll_clocks
+{
+  unsigned int num_clocks;
+  unsigned int *khz;
+  struct pll_coefs *coefs;  // the coefficients which come closest to khz
+};
+
+const struct pll *find_pll(const struct nvbios *, unsigned int);
+unsigned int pll_clock(const struct pll *, unsigned int, const struct pll_coefs *);
+unsigned int solve_pll(const struct pll *, unsigned int, unsigned int, struct pll_coefs *);
+const struct pll_clocks *pll_clock_list(const struct pll *, unsigned int);
+unsigned int nearest_pll_clock(const struct pll_clocks *, unsigned int, struct pll_coefs *);
+void free_pll_clocks(void);
@@ -0,0 +1,411 @@
+/*
+ * Copyright(C) 2010 Andrew Powell
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA 02111-1307, USA
+ */
+
+#include <string.h>
+#include <sys/types.h>
+#include "backend.h"
+#include "romgen.h"
+
+/* A generator for small but complete rom images: PCI header, BIT or BMP structure, strings, performance, voltage and
+/  temperature tables, two init scripts and a PLL table, all with a valid checksum.  The values are the same in every
+/  image so the results of different layouts can be compared; only the table versions, the device id and the size vary.
+*/
+
+struct rom_writer
+{
+  u_char *rom;
+  u_int pos;
+};
+
+static void put8(struct rom_writer *w, u_char value)
+{
+  w->rom[w->pos++] = value;
+}
+
+static void put16(struct rom_writer *w, u_short value)
+{
+  put8(w, value);
+  put8(w, value >> 8);
+}
+
+static void put32(struct rom_writer *w, u_int value)
+{
+  put16(w, value);
+  put16(w, value >> 16);
+}
+
+static void put_bytes(struct rom_writer *w, const void *data, u_int len)
+{
+  memcpy(w->rom + w->pos, data, len);
+  w->pos += len;
+}
+
+static void poke16(u_char *rom, u_int offset, u_short value)
+{
+  struct rom_writer w = { rom, offset };
+  put16(&w, value);
+}
+
+static void poke32(u_char *rom, u_int offset, u_int value)
+{
+  struct rom_writer w = { rom, offset };
+  put32(&w, value);
+}
+
+static void build_pci_header(u_char *rom, const struct romgen *gen)
+{
+  rom[0] = 0x55;
+  rom[1] = 0xAA;
+  rom[2] = gen->size >> 9;
+  poke16(rom, 0x18, 0x40);
+  memcpy(rom + 0x38, "01/02/07", 8);
+  memcpy(rom + 0x40, "PCIR", 4);
+  poke16(rom, 0x44, PCI_VENDOR_NVIDIA);
+  poke16(rom, 0x46, gen->device_id);
+  poke16(rom, 0x50, gen->size >> 9);
+  poke16(rom, 0x54, 0x1462); // MSI
+  poke16(rom, 0x56, 0x0345);
+}
+
+static void build_perf_table(struct rom_writer *w, u_char version)
+{
+  static const u_short nv4x_clks[3][2] = { { 275, 350 }, { 400, 500 }, { 430, 600 } };
+  static const u_short nv5x_clks[2][3] = { { 300, 600, 400 }, { 650, 1625, 950 } };
+  u_int i, entry, fan = version == 0x25 ? 4 : 6;
+
+  // version, header size, active entries, entry size
+  put8(w, version);
+  put8(w, 6);
+  put8(w, version < 0x25 ? 3 : 2);
+  put8(w, 14);
+  put16(w, 0);
+
+  if(version < 0x25)
+  {
+    for(i = 0; i < 3; i++, w->pos += 14)
+    {
+      entry = w->pos;
+      w->rom[entry] = 0x20 + i;
+      w->rom[entry+4] = 40 + 10 * i;   // fan
+      w->rom[entry+5] = 110 + 10 * i;  // voltage
+      poke16(w->rom, entry + 6, nv4x_clks[i][0]);
+      poke16(w->rom, entry + 11, nv4x_clks[i][1]);
+    }
+  }
+  else
+  {
+    for(i = 0; i < 2; i++, w->pos += 14)
+    {
+      entry = w->pos;
+      w->rom[entry] = 0x20 + i;
+      w->rom[entry+fan] = 50 + i;
+      w->rom[entry+fan+1] = 100 + 5 * i;
+      poke16(w->rom, entry + 8, nv5x_clks[i][0]);
+      poke16(w->rom, entry + 10, nv5x_clks[i][1]);
+      poke16(w->rom, entry + 12, nv5x_clks[i][2]);
+    }
+  }
+
+  // End token
+  put32(w, 0x04104B4D);
+  w->pos += 4;
+}
+
+static void build_temp_table(struct rom_writer *w)
+{
+  static const u_short entries[5][2] = { { 0x1, 0x0a00 }, { 0x4, 110 << 4 }, { 0x5, 100 << 4 }, { 0x10, 10 }, { 0x11, 3 } };
+  u_int i;
+
+  put8(w, 0x20);
+  put8(w, 4);
+  put8(w, 3);
+  put8(w, 5);
+
+  for(i = 0; i < 5; i++)
+  {
+    put8(w, entries[i][0]);
+    put16(w, entries[i][1]);
+  }
+  w->pos += 4;
+}
+
+// Version 0x10 has no entry count in the header, the parser reads all MAX_VOLT_LVLS entries
+static void build_volt_table(struct rom_writer *w, u_char version)
+{
+  static const u_char header[3][4] = { { 0x10, 2, 3, 0 }, { 0x20, 5, 3, 2 }, { 0x30, 5, 2, 2 } };
+  static const u_char first_voltage[3] = { 100, 110, 105 };
+  u_int i, num, v = version == 0x10 ? 0 : version == 0x20 ? 1 : 2;
+
+  // version, header size, active entries, entry size, VID mask
+  put_bytes(w, header[v], 4);
+  put8(w, 0x1f);
+
+  num = v ? header[v][2] : 7;
+  for(i = 0; i < num; i++)
+  {
+    put8(w, first_voltage[v] + 5 * i);
+    put8(w, i);
+  }
+
+  if(v)
+    put16(w, v == 1 ? 0x4D49 : 0x0424);
+  w->pos += 4;
+}
+
+static void build_init_body(struct rom_writer *w)
+{
+  put8(w, 0x7a); put32(w, 0x1540); put32(w, 0x3f00ff01);                   // INIT_ZM_REG
+  put8(w, 0x7a); put32(w, 0x4000); put32(w, 0x00011c07);
+  put8(w, 0x6e); put32(w, 0x4020); put32(w, 0xffff0000); put32(w, 0x1234); // register, AND-mask, value
+  put8(w, 0x79); put32(w, 0x4020); put16(w, 40000);                         // PLL register, clock
+  put8(w, 0x75); put8(w, 0);                                                // INIT_CONDITION
+  put8(w, 0x7a); put32(w, 0x4020); put32(w, 0x00021d08);
+  put8(w, 0x72);                                                            // INIT_RESUME
+  put8(w, 0x33); put8(w, 2);                                                // INIT_REPEAT
+  put8(w, 0x53); put8(w, 0x1f); put8(w, 0x2);                               // INIT_ZM_CR
+  put8(w, 0x36);                                                            // INIT_REPEAT_END
+}
+
+// Two init scripts touching PLL and CRTC registers; returns the offset of the script table
+static u_int build_init_scripts(struct rom_writer *w, u_int repeat)
+{
+  u_int i, table = w->pos, script1, script2;
+
+  w->pos += 8;
+  script1 = w->pos;
+  for(i = 0; i <= repeat; i++)
+    build_init_body(w);
+  put8(w, 0x71);                                                            // INIT_DONE
+
+  script2 = w->pos;
+  put8(w, 0x32); put16(w, 0x3d4); put8(w, 0x3c); put8(w, 0xff); put8(w, 0); put8(w, 2);
+  put32(w, 0x680500); put32(w, 1); put32(w, 2);
+  put8(w, 0x58); put32(w, 0x100200); put8(w, 2); put32(w, 7); put32(w, 8);  // register base, count, values
+  put8(w, 0x71);
+
+  poke16(w->rom, table, script1);
+  poke16(w->rom, table + 2, script2);
+  poke16(w->rom, table + 4, 0);
+  return table;
+}
+
+static u_int build_pll_table(struct rom_writer *w)
+{
+  static const u_int regs[2] = { 0x4000, 0x4020 };
+  static const u_char limits[8] = { 1, 255, 1, 13, 0, 0, 0, 0 };
+  u_int i, table = w->pos;
+
+  // version, header size, entry size, entries
+  put8(w, 0x20);
+  put8(w, 4);
+  put8(w, 0x20);
+  put8(w, 2);
+
+  for(i = 0; i < 2; i++)
+  {
+    u_int entry = w->pos;
+
+    put32(w, regs[i]);
+    put16(w, 400);   // VCO1 frequency range
+    put16(w, 1000);
+    put16(w, 0);     // VCO2
+    put16(w, 0);
+    put16(w, 5);     // VCO1 input range
+    put16(w, 27);
+    put16(w, 0);
+    put16(w, 0);
+    put_bytes(w, limits, 8);
+    w->rom[entry+0x1d] = 6;
+    w->pos = entry + 0x20;
+  }
+  return table;
+}
+
+// Returns the end of the data, build_rom checks that it fits
+static u_int build_bit(u_char *rom, const struct romgen *gen)
+{
+  static const char *strings[7] = { "Sign on text\r\n", "Version 5.47\r\n", "Copyright (C) NV\r\n", "OEM", "NVIDIA", "G70 Board", "Chip Rev" };
+  static const u_char string_order[7] = { 0, 1, 3, 4, 5, 6, 2 };
+  struct rom_writer w = { rom, 0x400 };
+  u_int i, bit = 0x100, b, info, s, perf, temp, volt, p, init, init_ptrs, pll, c;
+  u_int str_offset[7], str_len[7];
+  char release[0x2e];
+
+  // 'B': bios version and text time
+  b = w.pos;
+  poke32(rom, b, 0x05470300);
+  rom[b+4] = 0x12;
+  poke16(rom, b + 0xa, 150);
+  w.pos += 0x20;
+
+  // 'i': second version, board id, build date and hierarchy
+  info = w.pos;
+  poke32(rom, info, 0x05470301);
+  rom[info+4] = 0x34;
+  poke16(rom, info + 0xb, 0xE123);
+  memcpy(rom + info + 0xf, "03/04/08", 8);
+  rom[info+0x24] = 1;
+  w.pos += 0x30;
+
+  for(i = 0; i < 7; i++)
+  {
+    u_int n = string_order[i];
+
+    str_offset[n] = w.pos;
+    str_len[n] = strlen(strings[n]);
+    put_bytes(&w, strings[n], str_len[n]);
+    w.pos++;
+  }
+  w.pos += 0x30;
+
+  // The release string is stored inverted right after the copyright string
+  memset(release, ' ', sizeof(release));
+  memcpy(release, "Release 1.0", 11);
+  for(i = 0; i < sizeof(release); i++)
+    rom[str_offset[2]+str_len[2]+1+i] = ~release[i];
+
+  // 'S': offset and length of every string
+  s = w.pos;
+  for(i = 0; i < 7; i++)
+  {
+    put16(&w, str_offset[i]);
+    put8(&w, str_len[i]);
+  }
+  w.pos = s + 0x18;
+
+  perf = w.pos;
+  build_perf_table(&w, gen->perf_version);
+  temp = w.pos;
+  build_temp_table(&w);
+  volt = w.pos;
+  build_volt_table(&w, gen->volt_version);
+
+  // 'P': the perf, temperature and voltage tables
+  p = w.pos;
+  poke16(rom, p, perf);
+  poke16(rom, p + 0xc, temp);
+  poke16(rom, p + 0x10, volt);
+  w.pos += 0x20;
+
+  // 'I': the init script table and the condition table right after the pointers
+  init = build_init_scripts(&w, gen->init_repeat);
+  init_ptrs = w.pos;
+  poke16(rom, init_ptrs, init);
+  poke16(rom, init_ptrs + 6, init_ptrs + 0x10);
+  w.pos += 0x10;
+  poke32(rom, w.pos, 0x1540);
+  poke32(rom, w.pos + 4, 0xff);
+  poke32(rom, w.pos + 8, 0x01);
+  w.pos += 0x10;
+
+  // 'C': the PLL limits
+  pll = build_pll_table(&w);
+  c = w.pos;
+  poke16(rom, c + 8, pll);
+  w.pos += 0x10;
+
+  // The BIT structure: id, version, length and offset of every entry
+  rom[bit-2] = 0xff;
+  rom[bit-1] = 0xb8;
+  memcpy(rom + bit, "BIT", 4);
+  {
+    struct rom_writer e = { rom, bit + 4 };
+    const u_int entries[8][4] =
+    {
+      { 0, 1, 0x060C, 0x0402 },
+      { 'B', 1, 0x0c, b },
+      { 'C', 1, 0x10, c },
+      { 'I', 1, 0x0e, init_ptrs },
+      { 'P', 1, 0x14, p },
+      { 'S', 1, 0x15, s },
+      { 'i', 1, 0x26, info },
+      { 0, 0, 0, 0 }
+    };
+
+    for(i = 0; i < 8; i++)
+    {
+      put8(&e, entries[i][0]);
+      put8(&e, entries[i][1]);
+      put16(&e, entries[i][2]);
+      put16(&e, entries[i][3]);
+    }
+  }
+
+  return w.pos;
+}
+
+static u_int build_bmp(u_char *rom, const struct romgen *gen)
+{
+  static const char name[] = "GeForce FX 5900\r\n";
+  u_int i, nv = 0x100, str = 0x300, volt = 0x380, perf = 0x400;
+  struct rom_writer w;
+
+  memcpy(rom + nv, "\xff\x7fNV", 4);
+  rom[nv+5] = 5;    // BMP version 5.25
+  rom[nv+6] = 0x25;
+  poke32(rom, nv + 10, 0x04350012);
+
+  memcpy(rom + str, name, sizeof(name) - 1);
+  poke16(rom, nv + 30, str);
+
+  w.rom = rom;
+  w.pos = volt;
+  build_volt_table(&w, 0x10);
+
+  // 64 byte entries with the clocks in 10 kHz and the fan speed and voltage near the end
+  rom[perf] = 3;
+  rom[perf+2] = 3;
+  rom[perf+3] = 64;
+  for(i = 0; i < 3; i++)
+  {
+    u_int entry = perf + 4 + 64 * i;
+
+    poke32(rom, entry, 30000 + 10000 * i);
+    poke32(rom, entry + 4, 25000 + 5000 * i);
+    rom[entry+54] = 50 + i;
+    rom[entry+55] = 120 + i;
+  }
+
+  poke16(rom, nv + 0x94, perf);
+  poke16(rom, nv + 0x98, volt);
+
+  return perf + 4 + 64 * 3;
+}
+
+// Build the image described by gen into rom (at least gen->size bytes); returns the size or 0 if it does not fit
+u_int romgen_build(const struct romgen *gen, u_char *rom)
+{
+  u_int i, end;
+  u_char sum = 0;
+
+  if(gen->size < 0x1000 || gen->size > NV_PROM_SIZE || gen->size & 0x1ff)
+    return 0;
+
+  memset(rom, 0, gen->size);
+  build_pci_header(rom, gen);
+  end = gen->perf_version ? build_bit(rom, gen) : build_bmp(rom, gen);
+
+  if(end > gen->size - 16)
+    return 0;
+
+  for(i = 0; i < gen->size - 1; i++)
+    sum += rom[i];
+  rom[gen->size-1] = -sum;
+
+  return gen->size;
+}
@@ -0,0 +1,30 @@
+/*
+ * Copyright(C) 2010 Andrew Powell
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA 02111-1307, USA
+ */
+
+/* Synthetic rom images for the benchmarks, see romgen.c */
+
+struct romgen
+{
+  unsigned int size;          // a multiple of 512, at most NV_PROM_SIZE
+  unsigned short device_id;   // has to match the table versions, the parsers pick their layout by architecture
+  unsigned char perf_version; // BIT performance table version (0x21 - 0x35); 0 makes a BMP (NV3X) image
+  unsigned char volt_version; // BIT voltage table version (0x10, 0x20 or 0x30)
+  unsigned char init_repeat;  // extra copies of the body of the first init script, for benchmarks on longer scripts
+};
+
+unsigned int romgen_build(const struct romgen *, unsigned char *);
@@ -0,0 +1,169 @@
+/*
+ * Copyright(C) 2010 Andrew Powell
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA 02111-1307, USA
+ */
+
+#include <sys/types.h>
+#include "search.h"
+
+#if defined(__x86_64__) || defined(__i386__)
+  #include <immintrin.h>
+  #define NHALE_X86
+#endif
+
+/* Masked pattern search: find every offset where (buf[i+j] & mask[j]) == (str[j] & mask[j]) for all j < len.
+/  At most max_matches offsets are stored in matches (in increasing order) and the number found is returned.
+/
+/  The vector versions only test two "anchor" bytes of the pattern (the first and the last one with a non-zero mask)
+/  for 16 or 32 offsets at once and only check the complete pattern on the offsets where both anchors match.
+*/
+
+static int masked_match(const u_char *buf, const u_char *str, const u_char *mask, u_int len)
+{
+  u_int j;
+
+  for(j = 0; j < len; j++)
+    if((buf[j] & mask[j]) != (str[j] & mask[j]))
+      return 0;
+  return 1;
+}
+
+// Plain byte by byte search; this is also used for the tails the vector versions can't handle
+static u_int masked_search_from(const u_char *buf, u_int size, u_int i, const u_char *str, const u_char *mask, u_int len, u_int *matches, u_int n, u_int max_matches)
+{
+  for(; n < max_matches && i <= size - len; i++)
+    if(masked_match(buf + i, str, mask, len))
+      matches[n++] = i;
+  return n;
+}
+
+u_int masked_search_scalar(const u_char *buf, u_int size, const u_char *str, const u_char *mask, u_int len, u_int *matches, u_int max_matches)
+{
+  if(!len || len > size || !max_matches)
+    return 0;
+
+  return masked_search_from(buf, size, 0, str, mask, len, matches, 0, max_matches);
+}
+
+#ifdef NHALE_X86
+
+// Returns 0 if the mask is empty, in which case every offset matches
+static int masked_anchors(const u_char *mask, u_int len, u_int *first, u_int *last)
+{
+  u_int j;
+
+  for(j = 0; j < len && !mask[j]; j++);
+  if(j == len)
+    return 0;
+  *first = j;
+
+  for(j = len - 1; !mask[j]; j--);
+  *last = j;
+
+  return 1;
+}
+
+__attribute__((target("sse2")))
+static u_int masked_search_sse2(const u_char *buf, u_int size, const u_char *str, const u_char *mask, u_int len, u_int *matches, u_int max_matches)
+{
+  u_int i, a, b, bits, n = 0, end = size - len + 1;
+  __m128i mask_a, mask_b, val_a, val_b, eq_a, eq_b;
+
+  if(!masked_anchors(mask, len, &a, &b))
+    return masked_search_from(buf, size, 0, str, mask, len, matches, 0, max_matches);
+
+  mask_a = _mm_set1_epi8(mask[a]);
+  mask_b = _mm_set1_epi8(mask[b]);
+  val_a = _mm_set1_epi8(str[a] & mask[a]);
+  val_b = _mm_set1_epi8(str[b] & mask[b]);
+
+  // All loads stay inside the buffer as long as the last tested offset is a valid match offset
+  for(i = 0; i + 16 <= end; i += 16)
+  {
+    eq_a = _mm_cmpeq_epi8(_mm_and_si128(_mm_loadu_si128((const __m128i *)(buf + i + a)), mask_a), val_a);
+    eq_b = _mm_cmpeq_epi8(_mm_and_si128(_mm_loadu_si128((const __m128i *)(buf + i + b)), mask_b), val_b);
+    bits = _mm_movemask_epi8(_mm_and_si128(eq_a, eq_b));
+
+    while(bits)
+    {
+      u_int k = i + __builtin_ctz(bits);
+      bits &= bits - 1;
+
+      if(masked_match(buf + k, str, mask, len))
+      {
+        matches[n++] = k;
+        if(n == max_matches)
+          return n;
+      }
+    }
+  }
+
+  return masked_search_from(buf, size, i, str, mask, len, matches, n, max_matches);
+}
+
+__attribute__((target("avx2")))
+static u_int masked_search_avx2(const u_char *buf, u_int size, const u_char *str, const u_char *mask, u_int len, u_int *matches, u_int max_matches)
+{
+  u_int i, a, b, bits, n = 0, end = size - len + 1;
+  __m256i mask_a, mask_b, val_a, val_b, eq_a, eq_b;
+
+  if(!masked_anchors(mask, len, &a, &b))
+    return masked_search_from(buf, size, 0, str, mask, len, matches, 0, max_matches);
+
+  mask_a = _mm256_set1_epi8(mask[a]);
+  mask_b = _mm256_set1_epi8(mask[b]);
+  val_a = _mm256_set1_epi8(str[a] & mask[a]);
+  val_b = _mm256_set1_epi8(str[b] & mask[b]);
+
+  for(i = 0; i + 32 <= end; i += 32)
+  {
+    eq_a = _mm256_cmpeq_epi8(_mm256_and_si256(_mm256_loadu_si256((const __m256i *)(buf + i + a)), mask_a), val_a);
+    eq_b = _mm256_cmpeq_epi8(_mm256_and_si256(_mm256_loadu_si256((const __m256i *)(buf + i + b)), mask_b), val_b);
+    bits = (u_int)_mm256_movemask_epi8(_mm256_and_si256(eq_a, eq_b));
+
+    while(bits)
+    {
+      u_int k = i + __builtin_ctz(bits);
+      bits &= bits - 1;
+
+      if(masked_match(buf + k, str, mask, len))
+      {
+        matches[n++] = k;
+        if(n == max_matches)
+          return n;
+      }
+    }
+  }
+
+  return masked_search_from(buf, size, i, str, mask, len, matches, n, max_matches);
+}
+
+#endif
+
+u_int masked_search(const u_char *buf, u_int size, const u_char *str, const u_char *mask, u_int len, u_int *matches, u_int max_matches)
+{
+  if(!len || len > size || !max_matches)
+    return 0;
+
+#ifdef NHALE_X86
+  if(__builtin_cpu_supports("avx2"))
+    return masked_search_avx2(buf, size, str, mask, len, matches, max_matches);
+  if(__builtin_cpu_supports("sse2"))
+    return masked_search_sse2(buf, size, str, mask, len, matches, max_matches);
+#endif
+
+  return masked_search_scalar(buf, size, str, mask, len, matches, max_matches);
+}